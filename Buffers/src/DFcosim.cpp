@@ -0,0 +1,349 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include "DFcosim.h"
+
+using namespace Dataflow;
+using namespace std;
+
+namespace {
+
+string trim(const string& s)
+{
+    size_t first = s.find_first_not_of(" \t\r\n");
+    if (first == string::npos) return "";
+    return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+string shellQuote(const string& s)
+{
+    string q = "'";
+    for (char ch: s) {
+        if (ch == '\'') q += "'\\''";
+        else q += ch;
+    }
+    return q + "'";
+}
+
+// Removes the comments of a C source (the strings are not considered)
+string stripComments(const string& src)
+{
+    string out;
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (src.compare(i, 2, "//") == 0) {
+            i = src.find('\n', i);
+            if (i == string::npos) break;
+            out += '\n';
+        } else if (src.compare(i, 2, "/*") == 0) {
+            i = src.find("*/", i + 2);
+            if (i == string::npos) break;
+            i++;
+            out += ' ';
+        } else out += src[i];
+    }
+    return out;
+}
+
+// Word of a test vector: hexadecimal or decimal integer, or float if it has a decimal point
+uint64_t parseWord(const string& word)
+{
+    if (word.find('.') == string::npos) return strtoull(word.c_str(), nullptr, 0);
+    float f = atof(word.c_str());
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+uint64_t widthMask(int width)
+{
+    return width <= 0 ? 0 : (width >= 64 ? ~0ULL : (1ULL << width) - 1);
+}
+
+int64_t toSigned(uint64_t v, int width)
+{
+    if (width <= 0 or width >= 64) return (int64_t) v;
+    uint64_t sign = 1ULL << (width - 1);
+    return (int64_t) (((v & widthMask(width)) ^ sign) - sign);
+}
+
+}
+
+DFcosim::DFcosim(const string& c_file, const string& kernel): cFile(c_file), kernel(kernel)
+{
+    ifstream f(c_file);
+    if (not f.is_open()) {
+        error.set("File " + c_file + " could not be opened.");
+        return;
+    }
+    stringstream ss;
+    ss << f.rdbuf();
+    string src = stripComments(ss.str());
+
+    // Definition of the kernel: <type> <kernel>(<args>) {
+    smatch m;
+    regex def_regex("([A-Za-z_][\\w\\s\\*]*?)\\s*\\b" + kernel + "\\s*\\(([^()]*)\\)\\s*\\{");
+    if (not regex_search(src, m, def_regex)) {
+        error.set("Function " + kernel + " not found in " + c_file + ".");
+        return;
+    }
+    retType = m[1].str();
+    retType = trim(retType.substr(retType.find_last_of('\n') + 1));
+
+    stringstream arg_list(m[2].str());
+    string arg;
+    regex arg_regex("(.*?)\\s*\\b([A-Za-z_]\\w*)\\s*((\\[[^\\]]*\\]\\s*)*)");
+    while (getline(arg_list, arg, ',')) {
+        arg = trim(arg);
+        if (arg.empty() or arg == "void") continue;
+        if (not regex_match(arg, m, arg_regex) or trim(m[1].str()).empty()) {
+            error.set("Argument \"" + arg + "\" of " + kernel + " is not supported.");
+            return;
+        }
+        Argument a;
+        a.type = trim(m[1].str());
+        a.name = m[2].str();
+        a.dims = trim(m[3].str());
+        if (a.type.back() == '*') {
+            a.pointer = true;
+            a.type = trim(a.type.substr(0, a.type.size() - 1));
+        }
+        if (a.dims == "[]") {
+            a.pointer = true;
+            a.dims = "";
+        }
+        args.push_back(a);
+    }
+}
+
+bool DFcosim::readVectors(const string& dir)
+{
+    transactions.clear();
+    if (args.empty()) {
+        transactions.resize(1);     // A single execution without inputs
+        return true;
+    }
+    bool found = false;
+    for (const Argument& a: args) {
+        string filename = dir + "/input_" + a.name + ".dat";
+        ifstream f(filename);
+        if (not f.is_open()) continue;
+        found = true;
+
+        string word;
+        int t = -1;
+        while (f >> word) {
+            if (word == "[[transaction]]") {
+                if (not (f >> t) or t < 0) {
+                    error.set("Wrong transaction in " + filename + ".");
+                    return false;
+                }
+                if (t >= transactions.size()) transactions.resize(t + 1);
+                transactions[t][a.name].clear();
+            } else if (word == "[[/transaction]]") {
+                t = -1;
+            } else if (word[0] != '[') {
+                if (t < 0) {
+                    error.set("Value outside a transaction in " + filename + ".");
+                    return false;
+                }
+                transactions[t][a.name].push_back(parseWord(word));
+            }
+        }
+    }
+    if (not found or transactions.empty()) {
+        error.set("No test vectors found in " + dir + ".");
+        return false;
+    }
+    return true;
+}
+
+bool DFcosim::buildDriver(const string& base)
+{
+    string source = base + ".cpp";
+    ofstream f(source);
+    if (not f.is_open()) {
+        error.set("File " + source + " could not be written.");
+        return false;
+    }
+
+    // The main of the C source (the testbench of hls_verifier) is renamed
+    char* path = realpath(cFile.c_str(), nullptr);
+    string c_path = path ? path : cFile;
+    free(path);
+    f << "// Driver of " << kernel << " for the co-simulation (buffers cosim)" << endl;
+    f << "#define main cosim_unused_main" << endl;
+    f << "#include \"" << c_path << "\"" << endl;
+    f << "#undef main" << endl;
+    f << R"(#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::map<std::string, std::vector<uint64_t>> cosim_in;
+
+template <typename T> void cosim_load(T* p, size_t n, const std::string& name)
+{
+    const std::vector<uint64_t>& w = cosim_in[name];
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = i < w.size() ? w[i] : 0;
+        std::memcpy(&p[i], &v, sizeof(T));
+    }
+}
+
+template <typename T> void cosim_store(std::ostream& os, const std::string& name, const T* p, size_t n)
+{
+    os << name << ' ' << 8 * sizeof(T);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = 0;
+        std::memcpy(&v, &p[i], sizeof(T));
+        os << ' ' << v;
+    }
+    os << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) return 2;
+    std::ifstream cosim_file(argv[1]);
+    std::string cosim_line, cosim_name;
+    while (std::getline(cosim_file, cosim_line)) {
+        std::istringstream iss(cosim_line);
+        uint64_t w;
+        if (not (iss >> cosim_name)) continue;
+        while (iss >> w) cosim_in[cosim_name].push_back(w);
+    }
+)";
+    // Arguments: arrays are flattened (row major), as the memories of the netlist
+    string call, store;
+    for (const Argument& a: args) {
+        string n = "\"" + a.name + "\"";
+        if (a.pointer) {
+            f << "    std::vector<" << a.type << "> " << a.name << "(std::max<size_t>(cosim_in[" << n
+              << "].size(), 1));" << endl;
+            f << "    cosim_load(" << a.name << ".data(), " << a.name << ".size(), " << n << ");" << endl;
+            call += (call.empty() ? "" : ", ") + a.name + ".data()";
+            store += "    cosim_store(cosim_out, " + n + ", " + a.name + ".data(), " + a.name + ".size());\n";
+        } else if (not a.dims.empty()) {
+            string flat = "(" + a.type + "*) " + a.name + ", sizeof(" + a.name + ") / sizeof(" + a.type + ")";
+            f << "    static " << a.type << ' ' << a.name << a.dims << ';' << endl;
+            f << "    cosim_load(" << flat << ", " << n << ");" << endl;
+            call += (call.empty() ? "" : ", ") + a.name;
+            store += "    cosim_store(cosim_out, " + n + ", " + flat + ");\n";
+        } else {
+            f << "    " << a.type << ' ' << a.name << ';' << endl;
+            f << "    cosim_load(&" << a.name << ", 1, " << n << ");" << endl;
+            call += (call.empty() ? "" : ", ") + a.name;
+        }
+    }
+    f << "    " << (hasReturnValue() ? "auto cosim_ret = " : "") << kernel << "(" << call << ");" << endl;
+    f << "    std::ofstream cosim_out(argv[2]);" << endl;
+    f << store;
+    if (hasReturnValue()) f << "    cosim_store(cosim_out, \"end\", &cosim_ret, 1);" << endl;
+    f << "    return cosim_out ? 0 : 1;" << endl;
+    f << "}" << endl;
+    f.close();
+    if (not f) {
+        error.set("File " + source + " could not be written.");
+        return false;
+    }
+
+    // No contraction of floating-point operations: the simulator rounds every operation
+    const char* cxx = getenv("CXX");
+    string build = string(cxx ? cxx : "g++") + " -O2 -w -ffp-contract=off -o " + shellQuote(base) + " " + shellQuote(source);
+    if (system(build.c_str())) {
+        error.set("Error when compiling " + source + ".");
+        return false;
+    }
+    driver = base;
+    return true;
+}
+
+bool DFcosim::runKernel(int t, Values& golden)
+{
+    string in_file = driver + "_in.txt", out_file = driver + "_out.txt";
+    ofstream in(in_file);
+    for (const auto& v: transactions[t]) {
+        in << v.first;
+        for (uint64_t w: v.second) in << ' ' << w;
+        in << endl;
+    }
+    in.close();
+    if (not in) {
+        error.set("File " + in_file + " could not be written.");
+        return false;
+    }
+
+    string run = (driver.find('/') == string::npos ? "./" : "") + shellQuote(driver) + " " +
+                 shellQuote(in_file) + " " + shellQuote(out_file);
+    if (system(run.c_str())) {
+        error.set("Error when executing " + driver + " (transaction " + to_string(t) + ").");
+        return false;
+    }
+
+    ifstream out(out_file);
+    golden = Values();
+    string line, name;
+    int bits;
+    while (getline(out, line)) {
+        istringstream iss(line);
+        if (not (iss >> name >> bits)) continue;
+        golden.bits[name] = bits;
+        vector<uint64_t>& words = golden.words[name];
+        uint64_t w;
+        while (iss >> w) words.push_back(w);
+    }
+    return true;
+}
+
+bool DFcosim::setInputs(DFsim& sim, int t)
+{
+    const map<string, vector<uint64_t>>& inputs = transactions[t];
+    for (const Argument& a: args) {
+        auto it = inputs.find(a.name);
+        static const vector<uint64_t> none;
+        const vector<uint64_t>& words = it == inputs.end() ? none : it->second;
+        if (a.isArray()) {
+            sim.setMemory(a.name, words);
+        } else if (not sim.setArgument(a.name, words.empty() ? 0 : words[0])) {
+            error.set("Argument " + a.name + " not found in the netlist.");
+            return false;
+        }
+    }
+    return true;
+}
+
+int DFcosim::compare(const DFsim& sim, const Values& golden, ostream& os, int max_diffs) const
+{
+    int diffs = 0;
+    for (const auto& g: golden.words) {
+        int bits = golden.bits.at(g.first);
+        uint64_t mask = widthMask(bits);
+        vector<uint64_t> words;
+        if (g.first == "end") {
+            if (sim.hasReturnValue()) words.push_back(sim.getReturnValue());
+        } else words = sim.getMemory(g.first);
+
+        int arg_diffs = 0;
+        for (size_t i = 0; i < g.second.size(); ++i) {
+            bool missing = i >= words.size();
+            if (not missing and ((words[i] ^ g.second[i]) & mask) == 0) continue;
+            if (arg_diffs++ < max_diffs) {
+                os << "  " << g.first;
+                if (g.first != "end") os << '[' << i << ']';
+                os << ": C " << toSigned(g.second[i], bits) << ", simulation ";
+                if (missing) os << "none";
+                else os << toSigned(words[i], bits);
+                os << endl;
+            }
+        }
+        if (arg_diffs > max_diffs) os << "  " << g.first << ": " << arg_diffs - max_diffs << " more" << endl;
+        diffs += arg_diffs;
+    }
+    return diffs;
+}
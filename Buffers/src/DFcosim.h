@@ -0,0 +1,120 @@
+#ifndef DFCOSIM_H
+#define DFCOSIM_H
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "DFsim.h"
+#include "ErrorManager.h"
+
+namespace Dataflow
+{
+
+/**
+ * @class DFcosim
+ * @brief Co-simulation of a dataflow netlist with the C kernel it was
+ * generated from, without an HDL simulator.
+ *
+ * The test vectors are the ones prepared for the hls_verifier flow:
+ *   <sim>/C_SRC/<kernel>.cpp                 C source of the kernel
+ *   <sim>/INPUT_VECTORS/input_<arg>.dat      values of each argument
+ * The .dat files have one block per transaction, with one word per line:
+ *   [[[runtime]]]
+ *   [[transaction]] 0
+ *   0x00000005
+ *   [[/transaction]]
+ *   [[[/runtime]]]
+ *
+ * The kernel is compiled natively with a generated driver that reads the
+ * arguments of a transaction and writes the final contents of the arrays
+ * and the return value (the golden outputs). The netlist is simulated with
+ * DFsim on the same inputs: the arrays are the memories with the same name
+ * and the scalars the arguments of the entry blocks. The contents of the
+ * arrays and the return value (named "end", as in hls_verifier) are compared.
+ */
+class DFcosim
+{
+public:
+    struct Argument {
+        std::string type;       // Type of the elements (e.g., in_int_t)
+        std::string name;
+        std::string dims;       // Dimensions of arrays (e.g., "[10][10]")
+        bool pointer = false;   // Array passed as a pointer (its size is the one of the vectors)
+        bool isArray() const { return pointer or not dims.empty(); }
+    };
+
+    // Values of the arguments (and "end"): words and width of the elements
+    struct Values {
+        std::map<std::string, std::vector<uint64_t>> words;
+        std::map<std::string, int> bits;
+    };
+
+    /**
+     * @brief Constructor. It reads the signature of the kernel from its C source.
+     * @param c_file C source of the kernel.
+     * @param kernel Name of the function.
+     */
+    DFcosim(const std::string& c_file, const std::string& kernel);
+
+    bool hasError() const { return error.exists(); }
+    const std::string& getError() const { return error.get(); }
+
+    const std::vector<Argument>& getArguments() const { return args; }
+    bool hasReturnValue() const { return retType != "void"; }
+
+    /**
+     * @brief Reads the test vectors (input_<arg>.dat) of all the arguments.
+     * Missing files are read as empty vectors (e.g., output arrays).
+     * @param dir Directory of the vectors (<sim>/INPUT_VECTORS).
+     * @return False if no vector could be read or a file has a wrong format.
+     */
+    bool readVectors(const std::string& dir);
+
+    int numTransactions() const { return transactions.size(); }
+
+    /**
+     * @brief Writes the driver of the kernel (<base>.cpp) and builds it
+     * (<base>) with $CXX (g++ by default).
+     * @return False if the driver could not be written or built.
+     */
+    bool buildDriver(const std::string& base);
+
+    /**
+     * @brief Runs the kernel natively with the inputs of a transaction.
+     * @param t The transaction.
+     * @param golden The final contents of the arrays and the return value.
+     * @return False if the driver failed.
+     */
+    bool runKernel(int t, Values& golden);
+
+    /**
+     * @brief Sets the arguments and the initial contents of the memories
+     * of a simulation with the inputs of a transaction.
+     * @return False if a scalar argument is not an entry of the netlist.
+     */
+    bool setInputs(DFsim& sim, int t);
+
+    /**
+     * @brief Compares the memories and the return value of a simulation with
+     * the golden outputs, masked to the width of the C types.
+     * @param os Stream for the mismatches.
+     * @param max_diffs Maximum number of mismatches written per argument.
+     * @return The number of mismatching words.
+     */
+    int compare(const DFsim& sim, const Values& golden, std::ostream& os, int max_diffs = 10) const;
+
+private:
+    std::string cFile;
+    std::string kernel;
+    std::string retType;
+    std::vector<Argument> args;
+    std::vector<std::map<std::string, std::vector<uint64_t>>> transactions;
+    std::string driver;     // Binary of the driver
+    ErrorMgr error;
+};
+
+}
+
+#endif // DFCOSIM_H
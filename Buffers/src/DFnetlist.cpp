@@ -74,6 +74,16 @@ void DFnetlist_Impl::setMilpSolver(const std::string& solver)
     milpSolver = solver;
 }
 
+void DFnetlist_Impl::setMilpCorpusDir(const std::string& dir)
+{
+    milpCorpusDir = dir;
+}
+
+void DFnetlist_Impl::setMilpRelaxation(bool relax)
+{
+    milpRelaxation = relax;
+}
+
 DFnetlist_Impl::DFnetlist_Impl()
 {
     init();
@@ -135,14 +145,16 @@ blockID DFnetlist_Impl::createBlock(BlockType type, const string& name)
     } else {
         idx = blocks.size();
         blocks.push_back(Block {});
+        blockInfo.push_back(BlockInfo {});
     }
     name2block[gname] = idx;
     allBlocks.insert(idx);
 
     // Init the block
     Block& B = blocks[idx];
+    BlockInfo& BI = blockInfo[idx];
     B.id = idx;
-    B.name = gname;
+    BI.name = gname;
     B.type = type;
     B.value = 0;
     B.boolValue = false;
@@ -158,11 +170,11 @@ blockID DFnetlist_Impl::createBlock(BlockType type, const string& name)
     B.freq = 0.0;
 
     // AYA: 05/08/2023
-    B.is_tagged = false;
+    BI.is_tagged = false;
 
     // AYA: 26/12/2023
-    B.taggers_num = 0;
-    B.tagger_id = -1;
+    BI.taggers_num = 0;
+    BI.tagger_id = -1;
 
     return idx;
 }
@@ -174,9 +186,10 @@ void DFnetlist_Impl::removeBlock(blockID id)
 
     while (not B.allPorts.empty()) removePort(*(B.allPorts.begin()));
 
-    name2block.erase(B.name);
+    name2block.erase(blockInfo[id].name);
 
     B = Block {invalidDataflowID};
+    blockInfo[id] = BlockInfo {};
     nBlocks--;
     B.nextFree = freeBlock;
     freeBlock = id;
@@ -193,7 +206,7 @@ blockID DFnetlist_Impl::getBlock(const string& name) const
 const string& DFnetlist_Impl::getBlockName(blockID id) const
 {
     assert (validBlock(id));
-    return blocks[id].name;
+    return blockInfo[id].name;
 }
 
 BlockType DFnetlist_Impl::getBlockType(blockID id) const
@@ -306,40 +319,40 @@ void DFnetlist_Impl::setBlockDelay(blockID id, double d)
 void DFnetlist_Impl::setBlockTagged(blockID id, bool is_tagged)
 {
     assert(validBlock(id));
-    blocks[id].is_tagged = is_tagged;
+    blockInfo[id].is_tagged = is_tagged;
 }
 
 // AYA: 26/12/2023
 void DFnetlist_Impl::setBlockTaggerId(blockID id, int tagger_id)
 {
     assert(validBlock(id));
-    blocks[id].tagger_id = tagger_id;
+    blockInfo[id].tagger_id = tagger_id;
 }
 
 // AYA: 26/12/2023
 void DFnetlist_Impl::setBlockTaggersNum(blockID id, int taggers_num)
 {
     assert(validBlock(id));
-    blocks[id].taggers_num = taggers_num;
+    blockInfo[id].taggers_num = taggers_num;
 }
 
 // AYA: 26/12/2023
 int DFnetlist_Impl::getBlockTaggerId(blockID id)
 {
-   return blocks[id].tagger_id;
+   return blockInfo[id].tagger_id;
 }
 
 // AYA: 26/12/2023
 int DFnetlist_Impl::getBlockTaggersNum(blockID id)
 {
     
-    return blocks[id].taggers_num;
+    return blockInfo[id].taggers_num;
 }
 
 // AYA: 05/08/2023
 bool DFnetlist_Impl::getBlockTagged(blockID id)
 {
-    return blocks[id].is_tagged;
+    return blockInfo[id].is_tagged;
 }
 
 double DFnetlist_Impl::getBlockRetimingDiff(blockID id) const
@@ -415,223 +428,223 @@ void DFnetlist_Impl::setValue(blockID id, long long value)
 void DFnetlist_Impl::setOperation(blockID id, std::string op)
 {
     assert(validBlock(id));
-    blocks[id].operation = op;
+    blockInfo[id].operation = op;
 }
 
 // Lana 02/07/19
 const string& DFnetlist_Impl::getOperation(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].operation;
+    return blockInfo[id].operation;
 }
 
 void DFnetlist_Impl::setFuncName(blockID id, std::string func)
 {
     assert(validBlock(id));
-    blocks[id].funcName = func;
+    blockInfo[id].funcName = func;
 }
 
 // Lana 02/07/19
 const string& DFnetlist_Impl::getFuncName(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].funcName;
+    return blockInfo[id].funcName;
 }
 
 // Lana 03.07.19 
 void DFnetlist_Impl::setMemPortID(blockID id, int memPortID)
 {
     assert(validBlock(id));
-    blocks[id].memPortID = memPortID;
+    blockInfo[id].memPortID = memPortID;
 
 }
 
 int DFnetlist_Impl::getMemPortID(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].memPortID;
+    return blockInfo[id].memPortID;
 }
 
 void DFnetlist_Impl::setMemOffset(blockID id, int memOffset)
 {
     assert(validBlock(id));
-    blocks[id].memOffset = memOffset;
+    blockInfo[id].memOffset = memOffset;
 
 }
 
 int DFnetlist_Impl::getMemOffset(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].memOffset;
+    return blockInfo[id].memOffset;
 }
 
 void DFnetlist_Impl::setMemBBCount(blockID id, int count)
 {
     assert(validBlock(id));
-    blocks[id].memBBCount = count;
+    blockInfo[id].memBBCount = count;
 
 }
 
 int DFnetlist_Impl::getMemBBCount(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].memBBCount;
+    return blockInfo[id].memBBCount;
 }
 
 void DFnetlist_Impl::setMemLdCount(blockID id, int count)
 {
     assert(validBlock(id));
-    blocks[id].memLdCount = count;
+    blockInfo[id].memLdCount = count;
 
 }
 
 int DFnetlist_Impl::getMemLdCount(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].memLdCount;
+    return blockInfo[id].memLdCount;
 }
 
 void DFnetlist_Impl::setMemStCount(blockID id, int count)
 {
     assert(validBlock(id));
-    blocks[id].memStCount = count;
+    blockInfo[id].memStCount = count;
 
 }
 
 int DFnetlist_Impl::getMemStCount(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].memStCount;
+    return blockInfo[id].memStCount;
 }
 
 void DFnetlist_Impl::setMemName(blockID id, std::string name)
 {
     assert(validBlock(id));
-    blocks[id].memName = name;
+    blockInfo[id].memName = name;
 }
 
 const string& DFnetlist_Impl::getMemName(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].memName;
+    return blockInfo[id].memName;
 }
 
 void DFnetlist_Impl::setMemPortSuffix(portID port, std::string op)
 {
     assert(validPort(port));
-    ports[port].memPortSuffix = op;
+    portInfo[port].memPortSuffix = op;
 
 }
 
 const string& DFnetlist_Impl::getMemPortSuffix(portID port) const
 {
     assert(validPort(port));
-    return ports[port].memPortSuffix;
+    return portInfo[port].memPortSuffix;
 }
 
 // Lana 04/10/19 LSQ params
 void DFnetlist_Impl::setLSQDepth(blockID id, int depth)
 {
     assert(validBlock(id));
-    blocks[id].fifoDepth = depth;
+    blockInfo[id].fifoDepth = depth;
 
 }
 
 int DFnetlist_Impl::getLSQDepth(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].fifoDepth;
+    return blockInfo[id].fifoDepth;
 }
 
 void DFnetlist_Impl::setNumLoads(blockID id, std::string s)
 {
     assert(validPort(id));
-    blocks[id].numLoads = s;
+    blockInfo[id].numLoads = s;
 
 }
 
 const string& DFnetlist_Impl::getNumLoads(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].numLoads;
+    return blockInfo[id].numLoads;
 }
 
 void DFnetlist_Impl::setNumStores(blockID id, std::string s)
 {
     assert(validPort(id));
-    blocks[id].numStores = s;
+    blockInfo[id].numStores = s;
 
 }
 
 const string& DFnetlist_Impl::getNumStores(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].numStores;
+    return blockInfo[id].numStores;
 }
 
 void DFnetlist_Impl::setLoadOffsets(blockID id, std::string s)
 {
     assert(validPort(id));
-    blocks[id].loadOffsets = s;
+    blockInfo[id].loadOffsets = s;
 
 }
 
 const string& DFnetlist_Impl::getLoadOffsets(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].loadOffsets;
+    return blockInfo[id].loadOffsets;
 }
 
 void DFnetlist_Impl::setStoreOffsets(blockID id, std::string s)
 {
     assert(validPort(id));
-    blocks[id].storeOffsets = s;
+    blockInfo[id].storeOffsets = s;
 
 }
 
 const string& DFnetlist_Impl::getStoreOffsets(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].storeOffsets;
+    return blockInfo[id].storeOffsets;
 }
 
 void DFnetlist_Impl::setLoadPorts(blockID id, std::string s)
 {
     assert(validPort(id));
-    blocks[id].loadPorts = s;
+    blockInfo[id].loadPorts = s;
 
 }
 
 const string& DFnetlist_Impl::getLoadPorts(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].loadPorts;
+    return blockInfo[id].loadPorts;
 }
 
 void DFnetlist_Impl::setStorePorts(blockID id, std::string s)
 {
     assert(validPort(id));
-    blocks[id].storePorts = s;
+    blockInfo[id].storePorts = s;
 
 }
 
 const string& DFnetlist_Impl::getStorePorts(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].storePorts;
+    return blockInfo[id].storePorts;
 }
 
 // Getelementptr array dimensions
 void DFnetlist_Impl::setGetPtrConst(blockID id, int c)
 {
     assert(validBlock(id));
-    blocks[id].getptrc = c;
+    blockInfo[id].getptrc = c;
 
 }
 
 void DFnetlist_Impl::setOrderings(blockID id, map<bbID, vector<int>> value){
     assert (validBlock(id));
-    blocks[id].orderings = value;
+    blockInfo[id].orderings = value;
 }
 
 //---------------------------
@@ -682,7 +695,7 @@ blockID DFnetlist_Impl::getBlockFromPort(portID p) const
 int DFnetlist_Impl::getGetPtrConst(blockID id) const
 {
     assert(validBlock(id));
-    return blocks[id].getptrc;
+    return blockInfo[id].getptrc;
 }
 
 // Generates a fresh port name for a given block name. isInput indicates whether the port
@@ -715,6 +728,7 @@ portID DFnetlist_Impl::createPort(blockID block, bool isInput, const string& nam
     if (freePort == invalidDataflowID) {
         pid = ports.size();
         ports.push_back(Port {});
+        portInfo.push_back(PortInfo {});
     } else {
         pid = freePort;
         freePort = ports[pid].nextFree;
@@ -736,18 +750,19 @@ portID DFnetlist_Impl::createPort(blockID block, bool isInput, const string& nam
     // are paired in order of declaration. The remaining input port is the
     // data port
     if (B.type == DEMUX) {
-        if (isInput) B.listPorts.push_back(pid);
+        BlockInfo& BI = blockInfo[block];
+        if (isInput) BI.listPorts.push_back(pid);
         else {
-            assert(not B.listPorts.empty());
-            portID inp = B.listPorts.front();
-            B.listPorts.pop_front();
-            B.demuxPairs.emplace(pid, inp);
-            B.demuxPairs.emplace(inp, pid);
+            assert(not BI.listPorts.empty());
+            portID inp = BI.listPorts.front();
+            BI.listPorts.pop_front();
+            BI.demuxPairs.emplace(pid, inp);
+            BI.demuxPairs.emplace(inp, pid);
 
             // The last input port is data
-            if (B.listPorts.size() == 1) {
-                B.data = B.listPorts.front();
-                B.listPorts.pop_front();
+            if (BI.listPorts.size() == 1) {
+                B.data = BI.listPorts.front();
+                BI.listPorts.pop_front();
             }
         }
     }
@@ -756,8 +771,8 @@ portID DFnetlist_Impl::createPort(blockID block, bool isInput, const string& nam
     Port& P = ports[pid];
     P.id = pid;
     P.block = block;
-    P.short_name = localname;
-    P.full_name = fullname;
+    portInfo[pid].short_name = localname;
+    portInfo[pid].full_name = fullname;
     P.isInput = isInput;
     P.width = width;
     P.delay = 0;
@@ -781,6 +796,7 @@ void DFnetlist_Impl::removePort(portID p)
     if (validChannel(P.channel)) removeChannel(P.channel);
     name2port.erase(getPortName(p));
     P = Port {};
+    portInfo[p] = PortInfo {};
     P.nextFree = freePort;
     freePort = p;
     allPorts.erase(p);
@@ -798,7 +814,7 @@ portID DFnetlist_Impl::getPort(blockID block, const string& name) const
 const string& DFnetlist_Impl::getPortName(portID port, bool full) const
 {
     assert(validPort(port));
-    return full ? ports[port].full_name : ports[port].short_name;
+    return full ? portInfo[port].full_name : portInfo[port].short_name;
 }
 
 PortType DFnetlist_Impl::getPortType(portID port) const
@@ -877,7 +893,7 @@ const setPorts& DFnetlist_Impl::getPorts(blockID id, PortDirection dir) const
 const setPorts& DFnetlist_Impl::getDefinitions(portID p) const
 {
     assert(validPort(p));
-    return ports[p].defs;
+    return portInfo[p].defs;
 }
 
 portID DFnetlist_Impl::getConditionalPort(blockID id) const
@@ -909,9 +925,9 @@ portID DFnetlist_Impl::getDataPort(blockID id) const
 portID DFnetlist_Impl::getDemuxComplementaryPort(portID port) const
 {
     assert(validPort(port));
-    const Block& B = blocks[ports[port].block];
-    const auto& it = B.demuxPairs.find(port);
-    if (it != B.demuxPairs.end()) return it->second;
+    const BlockInfo& BI = blockInfo[ports[port].block];
+    const auto& it = BI.demuxPairs.find(port);
+    if (it != BI.demuxPairs.end()) return it->second;
     return invalidDataflowID;
 }
 
@@ -1119,6 +1119,25 @@ public:
      */
     bool writeDot(std::ostream& of);
 
+    /**
+     * @brief Writes the VHDL of the dataflow netlist with dot2vhdl (libdot2vhdl),
+     * giving it the netlist in memory instead of a dot file.
+     * @param filename The name of the dot file the netlist would be written to,
+     * without the extension (<filename>.vhd is written).
+     * @return true if successful, and false otherwise.
+     */
+    bool writeVhdl(const std::string& filename);
+
+    /**
+     * @brief Overrides the colors used by writeDot for some blocks (fill color)
+     * and channels, e.g., to annotate the netlist with the results of a simulation.
+     * Empty maps restore the default colors.
+     * @param block_colors Colors of the blocks.
+     * @param channel_colors Colors of the channels.
+     */
+    void setDotColors(const std::map<blockID,std::string>& block_colors,
+                      const std::map<channelID,std::string>& channel_colors);
+
     bool writeDotMG(const std::string& filename = "");
     bool writeDotMG(std::ostream& s);
 
@@ -1189,6 +1208,38 @@ public:
      */
     void setMilpSolver(const std::string& solver="cbc");
 
+    /**
+     * @brief Sets a directory to persist the MILP models solved during optimization.
+     * @param dir Name of the directory (no models are persisted if empty).
+     */
+    void setMilpCorpusDir(const std::string& dir);
+
+    /**
+     * @brief Solves the LP relaxation of the buffer placement MILPs of the MGs
+     * (addElasticBuffersBB_sc) and rounds the solution, instead of solving the MILPs.
+     * @param relax True to use the relaxation.
+     */
+    void setMilpRelaxation(bool relax = true);
+
+    /**
+     * @brief Enables checkpointing of the buffer placement (addElasticBuffersBB_sc).
+     * The extracted CFDFCs and the buffers of every solved MG are written into
+     * the checkpoint file after each step.
+     * @param filename Name of the checkpoint file (no checkpointing if empty).
+     * @param resume If asserted, the contents of the file are reused and the
+     * completed steps are not recomputed.
+     */
+    void setBufferCheckpoint(const std::string& filename, bool resume = false);
+
+    /**
+     * @brief Writes the throughput of every CFDFC claimed by the last buffer placement
+     * (th_MG of the MILP), to be validated with a simulation (buffers verify). Each line is
+     *   cfdfc <index> <throughput> <freq> <#BBs> <BB>... <#arcs> <srcBB> <dstBB> ...
+     * @param filename Name of the file.
+     * @return True if successful, and false otherwise.
+     */
+    bool writeThroughputs(const std::string& filename);
+
     /**
      * @brief Removes all non-SCC blocks and channels.
      * @return The netlist with only the SCCs.
@@ -1250,36 +1301,46 @@ public:
 
 private:
 
+    /*
+     * Blocks and ports are split into a hot core and cold side tables.
+     * The core (Block, Port) contains the numeric fields and the adjacency
+     * used by the timing, throughput and traversal algorithms. The names,
+     * memory and tagging information and other rarely used fields are stored
+     * in BlockInfo and PortInfo, in vectors indexed by the same ids.
+     */
     struct Block {
         blockID id;                 // Id of the block (redundant, but useful)
-        std::string name;           // Name of the block
         BlockType type;             // Type of block
-        longValueType value;        // Value (only used for constants)
-        bool boolValue;             // Boolean value (only used for constants)
-        blockID nextFree;           // Next free block in the vector of blocks
-        bbID basicBlock;            // Basic block to which the block belongs to
-        double delay;               // Delay of the block
         int latency;                // Latency of the block (only for Operators)
         int II;                     // Initiation interval of the block (only for Operators)
-        int slots;                  // Number of slots (only for EBs)
+        double delay;               // Delay of the block
+        bbID basicBlock;            // Basic block to which the block belongs to
+        blockID nextFree;           // Next free block in the vector of blocks
+        bool mark;                  // Flag used for traversals
         bool transparent;           // Is the buffer transparent? (only for EBs)
-        setPorts inPorts;           // Set of input ports (id's)
-        setPorts outPorts;          // Set of output ports (id's)
-        setPorts allPorts;          // All ports of the block
+        bool boolValue;             // Boolean value (only used for constants)
+        int slots;                  // Number of slots (only for EBs)
+        int scc_number;             // SCC number
+        int DFSorder;               // Post-visit number during DFS traversal
         portID portCond;            // Port for condition (for branch/select)
         portID portTrue, portFalse; // True and false ports (for branch/select)
         portID data;                // Port for data (input for branch/demux, output for select)
         portID srcCond;             // Port that generates the condition for the branch (beyond forks)
+        blockID bbParent;           // Disjoint set parent for BB calculation
+        int bbRank;                 // Disjoint set rank for BB calculation
         double freq;                // Execution frequency (obtained from profiling)
         double frac;                // True/false fraction of select inputs (obtained from profiling)
         double retimingDiff;        // Axel
-        bool mark;                  // Flag used for traversals
-        int scc_number;             // SCC number
-        int DFSorder;               // Post-visit number during DFS traversal
+        longValueType value;        // Value (only used for constants)
+        setPorts inPorts;           // Set of input ports (id's)
+        setPorts outPorts;          // Set of output ports (id's)
+        setPorts allPorts;          // All ports of the block
+    };
+
+    struct BlockInfo {
+        std::string name;           // Name of the block
         std::deque<portID> listPorts;       // Temporary list of input ports (for demux pairing)
         std::map<portID,portID> demuxPairs; // Pairs of ports in a demux. The pairs are in both directions.
-        blockID bbParent;           // Disjoint set parent for BB calculation
-        int bbRank;                 // Disjoint set rank for BB calculation
         std::string operation;      // Lana: arithmetic/memory operation (instruction)
         int memPortID;              // Lana: used to connect load/store to MC/LSQ
         int memOffset;              // Lana: used to connect load/store to MC/LSQ
@@ -1307,15 +1368,18 @@ private:
 
     struct Port {
         portID id;              // Identifier of the port
-        std::string short_name; // Name of the port
-        std::string full_name;  // Full name of the port (block:port)
         blockID block;          // Owner of the port
-        portID nextFree;        // Next free slot in the vector of ports
+        channelID channel;      // Channel connected to the port
         bool isInput;           // Direction of the port
+        PortType type;          // Type: generic, selection, sel_true or sel_false
         int width;              // Width of the port (0: control, 1: boolean, >1: data)
         double delay;           // Delay associated to the port
-        PortType type;          // Type: generic, selection, sel_true or sel_false
-        channelID channel;      // Channel connected to the port
+        portID nextFree;        // Next free slot in the vector of ports
+    };
+
+    struct PortInfo {
+        std::string short_name; // Name of the port
+        std::string full_name;  // Full name of the port (block:port)
         setPorts defs;          // Set of definitions (ports) reaching this port
         std::string memPortSuffix;  // Lana: MC/LSQ port suffix, to distinguish port types of MC/LSQ
     };
@@ -1552,8 +1616,10 @@ private:
     int nPorts;             // Number of ports
     funcID nextFree;        // Next free slot in a library of functions
 
-    std::vector<Block> blocks;       // List of blocks
-    std::vector<Port> ports;         // List of ports
+    std::vector<Block> blocks;       // List of blocks (hot fields)
+    std::vector<BlockInfo> blockInfo; // Cold fields of the blocks (same indices as blocks)
+    std::vector<Port> ports;         // List of ports (hot fields)
+    std::vector<PortInfo> portInfo;  // Cold fields of the ports (same indices as ports)
     std::vector<Channel> channels;   // List of channels
 
     double total_freq;
@@ -1575,6 +1641,11 @@ private:
     bbID entryBB;               // Entry basic block
 
     std::string milpSolver;     // Name of the MILP solver
+    std::string milpCorpusDir;  // Directory to persist the MILP models (none if empty)
+    bool milpRelaxation = false; // Solve the LP relaxation of the buffer placement
+
+    std::map<blockID,std::string> dotBlockColor;     // Colors of writeDot that override the default ones
+    std::map<channelID,std::string> dotChannelColor;
 
     std::map<std::string,blockID> name2block; // Map to obtain blocks from names
     std::map<std::string,portID> name2port;   // Map to obtain ports from names (string = "block:port")
@@ -1605,6 +1676,7 @@ private:
 
     std::vector<subNetlistBB> CFDFC;
     std::vector<double> CFDFCfreq;
+    std::map<int, double> CFDFCthroughput; // Throughput of each CFDFC claimed by the buffer placement
 
     // SHAB_note: should be change this to a map?
     std::vector<subNetlistBB> CFDFC_disjoint;
@@ -1612,6 +1684,34 @@ private:
 
     std::vector<vector<int> > components;  // each index corresponds to the CFDFCs the DSU_CFDFC is built of
 
+    // Checkpoint of addElasticBuffersBB_sc. Channels and blocks are identified
+    // by name to be independent from the internal ids.
+    struct bufferCheckpoint {
+        struct bufferDecision {
+            std::string block;      // Source block of the channel
+            std::string port;       // Source port of the channel
+            int slots;
+            bool transparent;
+        };
+        struct mgDecisions {
+            std::vector<bufferDecision> buffers;
+            std::vector<std::pair<std::string, double>> retiming;   // Block, retiming diff
+            std::vector<std::pair<int, double>> throughput;         // CFDFC, throughput
+        };
+
+        std::string filename;       // Checkpoint file (no checkpointing if empty)
+        bool resume = false;        // Reuse the contents of the file
+        bool active = false;        // Checkpointing enabled for the current run
+        double period = 0;
+        double delay = 0;
+        std::vector<subNetlistBB> cfdfcs;   // CFDFCs read from the file
+        std::vector<double> cfdfcsFreq;     // Frequencies of the CFDFCs, checked against the profile
+        bool cfdfcsDone = false;            // All the CFDFCs have been extracted
+        std::map<int, mgDecisions> mgs;     // Completed MGs (index in MG_disjoint)
+    };
+
+    bufferCheckpoint ckpt;
+
     // Structure to store the MILP variables
     // Note: the out_retime variables are only used for pipelined units (latency > 0)
     struct milpVarsEB {
@@ -1989,6 +2089,20 @@ private:
         return milpSolver;
     }
 
+    /**
+     * @return The directory where the MILP models are persisted (empty if none).
+     */
+    const std::string& getMilpCorpusDir() const {
+        return milpCorpusDir;
+    }
+
+    /**
+     * @return True if the buffer placement solves the LP relaxation of the MILPs.
+     */
+    bool getMilpRelaxation() const {
+        return milpRelaxation;
+    }
+
     /**
      * @brief Creates the variables of an MILP model for the insertion of buffers.
      * @param milp MILP model.
@@ -2065,6 +2179,100 @@ private:
 
     void writeRetimingDiffs(const Milp_Model& milp, const milpVarsEB& vars);
 
+    /**
+     * @brief Sets the buffer of a channel of an MG as decided by the buffer placement.
+     * Transparent buffers receive extra slots.
+     * @param c The channel.
+     * @param slots Number of slots decided by the optimization.
+     * @param transparent Whether the buffer is transparent.
+     */
+    void setMGBuffer(channelID c, int slots, bool transparent);
+
+    /**
+     * @brief Places and sizes the buffers of an MG without solving an MILP, when
+     * the MG is a single simple cycle, possibly with acyclic parts attached to it.
+     * @param mg The index of the MG (in MG_disjoint).
+     * @param Period Target period.
+     * @param BufferDelay Delay of the buffers.
+     * @return True if the MG was handled, and false if the MILP must be used.
+     */
+    bool sizeSingleCycleMG(int mg, double Period, double BufferDelay);
+
+    /**
+     * @brief Rounds the solution of the LP relaxation of the buffer placement
+     * of an MG and repairs it (elasticity, timing and throughput).
+     * @param milp The solved MILP model (relaxation).
+     * @param vars The variables of the MILP model.
+     * @param mg The index of the MG (in MG_disjoint).
+     * @param Period Target period.
+     * @param BufferDelay Delay of the buffers.
+     * @param MaxThroughput Whether the throughput is optimized.
+     * @param first_MG Whether only the first MG of the component is considered.
+     * @param lp_th Sum of the throughputs of the LP relaxation (updated).
+     * @param achieved_th Sum of the throughputs after the repair (updated).
+     * @return True if successful, and false if the period cannot be met.
+     */
+    bool roundRelaxedMG(const Milp_Model& milp, const milpVarsEB& vars, int mg, double Period, double BufferDelay,
+                        bool MaxThroughput, bool first_MG, double& lp_th, double& achieved_th);
+
+    /**
+     * @brief Greedily cuts the input channels of a block to meet the period.
+     * The output arrival times of the block are calculated from the arrival
+     * times at its input ports. If some output exceeds the period, the input
+     * channels are cut in order: first the channels not coming from cycle_in
+     * (by decreasing arrival time) and then the one from cycle_in.
+     * @param b The block.
+     * @param inside Channels considered for the timing (the other inputs are ignored).
+     * @param cycle_in Input port cut last (invalid if none).
+     * @param cuttable_cycle Whether the channel of cycle_in can hold a flop.
+     * @param Period Target period (INFINITY if not defined).
+     * @param BufferDelay Delay of the buffers.
+     * @param arrival Arrival time of every port (updated).
+     * @param flops Channels with flops (updated).
+     * @return True if successful, and false if the period cannot be met.
+     */
+    bool cutBlockInputs(blockID b, const setChannels& inside, portID cycle_in, bool cuttable_cycle,
+                        double Period, double BufferDelay, std::vector<double>& arrival, setChannels& flops) const;
+
+    /**
+     * @brief Propagates the arrival time of a channel from its source to its destination.
+     */
+    void propagateArrival(channelID c, double BufferDelay, std::vector<double>& arrival, const setChannels& flops) const;
+
+    /**
+     * @brief Starts checkpointing for a buffer placement run. The contents read from
+     * the checkpoint file are discarded if they were produced with other parameters.
+     * @param Period The clock period of the run.
+     * @param BufferDelay The buffer delay of the run.
+     */
+    void startBufferCheckpoint(double Period, double BufferDelay);
+
+    /**
+     * @brief Writes the checkpoint file (CFDFCs extracted and completed MGs).
+     * @return True if successful, and false otherwise.
+     * @note The file is written atomically (temporary file + rename).
+     */
+    bool writeBufferCheckpoint();
+
+    /**
+     * @brief Reads the checkpoint file.
+     * @return True if successful, and false otherwise.
+     */
+    bool readBufferCheckpoint();
+
+    /**
+     * @brief Stores the buffers and retiming of a solved MG in the checkpoint.
+     * @param mg The index of the MG (in MG_disjoint).
+     */
+    void checkpointMG(int mg);
+
+    /**
+     * @brief Applies the buffers and retiming of a completed MG from the checkpoint.
+     * @param mg The index of the MG (in MG_disjoint).
+     * @return True if the MG was found in the checkpoint, and false otherwise.
+     */
+    bool restoreMGfromCheckpoint(int mg);
+
     /**
      * @brief Makes some buffers non-transparent to cut combinational cycles.
      * @note This function should be rarely invoked. It is only necessary when
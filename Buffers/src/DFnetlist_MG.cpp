@@ -1,4 +1,6 @@
 #include <cassert>
+#include <cmath>
+#include <iostream>
 #include "DFnetlist.h"
 
 using namespace Dataflow;
@@ -28,6 +30,7 @@ double DFnetlist_Impl::extractMarkedGraphsBB(double coverage) {
 
     CFDFC.clear();
     CFDFCfreq.clear();
+    CFDFCthroughput.clear();
     MG.clear();
     MGfreq.clear();
 
@@ -40,7 +43,16 @@ double DFnetlist_Impl::extractMarkedGraphsBB(double coverage) {
         cout << "Iteration " << iter << endl;
 
 		// Aya: this step seems to be correct
-        subNetlistBB extracted_CFDFC = extractMarkedGraphBB(freq);
+        subNetlistBB extracted_CFDFC;
+        bool restored = ckpt.active and iter <= ckpt.cfdfcs.size();
+        if (restored) {
+            cout << "Restoring CFDFC from checkpoint..." << endl;
+            extracted_CFDFC = ckpt.cfdfcs[iter - 1];
+        } else if (ckpt.active and ckpt.cfdfcsDone) {
+            // The extraction had already finished in the checkpointed run
+            cout << "No new MG can be extracted to increase coverage." << endl;
+            break;
+        } else extracted_CFDFC = extractMarkedGraphBB(freq);
 
         if (extracted_CFDFC.empty()){
             cout << "No new MG can be extracted to increase coverage." << endl;
@@ -53,6 +65,17 @@ double DFnetlist_Impl::extractMarkedGraphsBB(double coverage) {
         for (auto arc: extracted_CFDFC.getBasicBlockArcs()) {
             min_freq = min(min_freq, freq[arc]);
         }
+        // The checkpoint is only valid for the profile it was produced with
+        if (restored and fabs(min_freq - ckpt.cfdfcsFreq[iter - 1]) > 1e-9 * max(1.0, min_freq)) {
+            cerr << "Warning: CFDFC " << iter - 1 << " of checkpoint " << ckpt.filename << " has frequency "
+                 << ckpt.cfdfcsFreq[iter - 1] << " instead of " << min_freq
+                 << ". Extracting the CFDFCs and solving the MGs again." << endl;
+            ckpt.cfdfcs.resize(iter - 1);
+            ckpt.cfdfcsFreq.resize(iter - 1);
+            ckpt.cfdfcsDone = false;
+            ckpt.mgs.clear();
+            continue;
+        }
         // update the frequencies of this CFDFC
         for (auto arc: extracted_CFDFC.getBasicBlockArcs())
             freq[arc] -= min_freq;
@@ -69,8 +92,13 @@ double DFnetlist_Impl::extractMarkedGraphsBB(double coverage) {
 
         covered_freq += extracted_CFDFC.numBasicBlockArcs() * min_freq;
         iter++;
+
+        writeBufferCheckpoint();
     }
 
+    ckpt.cfdfcsDone = true;
+    writeBufferCheckpoint();
+
     cout << endl;
     cout << "*******************" << endl;
     cout << "Covered Frequency = " << covered_freq;
@@ -236,6 +264,8 @@ DFnetlist_Impl::subNetlistBB DFnetlist_Impl::extractMarkedGraphBB(const map<bbID
     long long start_time, end_time;
     uint32_t elapsed_time;
 
+    milp.setCorpusDir(getMilpCorpusDir());
+    milp.setCorpusTag(net_name, "extractMarkedGraphBB");
     start_time = get_timestamp1();
 
     milp.solve();
@@ -561,6 +591,8 @@ DFnetlist_Impl::subNetlist DFnetlist_Impl::extractMarkedGraph(const map<blockID,
     long long start_time, end_time;
     uint32_t elapsed_time;
 
+    milp.setCorpusDir(getMilpCorpusDir());
+    milp.setCorpusTag(net_name, "extractMarkedGraph");
     start_time = get_timestamp1();
 
     milp.solve();
@@ -21,10 +21,10 @@ void DFnetlist_Impl::calculateDefinitions()
     // Initialization of defs: all sets empty, except those
     // that define some data (op, eb, entry, constant)
     ForAllBlocks(b) {
-        ForAllPorts(b, p) ports[p].defs.clear();
+        ForAllPorts(b, p) portInfo[p].defs.clear();
         BlockType type = getBlockType(b);
         if (type == OPERATOR or type == ELASTIC_BUFFER or type == FUNC_ENTRY or type == CONSTANT) {
-            ForAllOutputPorts(b, p) ports[p].defs = {p};
+            ForAllOutputPorts(b, p) portInfo[p].defs = {p};
         }
     }
 
@@ -36,8 +36,8 @@ void DFnetlist_Impl::calculateDefinitions()
         ForAllChannels(c) {
             portID src = getSrcPort(c);
             portID dst = getDstPort(c);
-            if (ports[src].defs.size() != ports[dst].defs.size()) {
-                ports[dst].defs = ports[src].defs;
+            if (portInfo[src].defs.size() != portInfo[dst].defs.size()) {
+                portInfo[dst].defs = portInfo[src].defs;
             }
         }
 
@@ -57,17 +57,17 @@ void DFnetlist_Impl::calculateDefinitions()
             case FORK:
                 inp = getInPort(b);
                 outp = getOutPort(b);
-                if (ports[inp].defs.size() != ports[outp].defs.size()) {
+                if (portInfo[inp].defs.size() != portInfo[outp].defs.size()) {
                     changes = true;
-                    ForAllOutputPorts(b, p) ports[p].defs = ports[inp].defs;
+                    ForAllOutputPorts(b, p) portInfo[p].defs = portInfo[inp].defs;
                 }
                 break;
             case MERGE:
-                ForAllInputPorts(b, p) newDefs = setOp::setUnion(newDefs, ports[p].defs);
+                ForAllInputPorts(b, p) newDefs = setOp::setUnion(newDefs, portInfo[p].defs);
                 outp = getOutPort(b);
-                if (newDefs.size() != ports[outp].defs.size()) {
+                if (newDefs.size() != portInfo[outp].defs.size()) {
                     changes = true;
-                    ports[outp].defs = newDefs;
+                    portInfo[outp].defs = newDefs;
                 }
                 break;
             case BRANCH:
@@ -75,28 +75,28 @@ void DFnetlist_Impl::calculateDefinitions()
                 truep = getTruePort(b);
                 falsep = getFalsePort(b);
                 if (not validPort(truep)) swap(truep, falsep);
-                if (ports[truep].defs.size() != ports[inp].defs.size()) {
+                if (portInfo[truep].defs.size() != portInfo[inp].defs.size()) {
                     changes = true;
-                    ports[truep].defs = ports[inp].defs;
-                    if (validPort(falsep)) ports[falsep].defs = ports[inp].defs;
+                    portInfo[truep].defs = portInfo[inp].defs;
+                    if (validPort(falsep)) portInfo[falsep].defs = portInfo[inp].defs;
                 }
                 break;
             case DEMUX:
                 inp = getDataPort(b);
                 outp = getOutPort(b);
-                if (ports[inp].defs.size() != ports[outp].defs.size()) {
+                if (portInfo[inp].defs.size() != portInfo[outp].defs.size()) {
                     changes = true;
-                    ForAllOutputPorts(b, p) ports[p].defs = ports[inp].defs;
+                    ForAllOutputPorts(b, p) portInfo[p].defs = portInfo[inp].defs;
                 }
                 break;
             case SELECT:
                 truep = getTruePort(b);
                 falsep = getFalsePort(b);
-                newDefs = setOp::setUnion(ports[truep].defs, ports[falsep].defs);
+                newDefs = setOp::setUnion(portInfo[truep].defs, portInfo[falsep].defs);
                 outp = getOutPort(b);
-                if (newDefs.size() != ports[outp].defs.size()) {
+                if (newDefs.size() != portInfo[outp].defs.size()) {
                     changes = true;
-                    ports[outp].defs = newDefs;
+                    portInfo[outp].defs = newDefs;
                 }
                 break;
             default:
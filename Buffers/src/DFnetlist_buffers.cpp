@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "DFnetlist.h"
 
 using namespace Dataflow;
@@ -115,6 +116,29 @@ bool multithread = is_tag_from_input();
 
 int N_tags = number_of_tags_from_input();
 
+// Number of tags used by dot2vhdl (gian_N.txt), written after the buffers of each MG
+static void writeTagsNumber()
+{
+    int N = 0;
+    if(multithread)
+    {
+       N = N_tags;  
+        if(N <= 0)
+            N = 1;
+    }
+    else
+    {
+        N = 1;
+    }
+
+    ofstream myfile;
+    myfile.open ("/home/dynamatic/Dynamatic/etc/dynamatic/dot2vhdl/src/gian_N.txt");
+    if(!myfile)
+        cout << "Problem opening file\n";
+    myfile << to_string(N);
+    myfile.close();
+}
+
 
 void DFnetlist_Impl::createMilpVarsEB(Milp_Model& milp, milpVarsEB& vars, bool max_throughput, bool first_MG)
 {
@@ -375,6 +399,8 @@ bool DFnetlist_Impl::addElasticBuffers(double Period, double BufferDelay, bool M
     long long start_time, end_time;
     uint32_t elapsed_time;
 
+    milp.setCorpusDir(getMilpCorpusDir());
+    milp.setCorpusTag(net_name, "addElasticBuffers", -1, Period);
     start_time = get_timestamp();
     milp.solve();
     end_time = get_timestamp();
@@ -478,6 +504,8 @@ bool DFnetlist_Impl::addElasticBuffersBB(double Period, double BufferDelay, bool
     cout << "Solving MILP for elastic buffers" << endl;
     long long start_time, end_time;
     uint32_t elapsed_time;
+    milp.setCorpusDir(getMilpCorpusDir());
+    milp.setCorpusTag(net_name, "addElasticBuffersBB", -1, Period);
     start_time = get_timestamp();
     if (timeout > 0) milp.solve(timeout);
     else milp.solve();
@@ -498,6 +526,7 @@ bool DFnetlist_Impl::addElasticBuffersBB(double Period, double BufferDelay, bool
             cout << "*** Throughput for MG " << i << ": ";
             cout << fixed << setprecision(2) << milp[milpVars.th_MG[i]] << " ***" << endl;
             cout << "************************" << endl;
+            CFDFCthroughput[i] = milp[milpVars.th_MG[i]];
         }
     }
 
@@ -538,6 +567,8 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
         return false;
     }
 
+    startBufferCheckpoint(Period, BufferDelay);
+
     if (MaxThroughput) {
         assert (coverage >= 0.0 and coverage <= 1.0);
         coverage = extractMarkedGraphsBB(coverage);
@@ -613,6 +644,9 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
 
     auto milpVars_sc = vector<milpVarsEB>(MG_disjoint.size(), milpVarsEB());
     long long total_time = 0;
+    bool relax = getMilpRelaxation();
+    double relax_bound = 0, relax_th = 0;   // Sum of throughputs (LP bound and after rounding)
+    milp.setRelaxation(relax);
     double order_buf = 0.0001, order_slot = 0.00001;
 
     if (MaxThroughput) computeChannelFrequencies();
@@ -622,6 +656,20 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
         cout << "Initiating MILP for MG number " << i << endl;
         cout << "-------------------------------" << endl;
 
+        if (restoreMGfromCheckpoint(i)) {
+            cout << "MG " << i << " restored from checkpoint" << endl;
+            writeTagsNumber();
+            continue;
+        }
+
+        // Single-cycle MGs do not need the MILP (see DFnetlist_buffers_cycle.cpp)
+        if (MaxThroughput and sizeSingleCycleMG(i, Period, BufferDelay)) {
+            writeTagsNumber();
+            checkpointMG(i);
+            continue;
+        }
+
+        long long build_start = get_timestamp();
         createMilpVarsEB_sc(milp, milpVars_sc[i], MaxThroughput, i, first_MG);
         if (not createPathConstraints_sc(milp, milpVars_sc[i], Period, BufferDelay, i)) 
 			return false;
@@ -657,9 +705,12 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
         }
 
         milp.setMaximize();
+        printf ("Milp construction time for MG %d: [ms] %d \n\n\r", i, (int) (get_timestamp() - build_start));
 
         long long start_time, end_time;
         uint32_t elapsed_time;
+        milp.setCorpusDir(getMilpCorpusDir());
+        milp.setCorpusTag(net_name, "addElasticBuffersBB_sc", i, Period);
         start_time = get_timestamp();
         if (timeout > 0) milp.solve(timeout);
         else milp.solve();
@@ -684,10 +735,14 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
             }
         }
 
+        // Relaxation: round and repair the fractional solution (see DFnetlist_buffers_relax.cpp)
+        if (relax and not roundRelaxedMG(milp, milpVars_sc[i], i, Period, BufferDelay, MaxThroughput,
+                                         first_MG, relax_bound, relax_th)) return false;
+
         // Add channels
         vector<channelID> buffers;
         for (channelID c: MG_disjoint[i].getChannels()) {
-            if (channelIsCovered(c, false, true, true)) continue;
+            if (relax or channelIsCovered(c, false, true, true)) continue;
             if (milp[milpVars_sc[i].buffer_slots[c]] > 0.5) {
                 buffers.push_back(c);
             }
@@ -696,48 +751,25 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
         for (channelID c: buffers) {
             int slots = milp[milpVars_sc[i].buffer_slots[c]] + 0.5; // Automatically truncated
             bool transparent = milp.isFalse(milpVars_sc[i].buffer_flop[c]);
-            setChannelTransparency(c, transparent);
-            if(transparent)
-            { 
-                if(getBlockType(getSrcBlock(c)) == CNTRL_MG) {
-                    setChannelBufferSize(c, slots+5);
-                    printChannelInfo(c, slots+5, transparent);
-                } else {
-                    setChannelBufferSize(c, slots+1);
-                    printChannelInfo(c, slots+1, transparent);
-                }
-            }
-            else
-            {
-                setChannelBufferSize(c, slots);
-                printChannelInfo(c, slots, transparent);
-            }
+            setMGBuffer(c, slots, transparent);
         }
 
-        int N = 0;
-        if(multithread)
-        {
-           N = N_tags;  
-            if(N <= 0)
-                N = 1;
-        }
-        else
-        {
-            N = 1;
-        }
-
-        ofstream myfile;
-        myfile.open ("/home/dynamatic/Dynamatic/etc/dynamatic/dot2vhdl/src/gian_N.txt");
-        if(!myfile)
-            cout << "Problem opening file\n";
-        myfile << to_string(N);
-        myfile.close();
+        writeTagsNumber();
 
         //write retiming diffs
-        writeRetimingDiffs(milp, milpVars_sc[i]);
+        if (not relax) writeRetimingDiffs(milp, milpVars_sc[i]);
 
+        if (MaxThroughput and not relax) {
+            for (auto sub_mg: components[i]) {
+                CFDFCthroughput[sub_mg] = milp[milpVars_sc[i].th_MG[sub_mg]];
+                if (first_MG) break;
+            }
+        }
 
-        if (MaxThroughput) {
+        checkpointMG(i);
+
+
+        if (MaxThroughput and not relax) {
             for (auto sub_mg: components[i]) {
                 cout << "\n*** Throughput achieved in sub MG " << sub_mg << ": " <<
                      fixed << setprecision(2) << milp[milpVars_sc[i].th_MG[sub_mg]] << " ***\n" << endl;
@@ -760,7 +792,15 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
         return false;
     }
 
+    if (relax and relax_bound > 0) {
+        cout << "***************************" << endl;
+        cout << "Relaxation: total throughput " << fixed << setprecision(2) << relax_th << ", LP bound "
+             << relax_bound << " (gap <= " << 100 * (relax_bound - relax_th) / relax_bound << "%)" << endl;
+        cout << "***************************" << endl;
+    }
 
+    // The model for the remaining channels is small: always solve the MILP
+    milp.setRelaxation(false);
 
     milpVarsEB remaining;
 
@@ -779,6 +819,8 @@ bool DFnetlist_Impl::addElasticBuffersBB_sc(double Period, double BufferDelay, b
 
     long long start_time, end_time;
     uint32_t elapsed_time;
+    milp.setCorpusDir(getMilpCorpusDir());
+    milp.setCorpusTag(net_name, "addElasticBuffersBB_sc_remaining", -1, Period);
     start_time = get_timestamp();
     if (timeout > 0) milp.solve(timeout);
     else milp.solve();
@@ -2096,6 +2138,17 @@ void DFnetlist_Impl::dumpMilpSolution(const Milp_Model& milp, const milpVarsEB&
 
 }
 
+void DFnetlist_Impl::setMGBuffer(channelID c, int slots, bool transparent)
+{
+    setChannelTransparency(c, transparent);
+    if (transparent) {
+        // Transparent buffers get extra slots (more for control merges)
+        slots += getBlockType(getSrcBlock(c)) == CNTRL_MG ? 5 : 1;
+    }
+    setChannelBufferSize(c, slots);
+    printChannelInfo(c, slots, transparent);
+}
+
 void DFnetlist_Impl::writeRetimingDiffs(const Milp_Model& milp, const milpVarsEB& vars)
 {
     ForAllBlocks(b) {
@@ -2113,4 +2166,21 @@ void DFnetlist_Impl::writeRetimingDiffs(const Milp_Model& milp, const milpVarsEB
         }
         //cout << ", Retiming bub = " << milp[ret_bub] << endl;
     }
-}
\ No newline at end of file
+}
+bool DFnetlist_Impl::writeThroughputs(const string& filename)
+{
+    ostringstream s;
+    s << setprecision(17);
+    s << "# cfdfc <index> <throughput> <freq> <#BBs> <BB>... <#arcs> <srcBB> <dstBB> ..." << endl;
+    for (auto& th: CFDFCthroughput) {
+        int i = th.first;
+        if (i < 0 or i >= CFDFC.size()) continue;
+        subNetlistBB& cfdfc = CFDFC[i];
+        s << "cfdfc " << i << ' ' << th.second << ' ' << CFDFCfreq[i] << ' ' << cfdfc.numBasicBlocks();
+        for (bbID bb: cfdfc.getBasicBlocks()) s << ' ' << bb;
+        s << ' ' << cfdfc.numBasicBlockArcs();
+        for (bbArcID arc: cfdfc.getBasicBlockArcs()) s << ' ' << BBG.getSrcBB(arc) << ' ' << BBG.getDstBB(arc);
+        s << endl;
+    }
+    return FileUtil::write(s.str(), filename, getError());
+}
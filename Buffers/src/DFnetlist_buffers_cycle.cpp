@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include "DFnetlist.h"
+
+using namespace Dataflow;
+using namespace std;
+
+extern bool multithread;   // Defined in DFnetlist_buffers.cpp
+
+/*
+ * Closed-form buffer placement for MGs that consist of a single simple cycle,
+ * possibly with tree-shaped fragments attached to it (e.g., constants feeding the
+ * cycle or exits fed by the cycle). For these MGs the MILP of
+ * addElasticBuffersBB_sc has a direct solution:
+ *
+ * - Path constraints: the minimum number of flops F in the cycle is obtained
+ *   by cutting the cycle greedily (as late as possible) from every possible
+ *   starting channel. Attached fragments are cut greedily with the same rule,
+ *   and they are always cut before the cycle since they do not affect throughput.
+ *
+ * - Throughput: with T tokens (back edges) and L cycles of latency in the
+ *   cycle, the throughput constraints of the MILP reduce to
+ *
+ *       th = min(1, T/(F + L), 1/II)
+ *
+ *   where II is the largest initiation interval of the pipelined units.
+ *
+ * - Slots: every flop holds th tokens and needs ceil(2*th) slots. The tokens
+ *   that are not needed to sustain the throughput (slack) are absorbed by the
+ *   pipelined units first, then by the unused capacity of the flops, and
+ *   finally by extra slots in one of the flops.
+ *
+ * The fast path is only applied to MGs without memory interfaces, tagging
+ * blocks and channels in their borders, since they have special constraints
+ * in the MILP, and whose fragments are trees: a fragment that reconverges
+ * (e.g., a fork whose branches have different latencies and join again)
+ * needs slots to balance its paths, and it is left to the MILP.
+ */
+
+bool DFnetlist_Impl::cutBlockInputs(blockID b, const setChannels& inside, portID cycle_in, bool cuttable_cycle,
+                                    double Period, double BufferDelay, vector<double>& arrival, setChannels& flops) const
+{
+    vector<portID> inputs;
+    ForAllInputPorts(b, p) {
+        if (inside.count(getConnectedChannel(p)) > 0) inputs.push_back(p);
+    }
+
+    // Cut order: non-cycle inputs by decreasing arrival, then the cycle input
+    sort(inputs.begin(), inputs.end(), [&](portID p1, portID p2) {
+        if ((p1 == cycle_in) != (p2 == cycle_in)) return p2 == cycle_in;
+        return arrival[p1] > arrival[p2];
+    });
+
+    auto cut = [&](portID p) {
+        channelID c = getConnectedChannel(p);
+        if (flops.count(c) > 0) return false;
+        if (p == cycle_in and not cuttable_cycle) return false;
+        flops.insert(c);
+        arrival[p] = BufferDelay;
+        return true;
+    };
+
+    if (getLatency(b) > 0) {
+        // Pipelined units: the inputs must reach the internal registers
+        for (portID p: inputs) {
+            if (arrival[p] + getPortDelay(p) <= Period) continue;
+            if (not cut(p) or BufferDelay + getPortDelay(p) > Period) return false;
+        }
+        ForAllOutputPorts(b, p) arrival[p] = getPortDelay(p);
+        return true;
+    }
+
+    auto outputTime = [&](portID out_p) {
+        double t = 0;
+        for (portID in_p: inputs) t = max(t, arrival[in_p] + getCombinationalDelay(in_p, out_p));
+        return t;
+    };
+
+    ForAllOutputPorts(b, out_p) {
+        unsigned int next = 0;
+        while (outputTime(out_p) > Period) {
+            while (next < inputs.size() and not cut(inputs[next])) ++next;
+            if (next == inputs.size()) return false;
+        }
+    }
+
+    ForAllOutputPorts(b, out_p) arrival[out_p] = outputTime(out_p);
+    return true;
+}
+
+void DFnetlist_Impl::propagateArrival(channelID c, double BufferDelay, vector<double>& arrival,
+                                      const setChannels& flops) const
+{
+    portID dst = getDstPort(c);
+    if (flops.count(c) > 0) arrival[dst] = BufferDelay;
+    else arrival[dst] = max(arrival[getSrcPort(c)], BufferDelay);
+}
+
+bool DFnetlist_Impl::sizeSingleCycleMG(int mg, double Period, double BufferDelay)
+{
+    if (multithread or components[mg].size() != 1) return false;
+
+    const subNetlist& ntl = MG_disjoint[mg];
+    const setChannels& inside = ntl.getChannels();
+
+    // The channels in the borders of this MG have path constraints in the MILP
+    for (channelID c: channels_in_borders) {
+        if (ntl.hasBlock(getSrcBlock(c)) or ntl.hasBlock(getDstBlock(c))) return false;
+    }
+
+    // Memory interfaces and tagging blocks have special rules in the MILP
+    for (blockID b: ntl.getBlocks()) {
+        BlockType type = getBlockType(b);
+        if (type == LSQ or type == MC or type == TAGGER or type == UNTAGGER or type == FREE_TAGS_FIFO)
+            return false;
+        if (type == OPERATOR and (getOperation(b) == "select_op" or getOperation(b) == "lsq_store_op"))
+            return false;
+        ForAllPorts(b, p) {
+            channelID c = getConnectedChannel(p);
+            if (not validChannel(c)) continue;
+            BlockType other = getBlockType(isInputPort(p) ? getSrcBlock(c) : getDstBlock(c));
+            if (other == LSQ or other == MC) return false;
+        }
+    }
+
+    // The fragments must be trees: with a connected MG and as many channels as
+    // blocks, the cycle is the only (undirected) cycle. A reconvergent fragment
+    // needs the slots that balance its paths, which are only found by the MILP.
+    if (ntl.getBlocks().empty() or inside.size() != ntl.getBlocks().size()) return false;
+    setBlocks reached;
+    vector<blockID> visit = {*ntl.getBlocks().begin()};
+    reached.insert(visit[0]);
+    while (not visit.empty()) {
+        blockID b = visit.back();
+        visit.pop_back();
+        ForAllPorts(b, p) {
+            channelID c = getConnectedChannel(p);
+            if (not inside.count(c)) continue;
+            blockID other = isInputPort(p) ? getSrcBlock(c) : getDstBlock(c);
+            if (reached.insert(other).second) visit.push_back(other);
+        }
+    }
+    if (reached.size() != ntl.getBlocks().size()) return false;
+
+    // Prune the acyclic fragments: blocks without predecessors (in) or
+    // successors (out) inside the remaining MG.
+    map<blockID, int> indeg, outdeg;
+    for (blockID b: ntl.getBlocks()) indeg[b] = outdeg[b] = 0;
+    for (channelID c: inside) {
+        indeg[getDstBlock(c)]++;
+        outdeg[getSrcBlock(c)]++;
+    }
+
+    setBlocks in_frag, out_frag;
+    vector<blockID> pending(ntl.getBlocks().begin(), ntl.getBlocks().end());
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (blockID b: pending) {
+            if (in_frag.count(b) or out_frag.count(b)) continue;
+            if (indeg[b] > 0 and outdeg[b] > 0) continue;
+            (indeg[b] == 0 ? in_frag : out_frag).insert(b);
+            ForAllOutputPorts(b, p) {
+                channelID c = getConnectedChannel(p);
+                if (inside.count(c)) indeg[getDstBlock(c)]--;
+            }
+            ForAllInputPorts(b, p) {
+                channelID c = getConnectedChannel(p);
+                if (inside.count(c)) outdeg[getSrcBlock(c)]--;
+            }
+            changed = true;
+        }
+    }
+
+    // The remaining blocks must form a single simple cycle
+    vector<channelID> cycle;
+    blockID first = invalidDataflowID;
+    for (blockID b: ntl.getBlocks()) {
+        if (in_frag.count(b) or out_frag.count(b)) continue;
+        if (indeg[b] != 1 or outdeg[b] != 1) return false;
+        if (first == invalidDataflowID) first = b;
+    }
+    if (first == invalidDataflowID) return false;
+
+    map<blockID, channelID> next_channel;   // Cycle channel leaving each cycle block
+    map<blockID, portID> cycle_input;       // Cycle port entering each cycle block
+    for (channelID c: inside) {
+        blockID src = getSrcBlock(c), dst = getDstBlock(c);
+        if (in_frag.count(src) or out_frag.count(src) or in_frag.count(dst) or out_frag.count(dst)) continue;
+        next_channel[src] = c;
+        cycle_input[dst] = getDstPort(c);
+    }
+
+    blockID b = first;
+    do {
+        cycle.push_back(next_channel[b]);
+        b = getDstBlock(next_channel[b]);
+    } while (b != first and cycle.size() <= next_channel.size());
+    if (b != first or cycle.size() != next_channel.size()) return false;
+
+    int tokens = 0;
+    for (channelID c: cycle) if (isBackEdge(c)) tokens++;
+    if (tokens == 0) return false;
+
+    bool hasPeriod = Period > 0;
+    if (not hasPeriod) Period = INFINITY;
+
+    // Topological order of a fragment (the MG without the cycle channels is acyclic)
+    auto topoOrder = [&](const setBlocks& frag) {
+        vector<blockID> order;
+        map<blockID, int> deg;
+        for (blockID f: frag) {
+            deg[f] = 0;
+            ForAllInputPorts(f, p) {
+                channelID c = getConnectedChannel(p);
+                if (inside.count(c) and frag.count(getSrcBlock(c))) deg[f]++;
+            }
+        }
+        for (blockID f: frag) if (deg[f] == 0) order.push_back(f);
+        for (unsigned int i = 0; i < order.size(); ++i) {
+            ForAllOutputPorts(order[i], p) {
+                channelID c = getConnectedChannel(p);
+                if (inside.count(c) and frag.count(getDstBlock(c)) and --deg[getDstBlock(c)] == 0)
+                    order.push_back(getDstBlock(c));
+            }
+        }
+        return order;
+    };
+
+    auto propagateOutputs = [&](blockID f, vector<double>& arrival, const setChannels& flops) {
+        ForAllOutputPorts(f, p) {
+            channelID c = getConnectedChannel(p);
+            if (inside.count(c)) propagateArrival(c, BufferDelay, arrival, flops);
+        }
+    };
+
+    // Input fragments do not depend on the cycle: calculate them once
+    vector<double> base_arrival(vecPortsSize(), 0);
+    setChannels base_flops;
+    for (blockID f: topoOrder(in_frag)) {
+        if (not cutBlockInputs(f, inside, invalidDataflowID, false, Period, BufferDelay, base_arrival, base_flops))
+            return false;
+        propagateOutputs(f, base_arrival, base_flops);
+    }
+
+    // Cut the cycle from every starting channel and keep the solution with fewer
+    // flops in the cycle (and fewer flops in total in case of a tie)
+    int n = cycle.size();
+    int best_cycle_flops = -1;
+    vector<double> best_arrival;
+    setChannels best_flops;
+
+    auto cuttable = [&](channelID c) {
+        // The MILP does not count these buffers for elasticity (see createElasticityConstraints_sc)
+        BlockType t = getBlockType(getSrcBlock(c));
+        return t != MUX and t != LOOPMUX and t != CNTRL_MG;
+    };
+
+    for (int s = 0; s < n; ++s) {
+        if (not cuttable(cycle[s])) continue;
+
+        vector<double> arrival = base_arrival;
+        setChannels flops = base_flops;
+        flops.insert(cycle[s]);
+        propagateArrival(cycle[s], BufferDelay, arrival, flops);
+
+        bool ok = true;
+        for (int j = 1; j <= n and ok; ++j) {
+            channelID in_c = cycle[(s + j - 1) % n];
+            blockID blk = getDstBlock(in_c);
+            ok = cutBlockInputs(blk, inside, getDstPort(in_c), cuttable(in_c), Period, BufferDelay, arrival, flops);
+            if (ok and j < n) propagateArrival(cycle[(s + j) % n], BufferDelay, arrival, flops);
+        }
+        if (not ok) continue;
+
+        for (blockID f: topoOrder(out_frag)) {
+            // Outputs of the cycle blocks feeding this fragment
+            ForAllInputPorts(f, p) {
+                channelID c = getConnectedChannel(p);
+                if (inside.count(c) and not out_frag.count(getSrcBlock(c)) and not in_frag.count(getSrcBlock(c)))
+                    propagateArrival(c, BufferDelay, arrival, flops);
+            }
+            if (not cutBlockInputs(f, inside, invalidDataflowID, false, Period, BufferDelay, arrival, flops)) {
+                ok = false;
+                break;
+            }
+            propagateOutputs(f, arrival, flops);
+        }
+        if (not ok) continue;
+
+        int cycle_flops = 0;
+        for (channelID c: cycle) if (flops.count(c)) cycle_flops++;
+        if (best_cycle_flops < 0 or cycle_flops < best_cycle_flops
+            or (cycle_flops == best_cycle_flops and flops.size() < best_flops.size())) {
+            best_cycle_flops = cycle_flops;
+            best_arrival = arrival;
+            best_flops = flops;
+        }
+    }
+
+    if (best_cycle_flops < 0) return false;
+
+    // Throughput of the cycle
+    int latency = 0;
+    double max_II = 1;
+    for (channelID c: cycle) {
+        blockID blk = getDstBlock(c);
+        latency += getLatency(blk);
+        if (getLatency(blk) > 0) max_II = max(max_II, (double) getInitiationInterval(blk));
+    }
+    double th = min(1.0, min((double) tokens / (best_cycle_flops + latency), 1.0 / max_II));
+
+    // Tokens in excess: first retimed into the pipelined units, then stored in the flops
+    double slack = tokens - th * (best_cycle_flops + latency);
+    for (channelID c: cycle) {
+        blockID blk = getDstBlock(c);
+        double lat = getLatency(blk);
+        if (lat == 0) continue;
+        double retime = lat * th;
+        double extra = min(max(slack, 0.0), lat / getInitiationInterval(blk) - retime);
+        retime += extra;
+        slack -= extra;
+        setBlockRetimingDiff(blk, retime);
+    }
+
+    const double eps = 1e-9;
+    map<channelID, double> tokens_in;   // Tokens held by every flop
+    for (channelID c: best_flops) tokens_in[c] = th;
+    for (channelID c: cycle) {
+        if (slack <= eps or not best_flops.count(c)) continue;
+        double room = ceil(2 * th - eps) - 2 * th;
+        double extra = min(slack, room);
+        tokens_in[c] += extra;
+        slack -= extra;
+    }
+    if (slack > eps) {
+        for (channelID c: cycle) {
+            if (not best_flops.count(c)) continue;
+            tokens_in[c] += slack;
+            break;
+        }
+    }
+
+    cout << "Single-cycle MG " << mg << ": " << n << " channels in the cycle, " << tokens << " tokens, latency "
+         << latency << ", " << best_cycle_flops << " flops. Skipping MILP." << endl;
+
+    for (channelID c: best_flops) {
+        if (channelIsCovered(c, false, true, true)) continue;
+        int slots = ceil(tokens_in[c] + th - eps);
+        setMGBuffer(c, max(slots, 1), false);
+    }
+
+    cout << "\n*** Throughput achieved in sub MG " << components[mg][0] << ": " <<
+         fixed << setprecision(2) << th << " ***\n" << endl;
+    CFDFCthroughput[components[mg][0]] = th;
+
+    return true;
+}
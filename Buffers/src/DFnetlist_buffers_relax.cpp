@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include "DFnetlist.h"
+
+using namespace Dataflow;
+using namespace std;
+
+extern bool multithread;   // Defined in DFnetlist_buffers.cpp
+extern int N_tags;
+
+/*
+ * Rounding and repair of the LP relaxation of the buffer placement MILP
+ * (addElasticBuffersBB_sc in relaxation mode).
+ *
+ * The LP relaxation gives fractional values to the buffer variables of an MG.
+ * They are rounded (flop if buffer_flop >= 0.5, nearest integer for the slots)
+ * and the solution is then repaired to be valid:
+ *
+ * - Elasticity: every cycle without a flop is cut at the channel with the
+ *   highest fractional flop value.
+ *
+ * - Timing: the same for combinational cycles. Then a longest-path pass in
+ *   topological order cuts the inputs of the blocks whose outputs exceed the
+ *   period (see cutBlockInputs).
+ *
+ * - Throughput: for a given throughput th, the throughput constraints of the
+ *   MILP are difference constraints on the retiming variables:
+ *
+ *       lower(c) <= N*token(c) + r_out(src) - r_in(dst) <= upper(c)
+ *       lat*th <= r_out(b) - r_in(b) <= lat/II
+ *
+ *   with lower(c) = th*flop(c) and upper(c) = slots(c) - th*flop(c). They are
+ *   feasible iff the constraint graph has no negative cycle (Bellman-Ford),
+ *   i.e., th is bounded by the cycle ratio of the MG. The target throughput is
+ *   the LP bound, limited by the throughput achievable with the rounded flops.
+ *   While the target is infeasible, the slots missing in the negative cycle
+ *   are added to one of its channels, for a bounded number of rounds.
+ *
+ * The LP bound is an upper bound of the MILP optimum, hence the reported gap
+ * is an upper bound of the gap versus the MILP.
+ */
+
+namespace {
+
+// Difference constraint x[to] - x[from] <= w0 + wth*th + slots(c)
+struct DiffEdge {
+    int from, to;
+    double w0, wth;
+    channelID c;        // Channel whose slots contribute to the weight (invalid if none)
+};
+
+/**
+ * @brief Checks the feasibility of a system of difference constraints (Bellman-Ford).
+ * @param n Number of variables.
+ * @param edges The constraints.
+ * @param weight Function that calculates the weight of an edge.
+ * @param dist Solution of the system if feasible (output).
+ * @param cycle Edges (indices) of a negative cycle if infeasible (output).
+ * @return True if feasible, and false otherwise.
+ */
+template <typename Weight>
+bool solveDiffConstraints(int n, const vector<DiffEdge>& edges, Weight weight,
+                          vector<double>& dist, vector<int>& cycle)
+{
+    const double eps = 1e-9;
+    dist = vector<double>(n, 0);
+    vector<int> pred(n, -1);
+    cycle.clear();
+
+    int last = -1;
+    for (int it = 0; it < n; ++it) {
+        last = -1;
+        for (unsigned int e = 0; e < edges.size(); ++e) {
+            double d = dist[edges[e].from] + weight(edges[e]);
+            if (d < dist[edges[e].to] - eps) {
+                dist[edges[e].to] = d;
+                pred[edges[e].to] = e;
+                last = edges[e].to;
+            }
+        }
+        if (last < 0) return true;
+    }
+
+    // Go back n times to land in the negative cycle
+    for (int i = 0; i < n; ++i) last = edges[pred[last]].from;
+    int v = last;
+    do {
+        cycle.push_back(pred[v]);
+        v = edges[pred[v]].from;
+    } while (v != last);
+    return false;
+}
+
+}
+
+bool DFnetlist_Impl::roundRelaxedMG(const Milp_Model& milp, const milpVarsEB& vars, int mg, double Period,
+                                    double BufferDelay, bool MaxThroughput, bool first_MG,
+                                    double& lp_th, double& achieved_th)
+{
+    const subNetlist& ntl = MG_disjoint[mg];
+    if (Period <= 0) Period = INFINITY;
+
+    // Channels with path and elasticity constraints in the MILP
+    auto constrained = [&](channelID c) {
+        BlockType src = getBlockType(getSrcBlock(c)), dst = getBlockType(getDstBlock(c));
+        if (src == LSQ or dst == LSQ or src == MC or dst == MC) return false;
+        if ((dst == FREE_TAGS_FIFO and src == UNTAGGER) or (dst == TAGGER and src == FREE_TAGS_FIFO)) return false;
+        return true;
+    };
+
+    // Muxes and control merges have internal buffers for elasticity
+    auto elasticSource = [&](channelID c) {
+        BlockType src = getBlockType(getSrcBlock(c));
+        return src == MUX or src == LOOPMUX or src == CNTRL_MG;
+    };
+
+    ////////////////
+    /// ROUNDING ///
+    ////////////////
+
+    setChannels timed, flops;
+    map<channelID, double> lp_flop, lp_slots;
+    map<channelID, int> slots;
+    for (channelID c: ntl.getChannels()) {
+        if (channelIsCovered(c, false, true, false)) continue;
+        lp_flop[c] = milp[vars.buffer_flop[c]];
+        lp_slots[c] = milp[vars.buffer_slots[c]];
+        slots[c] = lround(lp_slots[c]);
+        if (not constrained(c)) continue;
+        timed.insert(c);
+        if (lp_flop[c] >= 0.5) flops.insert(c);
+    }
+    int rounded_flops = flops.size();
+
+    ///////////////////////////
+    /// ELASTICITY / TIMING ///
+    ///////////////////////////
+
+    // Cuts the cycles formed by the channels selected by 'edge' and returns
+    // the blocks in topological order.
+    auto breakCycles = [&](function<bool(channelID)> edge) {
+        while (true) {
+            map<blockID, int> indeg;
+            for (blockID b: ntl.getBlocks()) indeg[b] = 0;
+            for (channelID c: timed) {
+                if (edge(c)) indeg[getDstBlock(c)]++;
+            }
+
+            vector<blockID> order;
+            for (blockID b: ntl.getBlocks()) if (indeg[b] == 0) order.push_back(b);
+            for (unsigned int i = 0; i < order.size(); ++i) {
+                ForAllOutputPorts(order[i], p) {
+                    channelID c = getConnectedChannel(p);
+                    if (timed.count(c) and edge(c) and --indeg[getDstBlock(c)] == 0) order.push_back(getDstBlock(c));
+                }
+            }
+            if ((int) order.size() == ntl.numBlocks()) return order;
+
+            // Remove the blocks that only follow the cycles
+            setBlocks in_cycles;
+            for (blockID b: ntl.getBlocks()) if (indeg[b] > 0) in_cycles.insert(b);
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (blockID b: in_cycles) {
+                    bool succ = false;
+                    ForAllOutputPorts(b, p) {
+                        channelID c = getConnectedChannel(p);
+                        if (timed.count(c) and edge(c) and in_cycles.count(getDstBlock(c))) succ = true;
+                    }
+                    if (not succ) {
+                        in_cycles.erase(b);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+
+            // Cut the channel with the highest flop value
+            channelID best = invalidDataflowID;
+            for (channelID c: timed) {
+                if (not edge(c) or not in_cycles.count(getSrcBlock(c)) or not in_cycles.count(getDstBlock(c))) continue;
+                if (best == invalidDataflowID or lp_flop[c] > lp_flop[best]) best = c;
+            }
+            assert(best != invalidDataflowID);
+            flops.insert(best);
+        }
+    };
+
+    breakCycles([&](channelID c) { return not flops.count(c) and not elasticSource(c); });
+    vector<blockID> order = breakCycles([&](channelID c) {
+        return not flops.count(c) and getLatency(getSrcBlock(c)) == 0;
+    });
+
+    // Longest paths in topological order
+    vector<double> arrival(vecPortsSize(), 0);
+    for (blockID b: ntl.getBlocks()) {
+        if (getLatency(b) == 0) continue;
+        ForAllOutputPorts(b, p) arrival[p] = getPortDelay(p);
+    }
+    for (blockID b: order) {
+        ForAllInputPorts(b, p) {
+            channelID c = getConnectedChannel(p);
+            if (timed.count(c)) propagateArrival(c, BufferDelay, arrival, flops);
+        }
+        if (not cutBlockInputs(b, timed, invalidDataflowID, false, Period, BufferDelay, arrival, flops)) {
+            setError("Block " + getBlockName(b) + ": path constraints cannot be satisfied.");
+            return false;
+        }
+    }
+
+    for (channelID c: flops) slots[c] = max(slots[c], 1);
+
+    cout << "Relaxation of MG " << mg << ": " << rounded_flops << " flops after rounding, "
+         << flops.size() - rounded_flops << " added by the repair." << endl;
+
+    //////////////////
+    /// THROUGHPUT ///
+    //////////////////
+
+    int N = multithread ? max(N_tags, 1) : 1;
+    int slots_added = 0;
+    double frac = 0.5;
+
+    for (auto sub_mg: MaxThroughput ? components[mg] : vector<int>()) {
+        // Nodes: retiming variables at the input and output of every block
+        map<blockID, int> in_node, out_node;
+        int n = 0;
+        for (blockID b: MG[sub_mg].getBlocks()) {
+            in_node[b] = n++;
+            out_node[b] = getLatency(b) > 0 ? n++ : in_node[b];
+        }
+
+        vector<DiffEdge> edges;
+        for (channelID c: MG[sub_mg].getChannels()) {
+            // Same exclusions as in createThroughputConstraints_sc
+            blockID dst = getDstBlock(c);
+            if (getBlockType(dst) == OPERATOR and getOperation(dst) == "select_op") {
+                if (getPortType(getDstPort(c)) == TRUE_PORT and getTrueFrac(dst) < frac) continue;
+                if (getPortType(getDstPort(c)) == FALSE_PORT and getTrueFrac(dst) > frac) continue;
+            }
+            if (getBlockType(dst) == OPERATOR and getOperation(dst) == "lsq_store_op") continue;
+
+            double tokens = isBackEdge(c) ? N : 0;
+            double flop = flops.count(c) ? 1 : 0;
+            int src_node = out_node[getSrcBlock(c)], dst_node = in_node[dst];
+
+            // th_tok <= slots - th*flop
+            edges.push_back({dst_node, src_node, -tokens, -flop, c});
+            // th_tok >= th*flop
+            edges.push_back({src_node, dst_node, tokens, -flop, invalidDataflowID});
+        }
+
+        for (blockID b: MG[sub_mg].getBlocks()) {
+            double lat = getLatency(b);
+            if (lat == 0) continue;
+            edges.push_back({in_node[b], out_node[b], lat / getInitiationInterval(b), 0, invalidDataflowID});
+            edges.push_back({out_node[b], in_node[b], 0, -lat, invalidDataflowID});
+        }
+
+        vector<double> dist;
+        vector<int> cycle;
+        auto feasible = [&](double th, bool bounded_slots) {
+            return solveDiffConstraints(n, edges, [&](const DiffEdge& e) {
+                if (validChannel(e.c) and not bounded_slots) return (double) INFINITY;
+                return e.w0 + e.wth * th + (validChannel(e.c) ? slots[e.c] : 0);
+            }, dist, cycle);
+        };
+
+        auto maxThroughput = [&](bool bounded_slots) {
+            if (feasible(1, bounded_slots)) return 1.0;
+            double lo = 0, hi = 1;
+            while (hi - lo > 1e-4) {
+                double mid = (lo + hi) / 2;
+                if (feasible(mid, bounded_slots)) lo = mid;
+                else hi = mid;
+            }
+            return lo;
+        };
+
+        double bound = milp[vars.th_MG[sub_mg]];
+        double target = min(bound, maxThroughput(false));
+
+        // Add slots until the target is feasible. Each round closes the
+        // negative cycle found by Bellman-Ford.
+        const int max_rounds = 64;
+        for (int it = 0; it < max_rounds and not feasible(target, true); ++it) {
+            double weight = 0;
+            for (int e: cycle) {
+                const DiffEdge& d = edges[e];
+                weight += d.w0 + d.wth * target + (validChannel(d.c) ? slots[d.c] : 0);
+            }
+            channelID best = invalidDataflowID;
+            for (int e: cycle) {
+                channelID c = edges[e].c;
+                if (not validChannel(c)) continue;
+                // Prefer channels that already have a buffer
+                if (best == invalidDataflowID or (slots[c] > 0) > (slots[best] > 0)
+                    or ((slots[c] > 0) == (slots[best] > 0) and lp_slots[c] - slots[c] > lp_slots[best] - slots[best]))
+                    best = c;
+            }
+            if (best == invalidDataflowID) break;
+            int missing = max(1, (int) ceil(-weight - 1e-9));
+            slots[best] += missing;
+            slots_added += missing;
+        }
+
+        double th = maxThroughput(true);
+        feasible(th, true);
+
+        // Retiming of the first MG (as in writeRetimingDiffs)
+        if (sub_mg == components[mg][0]) {
+            double min_dist = *min_element(dist.begin(), dist.end());
+            for (blockID b: MG[sub_mg].getBlocks()) {
+                double diff = getLatency(b) > 0 ? dist[out_node[b]] - dist[in_node[b]] : dist[in_node[b]] - min_dist;
+                setBlockRetimingDiff(b, diff);
+            }
+        }
+
+        cout << "\n*** Throughput achieved in sub MG " << sub_mg << ": " << fixed << setprecision(2) << th
+             << " (LP bound " << bound << ", gap <= " << (bound > 0 ? 100 * (bound - th) / bound : 0) << "%) ***\n" << endl;
+
+        lp_th += bound;
+        achieved_th += th;
+        CFDFCthroughput[sub_mg] = th;
+
+        if (first_MG) break;
+    }
+
+    if (slots_added > 0) cout << "Relaxation of MG " << mg << ": " << slots_added << " slots added for throughput." << endl;
+
+    for (channelID c: ntl.getChannels()) {
+        if (channelIsCovered(c, false, true, true) or slots[c] <= 0) continue;
+        setMGBuffer(c, slots[c], flops.count(c) == 0);
+    }
+
+    return true;
+}
@@ -416,7 +416,7 @@ bool DFnetlist_Impl::checkDemux(blockID b)
         }
     }
 
-    for (auto& pair: blocks[b].demuxPairs) {
+    for (auto& pair: blockInfo[b].demuxPairs) {
         portID p1 = pair.first;
         portID p2 = pair.second;
         if (not isControlPort(p1)) swap(p1, p2);
@@ -0,0 +1,240 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "DFnetlist.h"
+
+using namespace Dataflow;
+using namespace std;
+
+/*
+ * Checkpoint of the buffer placement (addElasticBuffersBB_sc).
+ *
+ * The file is a sequence of text lines:
+ *   buffers_checkpoint 1
+ *   design <name>
+ *   params <period> <delay>
+ *   cfdfc <freq> <#BBs> <BB>... <#arcs> <srcBB> <dstBB> ...
+ *   cfdfcs_done                      (all CFDFCs have been extracted)
+ *   mg <index> <#buffers> <#retimings>
+ *   buffer <block> <port> <slots> <transparent>
+ *   retiming <block> <diff>
+ *   throughput <cfdfc> <th>          (claimed by the MILP for the CFDFCs of the MG)
+ *
+ * Arcs are stored as pairs of BBs and channels as source block/port names,
+ * so that the file does not depend on the internal ids of the netlist.
+ */
+
+void DFnetlist_Impl::setBufferCheckpoint(const string& filename, bool resume)
+{
+    ckpt = bufferCheckpoint();
+    ckpt.filename = filename;
+    ckpt.resume = resume;
+    if (filename.empty() or not resume) return;
+
+    if (not readBufferCheckpoint()) {
+        cerr << "Warning: checkpoint " << filename << " could not be read. Starting from scratch." << endl;
+        ckpt.cfdfcs.clear();
+        ckpt.cfdfcsFreq.clear();
+        ckpt.cfdfcsDone = false;
+        ckpt.mgs.clear();
+    }
+}
+
+void DFnetlist_Impl::startBufferCheckpoint(double Period, double BufferDelay)
+{
+    ckpt.active = not ckpt.filename.empty();
+    if (not ckpt.active) return;
+
+    bool restored = not ckpt.cfdfcs.empty() or not ckpt.mgs.empty();
+    if (restored and (ckpt.period != Period or ckpt.delay != BufferDelay)) {
+        cerr << "Warning: checkpoint " << ckpt.filename << " was produced with period=" << ckpt.period
+             << " and buffer_delay=" << ckpt.delay << ". Starting from scratch." << endl;
+        restored = false;
+    }
+
+    if (not restored) {
+        ckpt.cfdfcs.clear();
+        ckpt.cfdfcsFreq.clear();
+        ckpt.cfdfcsDone = false;
+        ckpt.mgs.clear();
+    } else {
+        cout << "Resuming from checkpoint " << ckpt.filename << ": " << ckpt.cfdfcs.size()
+             << " CFDFCs" << (ckpt.cfdfcsDone ? "" : " (extraction incomplete)")
+             << ", " << ckpt.mgs.size() << " MGs completed." << endl;
+    }
+
+    ckpt.period = Period;
+    ckpt.delay = BufferDelay;
+}
+
+bool DFnetlist_Impl::writeBufferCheckpoint()
+{
+    if (not ckpt.active) return true;
+
+    ostringstream s;
+    s << setprecision(17);
+    s << "buffers_checkpoint 1" << endl;
+    s << "design " << net_name << endl;
+    s << "params " << ckpt.period << ' ' << ckpt.delay << endl;
+
+    for (unsigned int i = 0; i < CFDFC.size(); ++i) {
+        subNetlistBB& cfdfc = CFDFC[i];
+        s << "cfdfc " << CFDFCfreq[i] << ' ' << cfdfc.numBasicBlocks();
+        for (bbID bb: cfdfc.getBasicBlocks()) s << ' ' << bb;
+        s << ' ' << cfdfc.numBasicBlockArcs();
+        for (bbArcID arc: cfdfc.getBasicBlockArcs()) s << ' ' << BBG.getSrcBB(arc) << ' ' << BBG.getDstBB(arc);
+        s << endl;
+    }
+
+    if (ckpt.cfdfcsDone) s << "cfdfcs_done" << endl;
+
+    for (auto& mg: ckpt.mgs) {
+        s << "mg " << mg.first << ' ' << mg.second.buffers.size() << ' ' << mg.second.retiming.size() << endl;
+        for (auto& buf: mg.second.buffers)
+            s << "buffer " << buf.block << ' ' << buf.port << ' ' << buf.slots << ' ' << buf.transparent << endl;
+        for (auto& ret: mg.second.retiming)
+            s << "retiming " << ret.first << ' ' << ret.second << endl;
+        for (auto& th: mg.second.throughput)
+            s << "throughput " << th.first << ' ' << th.second << endl;
+    }
+
+    // Write into a temporary file and rename it, to never leave a truncated checkpoint
+    string tmp = ckpt.filename + ".tmp";
+    string err;
+    if (not FileUtil::write(s.str(), tmp, err) or rename(tmp.c_str(), ckpt.filename.c_str()) != 0) {
+        cerr << "Warning: checkpoint " << ckpt.filename << " could not be written." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool DFnetlist_Impl::readBufferCheckpoint()
+{
+    ifstream f(ckpt.filename);
+    if (not f.is_open()) return false;
+
+    string line, key;
+    int version = 0;
+    if (not getline(f, line)) return false;
+    istringstream header(line);
+    if (not (header >> key >> version) or key != "buffers_checkpoint" or version != 1) return false;
+
+    int mg = -1;
+    while (getline(f, line)) {
+        istringstream iss(line);
+        if (not (iss >> key)) continue;
+
+        if (key == "design") {
+            string name;
+            iss >> name;
+            if (name != net_name) return false;
+        } else if (key == "params") {
+            if (not (iss >> ckpt.period >> ckpt.delay)) return false;
+        } else if (key == "cfdfc") {
+            subNetlistBB cfdfc;
+            double freq;
+            int n;
+            if (not (iss >> freq >> n)) return false;
+            for (int i = 0; i < n; ++i) {
+                bbID bb;
+                if (not (iss >> bb)) return false;
+                cfdfc.insertBasicBlock(bb);
+            }
+            if (not (iss >> n)) return false;
+            for (int i = 0; i < n; ++i) {
+                bbID src, dst;
+                if (not (iss >> src >> dst)) return false;
+                bbArcID arc = BBG.findArc(src, dst);
+                if (arc == invalidDataflowID) return false;
+                cfdfc.insertBasicBlockArc(arc);
+            }
+            ckpt.cfdfcs.push_back(cfdfc);
+            ckpt.cfdfcsFreq.push_back(freq);
+        } else if (key == "cfdfcs_done") {
+            ckpt.cfdfcsDone = true;
+        } else if (key == "mg") {
+            if (not (iss >> mg)) return false;
+            ckpt.mgs[mg];
+        } else if (key == "buffer") {
+            bufferCheckpoint::bufferDecision buf;
+            if (mg < 0 or not (iss >> buf.block >> buf.port >> buf.slots >> buf.transparent)) return false;
+            ckpt.mgs[mg].buffers.push_back(buf);
+        } else if (key == "retiming") {
+            string block;
+            double diff;
+            if (mg < 0 or not (iss >> block >> diff)) return false;
+            ckpt.mgs[mg].retiming.push_back({block, diff});
+        } else if (key == "throughput") {
+            int cfdfc;
+            double th;
+            if (mg < 0 or not (iss >> cfdfc >> th)) return false;
+            ckpt.mgs[mg].throughput.push_back({cfdfc, th});
+        } else return false;
+    }
+
+    return true;
+}
+
+void DFnetlist_Impl::checkpointMG(int mg)
+{
+    if (not ckpt.active) return;
+
+    bufferCheckpoint::mgDecisions& decisions = ckpt.mgs[mg];
+    decisions = bufferCheckpoint::mgDecisions();
+
+    for (channelID c: MG_disjoint[mg].getChannels()) {
+        int slots = getChannelBufferSize(c);
+        if (slots <= 0) continue;
+        portID p = getSrcPort(c);
+        decisions.buffers.push_back({getBlockName(getBlockFromPort(p)), getPortName(p, false),
+                                     slots, isChannelTransparent(c)});
+    }
+
+    for (blockID b: MG_disjoint[mg].getBlocks())
+        decisions.retiming.push_back({getBlockName(b), getBlockRetimingDiff(b)});
+
+    for (int sub_mg: components[mg]) {
+        auto th = CFDFCthroughput.find(sub_mg);
+        if (th != CFDFCthroughput.end()) decisions.throughput.push_back(*th);
+    }
+
+    writeBufferCheckpoint();
+}
+
+bool DFnetlist_Impl::restoreMGfromCheckpoint(int mg)
+{
+    if (not ckpt.active) return false;
+
+    auto it = ckpt.mgs.find(mg);
+    if (it == ckpt.mgs.end()) return false;
+
+    for (auto& buf: it->second.buffers) {
+        blockID b = getBlock(buf.block);
+        portID p = validBlock(b) ? getPort(b, buf.port) : invalidDataflowID;
+        if (not validPort(p) or not validChannel(getConnectedChannel(p))) {
+            cerr << "Warning: channel " << buf.block << ":" << buf.port
+                 << " from the checkpoint not found. Solving MG " << mg << " again." << endl;
+            ckpt.mgs.erase(it);
+            return false;
+        }
+    }
+
+    for (auto& buf: it->second.buffers) {
+        channelID c = getConnectedChannel(getPort(getBlock(buf.block), buf.port));
+        setChannelTransparency(c, buf.transparent);
+        setChannelBufferSize(c, buf.slots);
+        printChannelInfo(c, buf.slots, buf.transparent);
+    }
+
+    for (auto& ret: it->second.retiming) {
+        blockID b = getBlock(ret.first);
+        if (validBlock(b)) setBlockRetimingDiff(b, ret.second);
+    }
+
+    for (auto& th: it->second.throughput) CFDFCthroughput[th.first] = th.second;
+
+    return true;
+}
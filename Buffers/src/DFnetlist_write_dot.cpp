@@ -93,6 +93,13 @@ bool DFnetlist_Impl::writeDot(const string& filename)
     return FileUtil::write(of.str(), filename, getError());
 }
 
+void DFnetlist_Impl::setDotColors(const map<blockID,string>& block_colors,
+                                  const map<channelID,string>& channel_colors)
+{
+    dotBlockColor = block_colors;
+    dotChannelColor = channel_colors;
+}
+
 bool DFnetlist_Impl::writeDot(std::ostream& of)
 {
     of << "// Number of blocks: " << numBlocks() << endl;
@@ -159,11 +166,11 @@ for (bbID i = 1; i <= BBG.numBasicBlocks(); i++) {
 
     of << "}\n";
 }
-// Print remaining nodes (bbID = 0)
+// Print remaining nodes (bbID = 0, or no basic block graph, e.g., read from a _graph_buf.dot file)
     ForAllBlocks(b) {
         bbID bb_src = getBasicBlock(b);
         
-        if (bb_src == 0) 
+        if (bb_src == 0 or bb_src > BBG.numBasicBlocks()) 
             writeBlockDot(of, b);
     }
 
@@ -263,6 +270,7 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
     int num_control = 0, num_noncontrol = 0;
 
     Block& B = blocks[b];
+    BlockInfo& BI = blockInfo[b];
     // Ports
     string inp, outp;
 
@@ -328,7 +336,7 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
     // The list of input and output ports are listed in order, with the
     // data port at the end of the input ports.
     if (getBlockType(b) == DEMUX) {
-        for(auto& pair: B.demuxPairs) {
+        for(auto& pair: BI.demuxPairs) {
             if (not isControlPort(pair.first)) continue;
             inp += getPortName(pair.first, false) + ":0 ";
             outp += getPortName(pair.first, false) + ":0 ";
@@ -358,8 +366,8 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
     }
 
     // Lana 07.03.19. Printing out operation type of operators
-    if (B.type == OPERATOR and not B.operation.empty()) {
-        s << ", op = \"" << B.operation << "\"";
+    if (B.type == OPERATOR and not BI.operation.empty()) {
+        s << ", op = \"" << BI.operation << "\"";
     }
 
     if (not delay.str().empty()) {
@@ -375,16 +383,16 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
     }
 
 
-    if (B.type == OPERATOR and (B.operation == "getelementptr_op")) {
+    if (B.type == OPERATOR and (BI.operation == "getelementptr_op")) {
         s << ", constants=" << getGetPtrConst(b);
     }
 
     s << ", bbID = " << getBasicBlock(b);
     // Lana 02/07/19
-    if (B.type == OPERATOR and (B.operation == "mc_load_op" 
-        || B.operation == "mc_store_op" 
-        || B.operation == "lsq_load_op"
-        || B.operation == "lsq_store_op")) {
+    if (B.type == OPERATOR and (BI.operation == "mc_load_op" 
+        || BI.operation == "mc_store_op" 
+        || BI.operation == "lsq_load_op"
+        || BI.operation == "lsq_store_op")) {
         
         //s << ", bbID = " << getBasicBlock(b);
         s << ", portID = " << getMemPortID(b);
@@ -392,7 +400,7 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
 
     }
 
-    if (B.type == OPERATOR and (B.operation == "call_op")) {
+    if (B.type == OPERATOR and (BI.operation == "call_op")) {
         
         s << ", function = \"" << getFuncName(b) << "\"";
 
@@ -427,15 +435,15 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
 
      // AYA: 05/08/2023: added the following to forward information about components that need to be tagged
     s << ", tagged=";
-    if(B.is_tagged)
+    if(BI.is_tagged)
         s << "true";
     else
         s << "false";
     // AYA: 26/12/2023:
     s << ", taggers_num=";
-    s << to_string(B.taggers_num);
+    s << to_string(BI.taggers_num);
     s << ", tagger_id=";
-    s << to_string(B.tagger_id);
+    s << to_string(BI.tagger_id);
     //////////////////////////////////////////
 
     if (B.type == ELASTIC_BUFFER) {
@@ -477,12 +485,15 @@ void DFnetlist_Impl::writeBlockDot(ostream& s, blockID b)
 
     s << ", " << blockShapes[getBlockType(b)];
 
+    auto heat = dotBlockColor.find(b);
+    if (heat != dotBlockColor.end()) s << ", style=filled, fillcolor=\"" << heat->second << "\"";
+
     // Special color for control blocks
    // if (B.type != ELASTIC_BUFFER and num_control > num_noncontrol) s << ", color=green, fillcolor=greenyellow";
 
     if (B.type == SELECTOR) {
         s << ", orderings=\"";
-        for (auto mappings : B.orderings) {
+        for (auto mappings : BI.orderings) {
             for (auto index_it = mappings.second.begin();
                     index_it != mappings.second.end(); ++index_it) {
                 if (index_it != (mappings.second.end() - 1)) {
@@ -527,7 +538,9 @@ void DFnetlist_Impl::writeChannelDot(ostream& s, channelID id)
     	color = "blue";
     else 
         color = "darkgreen";
-    s << ", color=" << color;
+    auto heat = dotChannelColor.find(id);
+    if (heat != dotChannelColor.end()) s << ", color=\"" << heat->second << "\", penwidth=2";
+    else s << ", color=" << color;
 
     // Is is a back-edge inside a basic block (branch->merge)? Do not constrain
 
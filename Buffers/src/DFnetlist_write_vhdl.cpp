@@ -0,0 +1,46 @@
+#include <sstream>
+#include "DFnetlist.h"
+#include "libdot2vhdl.h"
+
+using namespace Dataflow;
+using namespace std;
+
+/*
+ * The VHDL is written by dot2vhdl, linked as a library. Instead of writing the
+ * dot file and running dot2vhdl on it, the blocks and the channels are given in
+ * memory, with the attributes and in the order of writeDot, so that the VHDL is
+ * the same as the one of the dot file.
+ */
+
+bool DFnetlist_Impl::writeVhdl(const string& filename)
+{
+    NETLIST_VIEW_T netlist;
+
+    // The attributes of a block are the ones between the brackets of its line in the dot file
+    auto addBlock = [&](blockID b) {
+        ostringstream line;
+        writeBlockDot(line, b);
+        const string& s = line.str();
+        size_t open = s.find('[');
+        size_t close = s.rfind("];");
+        netlist.blocks.push_back({getBlockName(b), s.substr(open + 1, close - open - 1)});
+    };
+
+    // Blocks by basic block, then the ones without a basic block (as in writeDot)
+    for (bbID bb = 1; bb <= BBG.numBasicBlocks(); bb++) {
+        ForAllBlocks(b) {
+            if (getBasicBlock(b) == bb) addBlock(b);
+        }
+    }
+    ForAllBlocks(b) {
+        bbID bb = getBasicBlock(b);
+        if (bb == 0 or bb > BBG.numBasicBlocks()) addBlock(b);
+    }
+
+    ForAllChannels(c) {
+        netlist.channels.push_back({getBlockName(getSrcBlock(c)), getBlockName(getDstBlock(c)),
+                                    getPortName(getSrcPort(c), false), getPortName(getDstPort(c), false)});
+    }
+
+    return dot2vhdl_generate_netlist(netlist, filename) == 0;
+}
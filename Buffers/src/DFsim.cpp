@@ -0,0 +1,1216 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "DFnetlist.h"
+#include "DFsim.h"
+
+using namespace Dataflow;
+using namespace std;
+
+extern int N_tags;      // Defined in DFnetlist_buffers.cpp (tag-info file)
+
+/*
+ * Operations of the operators. The names are the ones of the "op" attribute
+ * of the dot files without the "_op" suffix.
+ */
+namespace {
+
+const map<string, int> opCodes = {
+    {"add", DFsim::OP_ADD}, {"sub", DFsim::OP_SUB}, {"mul", DFsim::OP_MUL},
+    {"udiv", DFsim::OP_UDIV}, {"sdiv", DFsim::OP_SDIV}, {"urem", DFsim::OP_UREM},
+    {"srem", DFsim::OP_SREM}, {"shl", DFsim::OP_SHL}, {"lshr", DFsim::OP_LSHR},
+    {"ashr", DFsim::OP_ASHR}, {"and", DFsim::OP_AND}, {"or", DFsim::OP_OR}, {"xor", DFsim::OP_XOR},
+    {"icmp_eq", DFsim::OP_ICMP_EQ}, {"icmp_ne", DFsim::OP_ICMP_NE},
+    {"icmp_ugt", DFsim::OP_ICMP_UGT}, {"icmp_uge", DFsim::OP_ICMP_UGE},
+    {"icmp_ult", DFsim::OP_ICMP_ULT}, {"icmp_ule", DFsim::OP_ICMP_ULE},
+    {"icmp_sgt", DFsim::OP_ICMP_SGT}, {"icmp_sge", DFsim::OP_ICMP_SGE},
+    {"icmp_slt", DFsim::OP_ICMP_SLT}, {"icmp_sle", DFsim::OP_ICMP_SLE}, {"fadd", DFsim::OP_FADD},
+    {"fsub", DFsim::OP_FSUB}, {"fmul", DFsim::OP_FMUL}, {"fdiv", DFsim::OP_FDIV},
+    {"fneg", DFsim::OP_FNEG}, {"fcmp_oeq", DFsim::OP_FCMP_OEQ}, {"fcmp_one", DFsim::OP_FCMP_ONE},
+    {"fcmp_ogt", DFsim::OP_FCMP_OGT}, {"fcmp_oge", DFsim::OP_FCMP_OGE},
+    {"fcmp_olt", DFsim::OP_FCMP_OLT}, {"fcmp_ole", DFsim::OP_FCMP_OLE},
+    {"fcmp_ueq", DFsim::OP_FCMP_UEQ}, {"fcmp_une", DFsim::OP_FCMP_UNE},
+    {"fcmp_ugt", DFsim::OP_FCMP_UGT}, {"fcmp_uge", DFsim::OP_FCMP_UGE},
+    {"fcmp_ult", DFsim::OP_FCMP_ULT}, {"fcmp_ule", DFsim::OP_FCMP_ULE},
+    {"fcmp_ord", DFsim::OP_FCMP_ORD}, {"fcmp_uno", DFsim::OP_FCMP_UNO}, {"zext", DFsim::OP_ZEXT},
+    {"sext", DFsim::OP_SEXT}, {"trunc", DFsim::OP_TRUNC}, {"sitofp", DFsim::OP_SITOFP},
+    {"fptosi", DFsim::OP_FPTOSI}, {"select", DFsim::OP_SELECT}, {"getelementptr", DFsim::OP_GETPTR},
+    {"ret", DFsim::OP_RET}
+};
+
+uint64_t widthMask(int width)
+{
+    return width <= 0 ? 0 : (width >= 64 ? ~0ULL : (1ULL << width) - 1);
+}
+
+// Sign extension of a value with a given width
+int64_t toSigned(uint64_t v, int width)
+{
+    if (width <= 0 or width >= 64) return (int64_t) v;
+    uint64_t sign = 1ULL << (width - 1);
+    return (int64_t) ((v ^ sign) - sign);
+}
+
+// Floating-point values are stored as their bit patterns (float for widths up to 32)
+double toFloat(uint64_t v, int width)
+{
+    if (width > 32) {
+        double d;
+        memcpy(&d, &v, sizeof(d));
+        return d;
+    }
+    uint32_t w = (uint32_t) v;
+    float f;
+    memcpy(&f, &w, sizeof(f));
+    return f;
+}
+
+uint64_t fromFloat(double d, int width)
+{
+    if (width > 32) {
+        uint64_t v;
+        memcpy(&v, &d, sizeof(v));
+        return v;
+    }
+    float f = (float) d;
+    uint32_t w;
+    memcpy(&w, &f, sizeof(w));
+    return w;
+}
+
+// Integers in a string, e.g., the number of stores of each group of an LSQ ("{1;0;2}")
+vector<int> readIntegers(const string& s)
+{
+    vector<int> v;
+    string num;
+    for (char ch: s + ' ') {
+        if (isdigit(ch)) num += ch;
+        else if (not num.empty()) {
+            v.push_back(stoi(num));
+            num.clear();
+        }
+    }
+    return v;
+}
+
+// Integers of each group in a string, e.g., the load offsets of an LSQ ("{{0;1};{0;0}}")
+vector<vector<int>> readGroups(const string& s)
+{
+    vector<vector<int>> groups;
+    size_t begin = s.find('{');
+    if (begin == string::npos) return groups;
+    while ((begin = s.find('{', begin + 1)) != string::npos) {
+        size_t end = s.find('}', begin);
+        if (end == string::npos) break;
+        groups.push_back(readIntegers(s.substr(begin, end - begin)));
+        begin = end;
+    }
+    return groups;
+}
+
+}
+
+DFsim::DFsim(DFnetlist& DF)
+{
+    DFnetlist_Impl& DFI = *DF.DFI;
+    map<blockID, int> node_of;
+    map<channelID, int> chan_of;
+
+    for (channelID c: DFI.allChannels) {
+        Channel ch;
+        ch.src = ch.dst = -1;
+        ch.width = DFI.getPortWidth(DFI.getSrcPort(c));
+        ch.mask = widthMask(ch.width);
+        ch.valid = ch.ready = false;
+        ch.data = 0;
+        ch.transfers = 0;
+        ch.name = DFI.getChannelName(c);
+        ch.id = c;
+        chan_of[c] = channels.size();
+        channels.push_back(ch);
+    }
+
+    for (blockID b: DFI.allBlocks) {
+        Node n;
+        n.id = b;
+        n.name = DFI.getBlockName(b);
+        if (not buildNode(DFI, b, n)) return;
+        node_of[b] = nodes.size();
+
+        // Channels of the ports, in the order of the ports
+        auto chan = [&](portID p) {
+            channelID c = DFI.getConnectedChannel(p);
+            return c == invalidDataflowID ? -1 : chan_of[c];
+        };
+
+        vector<portID> ins, outs;
+        portID sel_in = invalidDataflowID, sel_out = invalidDataflowID;
+        portID true_out = invalidDataflowID, false_out = invalidDataflowID;
+        for (portID p: DFI.getPorts(b, INPUT_PORTS)) {
+            if (DFI.getPortType(p) == SELECTION_PORT and
+                (n.kind == NODE_MUX or n.kind == NODE_BRANCH or n.kind == NODE_ALIGNER_BRANCH)) sel_in = p;
+            else ins.push_back(p);
+        }
+        for (portID p: DFI.getPorts(b, OUTPUT_PORTS)) {
+            PortType t = DFI.getPortType(p);
+            if (n.kind == NODE_CMERGE and t == SELECTION_PORT) sel_out = p;
+            else if (n.kind == NODE_BRANCH and t == TRUE_PORT) true_out = p;
+            else if (n.kind == NODE_BRANCH and t == FALSE_PORT) false_out = p;
+            else outs.push_back(p);
+        }
+        if (n.kind == NODE_MUX or n.kind == NODE_BRANCH or n.kind == NODE_ALIGNER_BRANCH) {
+            if (sel_in == invalidDataflowID) {
+                error.set("Block " + n.name + ": no selection port.");
+                return;
+            }
+            ins.push_back(sel_in);
+        }
+        if (n.kind == NODE_BRANCH) {
+            if (true_out == invalidDataflowID or false_out == invalidDataflowID) {
+                error.set("Block " + n.name + ": true/false ports are missing.");
+                return;
+            }
+            outs = {true_out, false_out};
+        }
+        if (n.kind == NODE_CMERGE) outs.push_back(sel_out);
+
+        for (portID p: ins) {
+            n.in.push_back(chan(p));
+            n.inWidth.push_back(DFI.getPortWidth(p));
+            if (n.kind == NODE_EXIT) n.memEnd.push_back(DFI.getMemPortSuffix(p) == "*e");
+        }
+        for (portID p: outs) {
+            n.out.push_back(p == invalidDataflowID ? -1 : chan(p));
+            n.outWidth.push_back(p == invalidDataflowID ? 0 : DFI.getPortWidth(p));
+        }
+
+        if (n.kind == NODE_MEMORY) {
+            // Ports of the memory interface, identified by their suffix (*c, *lNa, *lNd, *sNa, *sNd, *e)
+            vector<int> numLoads = readIntegers(DFI.getNumLoads(b));
+            vector<int> numStores = readIntegers(DFI.getNumStores(b));
+            for (portID p: DFI.getPorts(b, ALL_PORTS)) {
+                const string& s = DFI.getMemPortSuffix(p);
+                int c = chan(p);
+                if (s.size() >= 2 and s[1] == 'c') {
+                    n.ctrlLoads.push_back(n.ctrl.size() < numLoads.size() ? numLoads[n.ctrl.size()] : 0);
+                    n.ctrlStores.push_back(n.ctrl.size() < numStores.size() ? numStores[n.ctrl.size()] : 0);
+                    n.ctrl.push_back(c);
+                } else if (s == "*e") n.endOut = c;
+                else if (s.size() >= 4 and (s[1] == 'l' or s[1] == 's')) {
+                    int idx = atoi(s.substr(2).c_str());
+                    char kind = s.back();
+                    vector<int>& v = s[1] == 'l' ? (kind == 'a' ? n.ldAddr : n.ldData)
+                                                 : (kind == 'a' ? n.stAddr : n.stData);
+                    if (v.size() <= idx) v.resize(idx + 1, -1);
+                    v[idx] = c;
+                } else {
+                    error.set("Block " + n.name + ": memory port " + DFI.getPortName(p) + " is not supported.");
+                    return;
+                }
+            }
+            if (n.lsq) {
+                n.ldPorts = readGroups(DFI.getLoadPorts(b));
+                n.ldOrder = readGroups(DFI.getLoadOffsets(b));
+                n.stPorts = readGroups(DFI.getStorePorts(b));
+                n.stOrder = readGroups(DFI.getStoreOffsets(b));
+                for (int g = 0; g < n.ctrl.size(); ++g) {
+                    if (g >= n.ldPorts.size() or g >= n.ldOrder.size() or n.ldPorts[g].size() < n.ctrlLoads[g] or
+                        n.ldOrder[g].size() < n.ctrlLoads[g] or g >= n.stPorts.size() or g >= n.stOrder.size() or
+                        n.stPorts[g].size() < n.ctrlStores[g] or n.stOrder[g].size() < n.ctrlStores[g]) {
+                        error.set("Block " + n.name + ": the ports and offsets of the groups of the LSQ are missing.");
+                        return;
+                    }
+                }
+            }
+            n.ldAddr.resize(max(n.ldAddr.size(), n.ldData.size()), -1);
+            n.ldData.resize(n.ldAddr.size(), -1);
+            n.stAddr.resize(max(n.stAddr.size(), n.stData.size()), -1);
+            n.stData.resize(n.stAddr.size(), -1);
+            n.memory = getMemoryIndex(DFI.getMemName(b));
+        }
+
+        nodes.push_back(n);
+    }
+
+    // Endpoints of the channels
+    for (channelID c: DFI.allChannels) {
+        Channel& ch = channels[chan_of[c]];
+        ch.src = node_of[DFI.getSrcBlock(c)];
+        ch.dst = node_of[DFI.getDstBlock(c)];
+    }
+
+    reset();
+}
+
+bool DFsim::buildNode(DFnetlist_Impl& DF, blockID b, Node& n)
+{
+    switch (DF.getBlockType(b)) {
+        case FUNC_ENTRY:
+            n.kind = NODE_ENTRY;
+            break;
+        case FUNC_EXIT:
+            n.kind = NODE_EXIT;
+            break;
+        case SOURCE:
+            n.kind = NODE_SOURCE;
+            break;
+        case SINK:
+            n.kind = NODE_SINK;
+            break;
+        case CONSTANT:
+            n.kind = NODE_CONSTANT;
+            n.value = DF.getValue(b);
+            break;
+        case FORK:
+            n.kind = NODE_FORK;
+            break;
+        case MERGE:
+            n.kind = NODE_MERGE;
+            break;
+        case CNTRL_MG:
+            n.kind = NODE_CMERGE;
+            break;
+        case MUX:
+            n.kind = NODE_MUX;
+            break;
+        case BRANCH:
+            n.kind = NODE_BRANCH;
+            break;
+        case ELASTIC_BUFFER:
+            n.kind = NODE_BUFFER;
+            n.slots = max(1, DF.getBufferSize(b));
+            n.transparent = DF.isBufferTransparent(b);
+            break;
+        case TAGGER:
+            n.kind = NODE_TAGGER;
+            break;
+        case UNTAGGER:
+            n.kind = NODE_UNTAGGER;
+            break;
+        case FREE_TAGS_FIFO:
+            n.kind = NODE_FREE_TAGS;
+            n.tags = max(1, N_tags);
+            n.transparent = true;
+            break;
+        case ALIGNER_BRANCH:
+            n.kind = NODE_ALIGNER_BRANCH;
+            break;
+        case ALIGNER_MUX:
+            n.kind = NODE_MUX;
+            n.aligner = true;
+            break;
+        case MC:
+        case LSQ:
+            n.kind = NODE_MEMORY;
+            n.lsq = DF.getBlockType(b) == LSQ;
+            break;
+        case OPERATOR: {
+            n.op = DF.getOperation(b);
+            n.latency = max(0, DF.getLatency(b));
+            n.II = max(1, DF.getInitiationInterval(b));
+            if (n.op == "mc_load_op" or n.op == "lsq_load_op") {
+                n.kind = NODE_LOAD;
+                break;
+            }
+            if (n.op == "mc_store_op" or n.op == "lsq_store_op") {
+                n.kind = NODE_STORE;
+                break;
+            }
+            n.kind = NODE_OPERATOR;
+            string name = n.op;
+            if (name.size() > 3 and name.substr(name.size() - 3) == "_op") name.resize(name.size() - 3);
+            auto it = opCodes.find(name);
+            if (it == opCodes.end()) {
+                error.set("Block " + n.name + ": operation " + n.op + " is not supported by the simulator.");
+                return false;
+            }
+            n.opcode = it->second;
+            if (n.opcode == OP_GETPTR) n.consts = DF.getGetPtrConst(b);
+            break;
+        }
+        default:
+            error.set("Block " + n.name + ": type " + DF.printBlockType(DF.getBlockType(b)) +
+                      " is not supported by the simulator.");
+            return false;
+    }
+    return true;
+}
+
+int DFsim::getMemoryIndex(const string& name)
+{
+    auto it = memoryIndex.find(name);
+    if (it != memoryIndex.end()) return it->second;
+    int idx = memories.size();
+    memoryIndex[name] = idx;
+    memories.emplace_back();
+    return idx;
+}
+
+bool DFsim::setArgument(const string& name, long long value)
+{
+    for (Node& n: nodes) {
+        if (n.kind != NODE_ENTRY or n.name != name) continue;
+        n.value = value;
+        return true;
+    }
+    return false;
+}
+
+bool DFsim::setBufferSlots(int n, int slots)
+{
+    Node& node = nodes[n];
+    if (node.kind != NODE_BUFFER or slots < 0 or (slots == 0 and not node.transparent)) return false;
+    node.slots = slots;
+    reset();
+    return true;
+}
+
+bool DFsim::setTags(int tags)
+{
+    if (tags < 1 or tags >= (1 << tagBits)) return false;
+    bool found = false;
+    for (Node& n: nodes) {
+        if (n.kind != NODE_FREE_TAGS) continue;
+        n.tags = tags;
+        found = true;
+    }
+    if (found) reset();
+    return found;
+}
+
+bool DFsim::isTagged() const
+{
+    for (const Node& n: nodes) {
+        if (n.kind == NODE_TAGGER or n.kind == NODE_UNTAGGER or n.kind == NODE_FREE_TAGS or
+            n.kind == NODE_ALIGNER_BRANCH or n.aligner) return true;
+    }
+    return false;
+}
+
+bool DFsim::hasLSQ() const
+{
+    for (const Node& n: nodes) {
+        if (n.kind == NODE_MEMORY and n.lsq) return true;
+    }
+    return false;
+}
+
+void DFsim::setMemory(const string& name, const vector<uint64_t>& contents)
+{
+    memories[getMemoryIndex(name)] = contents;
+}
+
+const vector<uint64_t>& DFsim::getMemory(const string& name) const
+{
+    static const vector<uint64_t> empty;
+    auto it = memoryIndex.find(name);
+    return it == memoryIndex.end() ? empty : memories[it->second];
+}
+
+vector<string> DFsim::getMemoryNames() const
+{
+    vector<string> names;
+    for (const auto& m: memoryIndex) names.push_back(m.first);
+    return names;
+}
+
+bool DFsim::readMemories(const string& filename)
+{
+    ifstream f(filename);
+    if (not f.is_open()) {
+        error.set("File " + filename + " could not be opened.");
+        return false;
+    }
+
+    string line;
+    while (getline(f, line)) {
+        istringstream iss(line);
+        string name, word;
+        if (not (iss >> name) or name[0] == '#') continue;
+        vector<uint64_t> contents;
+        while (iss >> word) {
+            if (word.find('.') != string::npos) contents.push_back(fromFloat(atof(word.c_str()), 32));
+            else contents.push_back((uint64_t) strtoll(word.c_str(), nullptr, 0));
+        }
+        setMemory(name, contents);
+    }
+    return true;
+}
+
+bool DFsim::writeMemories(const string& filename) const
+{
+    ofstream f(filename);
+    if (not f.is_open()) return false;
+    for (const auto& m: memoryIndex) {
+        f << m.first;
+        for (uint64_t w: memories[m.second]) f << ' ' << (int64_t) w;
+        f << endl;
+    }
+    return true;
+}
+
+void DFsim::reset()
+{
+    for (Channel& ch: channels) {
+        ch.valid = ch.ready = false;
+        ch.data = ch.tag = 0;
+        ch.transfers = ch.stalls = ch.starves = 0;
+        ch.lastTransfer = -1;
+        ch.gaps.clear();
+    }
+
+    for (Node& n: nodes) {
+        n.fires = 0;
+        n.occupancy.clear();
+        n.regs.clear();
+        n.regTags.clear();
+        n.full.clear();
+        n.head = n.count = 0;
+        n.done = false;
+        n.reg = n.regTag = 0;
+        n.tagQueue.clear();
+        n.regIdx = 0;
+        n.sel = -1;
+        n.lastFire = -1;
+        n.pendingStores = n.pendingLoads = 0;
+        n.peakLoads = n.peakStores = 0;
+        n.ldQueue.clear();
+        n.stQueue.clear();
+        n.allocated = 0;
+        switch (n.kind) {
+            case NODE_BUFFER:
+                n.regs.assign(n.slots, 0);
+                n.regTags.assign(n.slots, 0);
+                break;
+            case NODE_FREE_TAGS:
+                // Fifo of depth N_tags + 1 (as in dot2vhdl) holding the tags 0..N_tags-1
+                n.slots = n.tags + 1;
+                n.regs.assign(n.slots, 0);
+                n.regTags.assign(n.slots, 0);
+                for (int t = 0; t < n.tags; ++t) n.regs[t] = t;
+                n.count = n.tags;
+                break;
+            case NODE_OPERATOR:
+                n.regs.assign(n.latency, 0);
+                n.regTags.assign(n.latency, 0);
+                n.full.assign(n.latency, false);
+                break;
+            case NODE_FORK:
+            case NODE_CMERGE:
+            case NODE_TAGGER:
+                n.full.assign(n.out.size(), false);
+                break;
+            case NODE_MEMORY:
+                n.ldValid.assign(n.ldAddr.size(), false);
+                n.ldValue.assign(n.ldAddr.size(), 0);
+                break;
+            default:
+                break;
+        }
+    }
+
+    worklist.clear();
+    inWorklist.assign(nodes.size(), false);
+    status = RUNNING;
+    cycle = 0;
+    retValue = 0;
+    hasRet = false;
+}
+
+void DFsim::schedule(int n)
+{
+    if (n < 0 or inWorklist[n]) return;
+    inWorklist[n] = true;
+    if (partitioned) partitions[nodes[n].part].worklist.push_back(n);
+    else worklist.push_back(n);
+}
+
+void DFsim::setOut(int c, bool v, uint64_t d, uint64_t t)
+{
+    if (c < 0) return;
+    Channel& ch = channels[c];
+    d = v ? d & ch.mask : 0;
+    if (not v) t = 0;
+    if (ch.valid == v and ch.data == d and ch.tag == t) return;
+    ch.valid = v;
+    ch.data = d;
+    ch.tag = t;
+    if (not ch.cut) schedule(ch.dst);
+}
+
+void DFsim::setReady(int c, bool r)
+{
+    if (c < 0) return;
+    Channel& ch = channels[c];
+    if (ch.cut) {
+        // Exchanged with the source partition at the end of the round
+        ch.nextReady = r;
+        return;
+    }
+    if (ch.ready == r) return;
+    ch.ready = r;
+    schedule(ch.src);
+}
+
+// Tag of the output of merges: the tag of the condition for muxes (as mux_tagged), else the one of the input
+uint64_t DFsim::selectedTag(const Node& n) const
+{
+    if (n.sel < 0) return 0;
+    return tag(n.kind == NODE_MUX ? n.in.back() : n.in[n.sel]);
+}
+
+uint64_t DFsim::compute(const Node& n) const
+{
+    auto in = [&](int i) { return data(n.in[i]); };
+    auto sin = [&](int i) { return toSigned(data(n.in[i]), n.inWidth[i]); };
+    auto fin = [&](int i) { return toFloat(data(n.in[i]), n.inWidth[i]); };
+    int w = n.outWidth.empty() ? 0 : n.outWidth[0];
+    int s = n.in.size() > 1 ? (int) (in(1) & 63) : 0;
+
+    switch (n.opcode) {
+        case OP_ADD: return in(0) + in(1);
+        case OP_SUB: return in(0) - in(1);
+        case OP_MUL: return in(0) * in(1);
+        case OP_UDIV: return in(1) == 0 ? 0 : in(0) / in(1);
+        case OP_SDIV: return sin(1) == 0 ? 0 : (uint64_t) (sin(0) / sin(1));
+        case OP_UREM: return in(1) == 0 ? 0 : in(0) % in(1);
+        case OP_SREM: return sin(1) == 0 ? 0 : (uint64_t) (sin(0) % sin(1));
+        case OP_SHL: return in(0) << s;
+        case OP_LSHR: return in(0) >> s;
+        case OP_ASHR: return (uint64_t) (sin(0) >> s);
+        case OP_AND: return in(0) & in(1);
+        case OP_OR: return in(0) | in(1);
+        case OP_XOR: return in(0) ^ in(1);
+        case OP_ICMP_EQ: return in(0) == in(1);
+        case OP_ICMP_NE: return in(0) != in(1);
+        case OP_ICMP_UGT: return in(0) > in(1);
+        case OP_ICMP_UGE: return in(0) >= in(1);
+        case OP_ICMP_ULT: return in(0) < in(1);
+        case OP_ICMP_ULE: return in(0) <= in(1);
+        case OP_ICMP_SGT: return sin(0) > sin(1);
+        case OP_ICMP_SGE: return sin(0) >= sin(1);
+        case OP_ICMP_SLT: return sin(0) < sin(1);
+        case OP_ICMP_SLE: return sin(0) <= sin(1);
+        case OP_FADD: return fromFloat(fin(0) + fin(1), w);
+        case OP_FSUB: return fromFloat(fin(0) - fin(1), w);
+        case OP_FMUL: return fromFloat(fin(0) * fin(1), w);
+        case OP_FDIV: return fromFloat(fin(0) / fin(1), w);
+        case OP_FNEG: return fromFloat(-fin(0), w);
+        case OP_FCMP_OEQ: return fin(0) == fin(1);
+        case OP_FCMP_ONE: return fin(0) < fin(1) or fin(0) > fin(1);
+        case OP_FCMP_OGT: return fin(0) > fin(1);
+        case OP_FCMP_OGE: return fin(0) >= fin(1);
+        case OP_FCMP_OLT: return fin(0) < fin(1);
+        case OP_FCMP_OLE: return fin(0) <= fin(1);
+        case OP_FCMP_UEQ: return not (fin(0) < fin(1) or fin(0) > fin(1));
+        case OP_FCMP_UNE: return not (fin(0) == fin(1));
+        case OP_FCMP_UGT: return not (fin(0) <= fin(1));
+        case OP_FCMP_UGE: return not (fin(0) < fin(1));
+        case OP_FCMP_ULT: return not (fin(0) >= fin(1));
+        case OP_FCMP_ULE: return not (fin(0) > fin(1));
+        case OP_FCMP_ORD: return not (std::isnan(fin(0)) or std::isnan(fin(1)));
+        case OP_FCMP_UNO: return std::isnan(fin(0)) or std::isnan(fin(1));
+        case OP_ZEXT: return in(0);
+        case OP_SEXT: return (uint64_t) sin(0);
+        case OP_TRUNC: return in(0);
+        case OP_SITOFP: return fromFloat((double) sin(0), w);
+        case OP_FPTOSI: return (uint64_t) (int64_t) fin(0);
+        case OP_SELECT: return (in(0) & 1) ? in(1) : in(2);
+        case OP_GETPTR: {
+            // [i][j][k] with dimensions [dimX][dimY][dimZ] -> i*dimY*dimZ + j*dimZ + k
+            int vars = n.in.size() - n.consts;
+            uint64_t addr = 0;
+            for (int i = 0; i < vars; ++i) {
+                uint64_t dims = 1;
+                for (int j = vars + i; j < (int) n.in.size(); ++j) dims *= in(j);
+                addr += in(i) * dims;
+            }
+            return addr;
+        }
+        case OP_RET: return in(0);
+    }
+    assert(false);
+    return 0;
+}
+
+void DFsim::evalNode(int idx)
+{
+    Node& n = nodes[idx];
+
+    switch (n.kind) {
+        case NODE_ENTRY:
+            for (int c: n.out) setOut(c, not n.done, n.value);
+            break;
+
+        case NODE_EXIT: {
+            // Join of the memory interfaces and any of the other inputs
+            bool mem = true, any = false;
+            for (int i = 0; i < n.in.size(); ++i) {
+                if (n.memEnd[i]) mem = mem and valid(n.in[i]);
+                else any = any or valid(n.in[i]);
+            }
+            for (int c: n.in) setReady(c, mem and any);
+            break;
+        }
+
+        case NODE_SOURCE:
+            for (int c: n.out) setOut(c, true, 0);
+            break;
+
+        case NODE_SINK:
+            for (int c: n.in) setReady(c, true);
+            break;
+
+        case NODE_CONSTANT:
+            setOut(n.out[0], valid(n.in[0]), n.value, tag(n.in[0]));
+            setReady(n.in[0], ready(n.out[0]));
+            break;
+
+        case NODE_FORK: {
+            // Eager fork: every output receives the token once
+            bool v = valid(n.in[0]);
+            bool r = true;
+            for (int i = 0; i < n.out.size(); ++i) {
+                setOut(n.out[i], v and not n.full[i], data(n.in[0]), tag(n.in[0]));
+                r = r and (n.full[i] or ready(n.out[i]));
+            }
+            setReady(n.in[0], r);
+            break;
+        }
+
+        case NODE_TAGGER: {
+            // Join of the free tag and the data, followed by an eager fork of the data.
+            // The free tag is pushed onto the tag of every output.
+            bool all = true;
+            for (int c: n.in) all = all and valid(c);
+            uint64_t free_tag = data(n.in[0]) & ((1ULL << tagBits) - 1);
+            bool r = all;
+            for (int i = 0; i < n.out.size(); ++i) {
+                int c = i + 1 < n.in.size() ? n.in[i + 1] : -1;
+                setOut(n.out[i], all and not n.full[i], data(c), (tag(c) << tagBits) | free_tag);
+                r = r and (n.full[i] or ready(n.out[i]));
+            }
+            for (int c: n.in) setReady(c, r);
+            break;
+        }
+
+        case NODE_UNTAGGER: {
+            // Join of the data. The tag is popped and sent to the free tags fifo (first output).
+            bool all = true;
+            for (int c: n.in) all = all and valid(c);
+            bool r = all;
+            for (int c: n.out) r = r and ready(c);
+            uint64_t t = tag(n.in.empty() ? -1 : n.in[0]);
+            setOut(n.out[0], all, t & ((1ULL << tagBits) - 1));
+            for (int i = 1; i < n.out.size(); ++i) {
+                int c = i - 1 < n.in.size() ? n.in[i - 1] : -1;
+                setOut(n.out[i], all, data(c), tag(c) >> tagBits);
+            }
+            for (int c: n.in) setReady(c, r);
+            break;
+        }
+
+        case NODE_OPERATOR: {
+            bool all = true;
+            for (int c: n.in) all = all and valid(c);
+            bool outs_ready = true;
+            for (int c: n.out) outs_ready = outs_ready and ready(c);
+            bool accept;
+            if (n.latency == 0) {
+                uint64_t d = all ? compute(n) : 0;
+                uint64_t t = n.in.empty() ? 0 : tag(n.in[0]);
+                for (int c: n.out) setOut(c, all, d, t);
+                accept = all and outs_ready;
+            } else {
+                // Pipeline of latency stages that stalls when the output is blocked
+                bool v = n.full[n.latency - 1];
+                for (int c: n.out) setOut(c, v, n.regs[n.latency - 1], n.regTags[n.latency - 1]);
+                bool ce = not v or outs_ready;
+                accept = all and ce and (n.lastFire < 0 or cycle - n.lastFire >= n.II);
+            }
+            for (int c: n.in) setReady(c, accept);
+            break;
+        }
+
+        case NODE_LOAD:
+            // in[0]: data from memory, in[1]: address; out[0]: data, out[1]: address to memory.
+            // The memory serves the addresses of a port in order: the tags wait in a queue.
+            setOut(n.out[0], valid(n.in[0]), data(n.in[0]), n.tagQueue.empty() ? 0 : n.tagQueue[0]);
+            setReady(n.in[0], ready(n.out[0]));
+            setOut(n.out[1], n.done, n.reg);
+            setReady(n.in[1], not n.done or ready(n.out[1]));
+            break;
+
+        case NODE_STORE: {
+            // in[0]: data, in[1]: address; out[0]: data to memory, out[1]: address to memory
+            bool all = true;
+            for (int c: n.in) all = all and valid(c);
+            bool r = all;
+            for (int i = 0; i < n.out.size(); ++i) {
+                setOut(n.out[i], all, i < 2 ? data(n.in[i]) : 0);
+                r = r and ready(n.out[i]);
+            }
+            for (int c: n.in) setReady(c, r);
+            break;
+        }
+
+        case NODE_MERGE:
+        case NODE_MUX:
+        case NODE_CMERGE: {
+            // Selection of the input, followed by a TEHB
+            int ndata = n.kind == NODE_MUX ? n.in.size() - 1 : n.in.size();
+            n.sel = -1;
+            if (n.kind == NODE_MUX) {
+                // Aligner mux: the input is selected by the tag of the condition
+                int s = n.in.back();
+                uint64_t idx = n.aligner ? tag(s) & ((1ULL << tagBits) - 1) : data(s);
+                if (valid(s) and idx < ndata and valid(n.in[idx])) n.sel = idx;
+            } else {
+                for (int i = 0; i < ndata and n.sel < 0; ++i)
+                    if (valid(n.in[i])) n.sel = i;
+            }
+
+            bool tehb_valid = n.done or n.sel >= 0;
+            uint64_t d = n.done ? n.reg : (n.sel >= 0 ? data(n.in[n.sel]) : 0);
+            uint64_t t = n.done ? n.regTag : selectedTag(n);
+            int index = n.done ? n.regIdx : n.sel;
+            bool tehb_ready = not n.done;
+
+            if (n.kind == NODE_CMERGE) {
+                // Eager fork of the data and the index
+                setOut(n.out[0], tehb_valid and not n.full[0], d, t);
+                setOut(n.out[1], tehb_valid and not n.full[1], index, t);
+            } else {
+                setOut(n.out[0], tehb_valid, d, t);
+            }
+
+            for (int i = 0; i < ndata; ++i) setReady(n.in[i], tehb_ready and i == n.sel);
+            if (n.kind == NODE_MUX) setReady(n.in.back(), tehb_ready and n.sel >= 0);
+            break;
+        }
+
+        case NODE_BRANCH: {
+            bool all = valid(n.in[0]) and valid(n.in[1]);
+            bool cond = data(n.in[1]) & 1;
+            int target = cond ? 0 : 1;
+            setOut(n.out[target], all, data(n.in[0]), tag(n.in[0]));
+            setOut(n.out[1 - target], false, 0);
+            bool r = all and ready(n.out[target]);
+            setReady(n.in[0], r);
+            setReady(n.in[1], r);
+            break;
+        }
+
+        case NODE_ALIGNER_BRANCH: {
+            // Output selected by the tag of the condition (one output per tag)
+            bool all = valid(n.in[0]) and valid(n.in[1]);
+            uint64_t target = tag(n.in[1]) & ((1ULL << tagBits) - 1);
+            for (int i = 0; i < n.out.size(); ++i) {
+                setOut(n.out[i], all and i == target, data(n.in[0]), tag(n.in[0]));
+            }
+            bool r = all and target < n.out.size() and ready(n.out[target]);
+            setReady(n.in[0], r);
+            setReady(n.in[1], r);
+            break;
+        }
+
+        case NODE_BUFFER:
+        case NODE_FREE_TAGS: {
+            int c_in = n.in[0], c_out = n.out[0];
+            if (n.count > 0) setOut(c_out, true, n.regs[n.head], n.regTags[n.head]);
+            else if (n.transparent) setOut(c_out, valid(c_in), data(c_in), tag(c_in));
+            else setOut(c_out, false, 0);
+            setReady(c_in, n.count < n.slots or ready(c_out));
+            break;
+        }
+
+        case NODE_MEMORY: {
+            if (n.lsq) {
+                evalLSQ(n);
+                break;
+            }
+            bool idle = true;
+            for (int c: n.ctrl) {
+                setReady(c, true);
+                idle = idle and not valid(c);
+            }
+            for (int i = 0; i < n.ldAddr.size(); ++i) {
+                setOut(n.ldData[i], n.ldValid[i], n.ldValue[i]);
+                setReady(n.ldAddr[i], not n.ldValid[i] or ready(n.ldData[i]));
+            }
+            for (int i = 0; i < n.stAddr.size(); ++i) {
+                bool all = valid(n.stAddr[i]) and valid(n.stData[i]);
+                setReady(n.stAddr[i], all);
+                setReady(n.stData[i], all);
+                idle = idle and not all;
+            }
+            setOut(n.endOut, idle and n.pendingStores == 0, 0);
+            break;
+        }
+    }
+}
+
+void DFsim::evalLSQ(Node& n)
+{
+    bool idle = true;
+    for (int c: n.ctrl) {
+        setReady(c, true);
+        idle = idle and not valid(c);
+    }
+    // Each port serves its accesses in program order
+    for (int i = 0; i < n.ldAddr.size(); ++i) {
+        const LSQEntry* first = nullptr;
+        bool free = false;
+        for (const LSQEntry& e: n.ldQueue) {
+            if (e.port != i) continue;
+            if (first == nullptr) first = &e;
+            if (not e.hasAddr) {
+                free = true;
+                break;
+            }
+        }
+        setOut(n.ldData[i], first != nullptr and first->hasData, first != nullptr ? first->data : 0);
+        setReady(n.ldAddr[i], free);
+    }
+    for (int i = 0; i < n.stAddr.size(); ++i) {
+        bool free_addr = false, free_data = false;
+        for (const LSQEntry& e: n.stQueue) {
+            if (e.port != i) continue;
+            free_addr = free_addr or not e.hasAddr;
+            free_data = free_data or not e.hasData;
+        }
+        setReady(n.stAddr[i], free_addr);
+        setReady(n.stData[i], free_data);
+        idle = idle and not valid(n.stAddr[i]) and not valid(n.stData[i]);
+    }
+    setOut(n.endOut, idle and n.stQueue.empty(), 0);
+}
+
+bool DFsim::evaluate()
+{
+    for (Channel& ch: channels) {
+        ch.valid = ch.ready = false;
+        ch.data = ch.tag = 0;
+    }
+
+    worklist.clear();
+    for (int n = nodes.size() - 1; n >= 0; --n) {
+        inWorklist[n] = true;
+        worklist.push_back(n);
+    }
+
+    // The number of evaluations is bounded to detect combinational loops that do not converge
+    long long max_evals = 64 * (long long) nodes.size() + 1024;
+    long long evals = 0;
+    while (not worklist.empty()) {
+        int n = worklist.back();
+        worklist.pop_back();
+        inWorklist[n] = false;
+        evalNode(n);
+        if (++evals > max_evals) {
+            error.set("Cycle " + to_string(cycle) + ": the combinational logic does not converge (node " +
+                      nodes[n].name + ").");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DFsim::clockNode(int idx)
+{
+    Node& n = nodes[idx];
+    bool active = false;    // Tokens in flight in the state of the node
+
+    switch (n.kind) {
+        case NODE_ENTRY:
+            for (int c: n.out) if (transfer(c)) n.done = true;
+            break;
+
+        case NODE_EXIT: {
+            bool fired = false;
+            for (int c: n.in) fired = fired or transfer(c);
+            if (not fired) break;
+            status = FINISHED;
+            for (int i = 0; i < n.in.size(); ++i) {
+                if (n.memEnd[i] or n.inWidth[i] == 0 or not valid(n.in[i])) continue;
+                retValue = data(n.in[i]);
+                hasRet = true;
+            }
+            break;
+        }
+
+        case NODE_FORK:
+        case NODE_TAGGER: {
+            if (transfer(n.in[0])) {
+                fill(n.full.begin(), n.full.end(), false);
+                break;
+            }
+            for (int i = 0; i < n.out.size(); ++i) {
+                if (transfer(n.out[i])) n.full[i] = true;
+            }
+            break;
+        }
+
+        case NODE_OPERATOR: {
+            bool fired = not n.in.empty() and transfer(n.in[0]);
+            if (fired) n.lastFire = cycle;
+            if (n.latency == 0) break;
+            bool ce = not n.full[n.latency - 1];
+            if (not ce) {
+                ce = true;
+                for (int c: n.out) ce = ce and ready(c);
+            }
+            if (not ce) break;
+            uint64_t d = fired ? compute(n) : 0;
+            for (int s = n.latency - 1; s > 0; --s) {
+                n.full[s] = n.full[s - 1];
+                n.regs[s] = n.regs[s - 1];
+                n.regTags[s] = n.regTags[s - 1];
+            }
+            n.full[0] = fired;
+            n.regs[0] = d;
+            n.regTags[0] = fired ? tag(n.in[0]) : 0;
+            for (char f: n.full) active = active or f;
+            break;
+        }
+
+        case NODE_LOAD:
+            if (transfer(n.out[0]) and not n.tagQueue.empty()) n.tagQueue.erase(n.tagQueue.begin());
+            if (transfer(n.out[1])) n.done = false;
+            if (transfer(n.in[1])) {
+                n.done = true;
+                n.reg = data(n.in[1]);
+                n.tagQueue.push_back(tag(n.in[1]));
+            }
+            break;
+
+        case NODE_MERGE:
+        case NODE_MUX:
+        case NODE_CMERGE: {
+            bool out_transfer;
+            if (n.kind == NODE_CMERGE) {
+                bool tehb_valid = n.done or n.sel >= 0;
+                bool fork_ready = (n.full[0] or ready(n.out[0])) and (n.full[1] or ready(n.out[1]));
+                out_transfer = tehb_valid and fork_ready;
+                for (int i = 0; i < 2; ++i) {
+                    if (out_transfer) n.full[i] = false;
+                    else if (transfer(n.out[i])) n.full[i] = true;
+                }
+            } else {
+                out_transfer = transfer(n.out[0]);
+            }
+
+            if (n.done) {
+                if (out_transfer) n.done = false;
+            } else if (n.sel >= 0 and not out_transfer) {
+                n.done = true;
+                n.reg = data(n.in[n.sel]);
+                n.regTag = selectedTag(n);
+                n.regIdx = n.sel;
+            }
+            break;
+        }
+
+        case NODE_BUFFER:
+        case NODE_FREE_TAGS: {
+            bool in_t = transfer(n.in[0]);
+            bool out_t = transfer(n.out[0]);
+            bool bypass = n.transparent and n.count == 0;
+            if (out_t and not bypass) {
+                n.head = (n.head + 1) % n.slots;
+                n.count--;
+            }
+            if (in_t and not (bypass and out_t)) {
+                n.regs[(n.head + n.count) % n.slots] = data(n.in[0]);
+                n.regTags[(n.head + n.count) % n.slots] = tag(n.in[0]);
+                n.count++;
+            }
+            break;
+        }
+
+        case NODE_MEMORY: {
+            if (n.lsq) {
+                clockLSQ(n);
+                break;
+            }
+            vector<uint64_t>& mem = memories[n.memory];
+            for (int i = 0; i < n.ctrl.size(); ++i) {
+                if (not transfer(n.ctrl[i])) continue;
+                n.pendingStores += (long long) data(n.ctrl[i]);
+            }
+            // Loads read the memory before the stores of the same cycle
+            for (int i = 0; i < n.ldAddr.size(); ++i) {
+                if (transfer(n.ldData[i])) n.ldValid[i] = false;
+                if (transfer(n.ldAddr[i])) {
+                    uint64_t addr = data(n.ldAddr[i]);
+                    n.ldValid[i] = true;
+                    n.ldValue[i] = addr < mem.size() ? mem[addr] : 0;
+                }
+            }
+            for (int i = 0; i < n.stAddr.size(); ++i) {
+                if (not transfer(n.stAddr[i])) continue;
+                uint64_t addr = data(n.stAddr[i]);
+                if (addr >= mem.size()) mem.resize(addr + 1, 0);
+                mem[addr] = data(n.stData[i]);
+                n.pendingStores--;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+    return active;
+}
+
+void DFsim::clockLSQ(Node& n)
+{
+    vector<uint64_t>& mem = memories[n.memory];
+    auto byOrder = [](const LSQEntry& a, const LSQEntry& b) { return a.order < b.order; };
+
+    // Allocation of the accesses of the groups, in program order
+    for (int g = 0; g < n.ctrl.size(); ++g) {
+        if (not transfer(n.ctrl[g])) continue;
+        long long base = n.allocated;
+        n.allocated += n.ctrlLoads[g] + n.ctrlStores[g];
+        size_t loads = n.ldQueue.size(), stores = n.stQueue.size();
+        for (int k = 0; k < n.ctrlLoads[g]; ++k) n.ldQueue.push_back({n.ldPorts[g][k], base + n.ldOrder[g][k]});
+        for (int k = 0; k < n.ctrlStores[g]; ++k) n.stQueue.push_back({n.stPorts[g][k], base + n.stOrder[g][k]});
+        sort(n.ldQueue.begin() + loads, n.ldQueue.end(), byOrder);
+        sort(n.stQueue.begin() + stores, n.stQueue.end(), byOrder);
+    }
+    n.peakLoads = max(n.peakLoads, (long long) n.ldQueue.size());
+    n.peakStores = max(n.peakStores, (long long) n.stQueue.size());
+
+    // Transfers of the ports, to the first access of the port waiting for them
+    auto firstOfPort = [](deque<LSQEntry>& queue, int port, bool LSQEntry::*known) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->port == port and (known == nullptr or not ((*it).*known))) return it;
+        }
+        return queue.end();
+    };
+    for (int i = 0; i < n.ldAddr.size(); ++i) {
+        if (transfer(n.ldData[i])) n.ldQueue.erase(firstOfPort(n.ldQueue, i, nullptr));
+        if (transfer(n.ldAddr[i])) {
+            auto it = firstOfPort(n.ldQueue, i, &LSQEntry::hasAddr);
+            it->hasAddr = true;
+            it->addr = data(n.ldAddr[i]);
+        }
+    }
+    for (int i = 0; i < n.stAddr.size(); ++i) {
+        if (transfer(n.stAddr[i])) {
+            auto it = firstOfPort(n.stQueue, i, &LSQEntry::hasAddr);
+            it->hasAddr = true;
+            it->addr = data(n.stAddr[i]);
+        }
+        if (transfer(n.stData[i])) {
+            auto it = firstOfPort(n.stQueue, i, &LSQEntry::hasData);
+            it->hasData = true;
+            it->data = data(n.stData[i]);
+        }
+    }
+
+    // The oldest store is written once the previous loads have been served
+    if (not n.stQueue.empty() and n.stQueue.front().hasAddr and n.stQueue.front().hasData) {
+        const LSQEntry& st = n.stQueue.front();
+        bool ordered = true;
+        for (const LSQEntry& ld: n.ldQueue) ordered = ordered and (ld.order > st.order or ld.hasData);
+        if (ordered) {
+            if (st.addr >= mem.size()) mem.resize(st.addr + 1, 0);
+            mem[st.addr] = st.data;
+            n.stQueue.pop_front();
+        }
+    }
+
+    // Loads are served once the addresses of the previous stores are known,
+    // with the data of the last previous store to the same address
+    for (LSQEntry& ld: n.ldQueue) {
+        if (not ld.hasAddr or ld.hasData) continue;
+        const LSQEntry* dep = nullptr;
+        bool ready = true;
+        for (const LSQEntry& st: n.stQueue) {
+            if (st.order > ld.order) break;
+            if (not st.hasAddr) ready = false;
+            else if (st.addr == ld.addr) dep = &st;
+        }
+        if (not ready or (dep != nullptr and not dep->hasData)) continue;
+        ld.hasData = true;
+        ld.data = dep != nullptr ? dep->data : ld.addr < mem.size() ? mem[ld.addr] : 0;
+    }
+
+    n.pendingLoads = n.ldQueue.size();
+    n.pendingStores = n.stQueue.size();
+}
+
+DFsim::Status DFsim::step()
+{
+    if (status != RUNNING) return status;
+
+    if (not evaluate()) {
+        status = DEADLOCK;
+        return status;
+    }
+
+    activity = false;
+    for (int c = 0; c < channels.size(); ++c) {
+        Channel& ch = channels[c];
+        if (not countChannel(ch, cycle)) continue;
+        activity = true;
+        if (trace) trace->record(cycle, c, ch.data);
+    }
+
+    // Operators waiting for the initiation interval make progress without transfers
+    for (const Node& n: nodes) {
+        if (n.kind == NODE_OPERATOR and n.II > 1 and n.lastFire >= 0 and cycle - n.lastFire < n.II) activity = true;
+    }
+
+    for (int n = 0; n < nodes.size(); ++n) {
+        countNode(nodes[n]);
+        if (clockNode(n)) activity = true;
+    }
+    cycle++;
+
+    if (status == RUNNING and not activity) status = DEADLOCK;
+    return status;
+}
+
+DFsim::Status DFsim::run(long long max_cycles)
+{
+    if (partitions.size() > 1 and not trace) return runParallel(max_cycles);
+
+    while (status == RUNNING) {
+        if (cycle >= max_cycles) {
+            status = CYCLE_LIMIT;
+            break;
+        }
+        step();
+    }
+    return status;
+}
+
+string DFsim::statusName(Status s)
+{
+    switch (s) {
+        case RUNNING: return "running";
+        case FINISHED: return "finished";
+        case DEADLOCK: return "deadlock";
+        case CYCLE_LIMIT: return "cycle limit";
+    }
+    return "unknown";
+}
+
+void DFsim::writeReport(ostream& os) const
+{
+    os << "Simulation status: " << statusName(status) << endl;
+    os << "Cycles: " << cycle << endl;
+    if (hasRet) os << "Return value: " << (int64_t) retValue << endl;
+
+    os << endl << "Tokens per channel:" << endl;
+    for (const Channel& ch: channels) {
+        double th = cycle == 0 ? 0 : (double) ch.transfers / cycle;
+        os << setw(10) << ch.transfers << "  " << fixed << setprecision(3) << th << "  " << ch.name << endl;
+    }
+}
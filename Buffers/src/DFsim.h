@@ -0,0 +1,425 @@
+#ifndef DFSIM_H
+#define DFSIM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Dataflow.h"
+#include "DFtrace.h"
+#include "ErrorManager.h"
+
+namespace Dataflow
+{
+
+/**
+ * @class DFsim
+ * @brief Cycle-accurate simulator of a (buffered) dataflow netlist.
+ *
+ * The netlist is flattened into nodes (one per block) and channels.
+ * Every cycle, the valid/ready/data signals of the channels are computed
+ * as the fixed point of the combinational behavior of the nodes, and then
+ * the state of the nodes is updated at the clock edge with the transfers
+ * of the cycle (valid and ready). The behavior of each node follows the
+ * VHDL component library (components/elastic_components.vhd) at the level
+ * of handshakes: merges, muxes and control merges have an internal TEHB,
+ * pipelined operators stall when their output is blocked, etc.
+ *
+ * Memory controllers (MC) and LSQs share a flat word-addressed memory per
+ * memory name. Loads take one cycle in the controller. The LSQs allocate
+ * the accesses of a group (basic block) in program order when its control
+ * token arrives (loadOffsets/storeOffsets of the dot). A load is served once
+ * the addresses of the previous stores are known, with the data of the last
+ * previous store to the same address (or from the memory), and the stores
+ * are written in program order once the previous loads have been served.
+ * The queues are unbounded: their peak occupancy gives their depth.
+ *
+ * Out-of-order (tagged) circuits: the tag of a token travels with its data.
+ * A tagger pushes a free tag onto the tag of its tokens and the untagger pops
+ * it and returns it to the free tags fifo, which holds the tag-info N_tags
+ * tags (0..N_tags-1) at reset. Aligner branches route their data by the tag
+ * of the condition token and aligner muxes select the input given by the tag
+ * of the condition token, restoring the order of the tokens. The other
+ * components propagate the tag of their (selected) input, as their tagged
+ * versions of the VHDL library. Nested taggers are supported up to four levels.
+ */
+class DFsim
+{
+public:
+
+    /// Kinds of simulated nodes
+    enum NodeKind {NODE_ENTRY, NODE_EXIT, NODE_SOURCE, NODE_SINK, NODE_CONSTANT, NODE_FORK,
+                   NODE_OPERATOR, NODE_LOAD, NODE_STORE, NODE_MERGE, NODE_CMERGE, NODE_MUX,
+                   NODE_BRANCH, NODE_BUFFER, NODE_MEMORY,
+                   NODE_TAGGER, NODE_UNTAGGER, NODE_FREE_TAGS, NODE_ALIGNER_BRANCH};
+
+    /// Bits of the tag of each level of tagging (the tag of the innermost tagger is the lowest field)
+    static const int tagBits = 16;
+
+    /// Access allocated in the queues of an LSQ
+    struct LSQEntry {
+        int port;                   // Load or store port
+        long long order;            // Position in program order
+        bool hasAddr = false;
+        bool hasData = false;       // Data of the store, or value read by the load
+        uint64_t addr = 0, data = 0;
+    };
+
+    /// Status of the simulation
+    enum Status {RUNNING, FINISHED, DEADLOCK, CYCLE_LIMIT};
+
+    /// Operations of the operators
+    enum OpCode {OP_ADD, OP_SUB, OP_MUL, OP_UDIV, OP_SDIV, OP_UREM, OP_SREM,
+                 OP_SHL, OP_LSHR, OP_ASHR, OP_AND, OP_OR, OP_XOR,
+                 OP_ICMP_EQ, OP_ICMP_NE, OP_ICMP_UGT, OP_ICMP_UGE, OP_ICMP_ULT, OP_ICMP_ULE,
+                 OP_ICMP_SGT, OP_ICMP_SGE, OP_ICMP_SLT, OP_ICMP_SLE,
+                 OP_FADD, OP_FSUB, OP_FMUL, OP_FDIV, OP_FNEG,
+                 OP_FCMP_OEQ, OP_FCMP_ONE, OP_FCMP_OGT, OP_FCMP_OGE, OP_FCMP_OLT, OP_FCMP_OLE,
+                 OP_FCMP_UEQ, OP_FCMP_UNE, OP_FCMP_UGT, OP_FCMP_UGE, OP_FCMP_ULT, OP_FCMP_ULE,
+                 OP_FCMP_ORD, OP_FCMP_UNO,
+                 OP_ZEXT, OP_SEXT, OP_TRUNC, OP_SITOFP, OP_FPTOSI,
+                 OP_SELECT, OP_GETPTR, OP_RET};
+
+    struct Channel {
+        int src, dst;           // Source and destination nodes
+        int width;              // Width of the data (0: control)
+        uint64_t mask;          // Mask for the data
+        bool valid, ready;      // Handshake signals of the current cycle
+        uint64_t data;          // Data of the current cycle
+        uint64_t tag = 0;       // Tag of the current cycle (tagged circuits)
+        long long transfers;    // Number of tokens transferred
+        std::string name;       // Name of the channel (src:port -> dst:port)
+        channelID id;           // Channel of the netlist
+        long long stalls = 0;   // Cycles with valid and without ready (back pressure)
+        long long starves = 0;  // Cycles with ready and without valid
+        bool watched = false;   // Record the cycles between transfers (gaps)
+        long long lastTransfer = -1;
+        std::vector<long long> gaps;    // Histogram of the cycles between consecutive transfers
+        bool cut = false;       // Between two partitions (parallel simulation)
+        bool nextReady = false; // Ready of a cut channel computed by the destination partition
+    };
+
+    struct Node {
+        NodeKind kind;
+        blockID id;                 // Block of the netlist
+        std::string name;
+        std::string op;             // Operation (operators)
+        int opcode = 0;             // Decoded operation (operators)
+        std::vector<int> in, out;   // Channels of the ports (-1 if unconnected).
+                                    // Mux/branch: the selection port is the last input.
+                                    // Branch: true output first. Cmerge: index output last.
+                                    // Tagger: free tag first. Untagger: freed tag first.
+                                    // Aligner branch: condition last, one output per tag.
+        std::vector<int> inWidth, outWidth;
+        int latency = 0;            // Operators
+        int II = 1;                 // Operators
+        int slots = 0;              // Buffers
+        bool transparent = false;   // Buffers
+        uint64_t value = 0;         // Constants and entries
+        int consts = 0;             // Constant inputs of getelementptr
+        bool aligner = false;       // Mux: aligner mux (selects by the tag of the condition)
+        int tags = 0;               // Free tags fifo: number of tags
+
+        // State
+        std::vector<uint64_t> regs; // Fifo of buffers and pipeline of operators
+        std::vector<uint64_t> regTags;  // Tags of regs
+        std::vector<char> full;     // Valid bits of regs (pipelines), sent flags (forks)
+        int head = 0, count = 0;    // Fifo of buffers
+        bool done = false;          // Entry: token sent. TEHB of merges: full
+        uint64_t reg = 0;           // TEHB of merges, address register of loads
+        uint64_t regTag = 0;        // Tag of reg
+        std::vector<uint64_t> tagQueue; // Loads: tags of the accesses in flight
+        int regIdx = 0;             // TEHB of control merges: index
+        int sel = -1;               // Input selected by merges in the last evaluation
+        long long lastFire = -1;    // Cycle of the last input transfer (II)
+
+        // Memory interfaces (MEMORY nodes)
+        int memory = -1;                    // Index of the memory
+        bool lsq = false;
+        std::vector<int> ctrl, ldAddr, ldData, stAddr, stData;
+        std::vector<int> ctrlLoads;         // LSQ: number of loads of each group
+        std::vector<int> ctrlStores;        // LSQ: number of stores of each group
+        std::vector<std::vector<int>> ldPorts, stPorts;     // LSQ: ports of the accesses of each group
+        std::vector<std::vector<int>> ldOrder, stOrder;     // LSQ: position of the accesses in their group
+        std::deque<LSQEntry> ldQueue, stQueue;              // LSQ: allocated accesses in program order
+        long long allocated = 0;            // LSQ: accesses allocated
+        std::vector<char> ldValid;
+        std::vector<uint64_t> ldValue;
+        int endOut = -1;
+        long long pendingStores = 0;
+        long long pendingLoads = 0;         // LSQ: entries of the load queue
+        long long peakLoads = 0, peakStores = 0;    // LSQ: maximum entries of the queues
+        std::vector<char> memEnd;           // Exit: inputs connected to memory interfaces
+
+        int part = 0;                       // Partition (parallel simulation)
+
+        // Statistics
+        long long fires = 0;                // Operators: cycles with an input transfer
+        std::vector<long long> occupancy;   // Buffers and memories: cycles with each number of tokens stored
+    };
+
+    /**
+     * @brief Constructor. It flattens the netlist. The elastic buffers of the
+     * netlist must have been instantiated (as in the _graph_buf.dot files).
+     * @param DF The dataflow netlist.
+     */
+    DFsim(DFnetlist& DF);
+
+    bool hasError() const { return error.exists(); }
+    const std::string& getError() const { return error.get(); }
+
+    /**
+     * @brief Sets the value of a function argument (entry block).
+     * @return False if there is no entry block with that name.
+     */
+    bool setArgument(const std::string& name, long long value);
+
+    /**
+     * @brief Changes the slots of a buffer and resets the state of the circuit.
+     * A transparent buffer without slots behaves as a wire.
+     * @param n The node of the buffer.
+     * @param slots The number of slots (at least one for opaque buffers).
+     * @return False if the node is not a buffer or the slots are not valid.
+     */
+    bool setBufferSlots(int n, int slots);
+
+    /**
+     * @brief Changes the number of tags of the free tags fifos (N_tags of the
+     * tag-info file) and resets the state of the circuit.
+     * @return False if the netlist has no free tags fifo or the number is not valid.
+     */
+    bool setTags(int tags);
+
+    /**
+     * @brief Returns whether the netlist has tagged components (taggers, untaggers, aligners).
+     */
+    bool isTagged() const;
+
+    /**
+     * @brief Returns whether the netlist has LSQs.
+     */
+    bool hasLSQ() const;
+
+    /**
+     * @brief Sets the initial contents of a memory (word addressed).
+     */
+    void setMemory(const std::string& name, const std::vector<uint64_t>& contents);
+
+    /**
+     * @brief Returns the contents of a memory (empty if it does not exist).
+     */
+    const std::vector<uint64_t>& getMemory(const std::string& name) const;
+
+    /**
+     * @brief Names of the memories accessed by the netlist.
+     */
+    std::vector<std::string> getMemoryNames() const;
+
+    /**
+     * @brief Reads the contents of memories from a file. Each line has
+     * the name of a memory followed by its words. Words with a decimal point
+     * are stored as single-precision floats. Lines starting with # are ignored.
+     */
+    bool readMemories(const std::string& filename);
+
+    /**
+     * @brief Writes the contents of the memories with the format of readMemories.
+     */
+    bool writeMemories(const std::string& filename) const;
+
+    /**
+     * @brief Resets the state of the circuit and the statistics.
+     * The contents of the memories are not modified.
+     */
+    void reset();
+
+    /**
+     * @brief Simulates one cycle.
+     * @return The status after the cycle.
+     */
+    Status step();
+
+    /**
+     * @brief Simulates until the exit is reached, a deadlock is detected
+     * or the maximum number of cycles is reached. If the netlist has been
+     * partitioned (setThreads), the partitions are simulated in parallel.
+     * @param max_cycles Maximum number of cycles.
+     * @return The final status.
+     */
+    Status run(long long max_cycles);
+
+    /**
+     * @brief Partitions the netlist for the parallel simulation of run().
+     * The partitions are separated by channels whose valid and data only
+     * depend on the state of their source (opaque buffers, pipelined operators,
+     * entries, ...). The ready signals of the cut channels are
+     * exchanged between the partitions until the fixed point of the cycle,
+     * hence the results are the same as the ones of the sequential simulation.
+     * The interfaces of the same memory are never split.
+     * @param threads Number of threads (1: sequential simulation).
+     * @return The number of partitions (at most threads).
+     */
+    int setThreads(int threads);
+
+    int numPartitions() const { return std::max((int) partitions.size(), 1); }
+
+    Status getStatus() const { return status; }
+    long long getCycles() const { return cycle; }
+    uint64_t getReturnValue() const { return retValue; }
+    bool hasReturnValue() const { return hasRet; }
+
+    int numNodes() const { return nodes.size(); }
+    int numChannels() const { return channels.size(); }
+    const Node& getNode(int n) const { return nodes[n]; }
+    const Channel& getChannel(int c) const { return channels[c]; }
+
+    /**
+     * @brief Writes the summary of the simulation and the tokens transferred
+     * through each channel.
+     */
+    void writeReport(std::ostream& os) const;
+
+    static std::string statusName(Status s);
+
+    /**
+     * @brief Writes the bottlenecks of the simulation, ranked by the number of cycles:
+     * channels with valid and without ready (back pressure, the destination is
+     * the bottleneck), channels with ready and without valid (the destination starves),
+     * the utilization of the operators and the occupancy of the buffers and the
+     * memory interfaces (pending stores and loads in flight).
+     * @param os The output stream.
+     * @param top Maximum number of entries of each ranking (0: all).
+     */
+    void writeBottlenecks(std::ostream& os, int top = 20) const;
+
+    /**
+     * @brief Writes the netlist in dot format (as writeDot) with heat colors:
+     * the channels are colored by the fraction of cycles with back pressure
+     * and the blocks by their utilization (operators) or occupancy (buffers and memories).
+     * @param DF The netlist of the simulation.
+     * @param filename Name of the dot file.
+     * @return False if the file could not be written.
+     */
+    bool writeHeatDot(DFnetlist& DF, const std::string& filename) const;
+
+    /**
+     * @brief Records the histogram of the cycles between consecutive transfers
+     * of a channel (Channel::gaps), to measure its steady-state throughput.
+     */
+    void watchChannel(int c) { channels[c].watched = true; }
+
+    /**
+     * @brief Steady-state throughput of a watched channel: the inverse of the mean
+     * number of cycles between consecutive transfers. The gaps longer than four times
+     * the median are ignored (the channel was idle, e.g., between two executions of a loop).
+     * @return The throughput (0 if the channel had less than two transfers).
+     */
+    double steadyThroughput(int c) const;
+
+    /**
+     * @brief Records the transfers of the next cycles into a binary trace (see DFtrace.h),
+     * to be analyzed with the dftrace tool. The simulation is sequential while tracing.
+     * @param writer The writer of the trace (not owned by the simulator).
+     * @param filename Name of the trace file.
+     * @param with_data If asserted, the data of the transfers are recorded.
+     * @return False if the file could not be created.
+     */
+    bool startTrace(DFtraceWriter& writer, const std::string& filename, bool with_data);
+
+    /**
+     * @brief Stops recording the trace and closes it.
+     * @return False if some write of the trace failed.
+     */
+    bool stopTrace();
+
+    /**
+     * @brief Writes the depth of the queues of every LSQ required by the simulation.
+     * The queues of the simulated LSQs are unbounded: the entries of a group are
+     * allocated when its control token arrives and released when the load data is
+     * sent or the store is executed. The depth is the peak occupancy of the load and
+     * store queues, rounded up to a power of two (at least 2). One line per LSQ: <name> <depth>,
+     * preceded by comment lines (#) with the peaks.
+     * @param filename Name of the file (read by dot2vhdl -lsq_depths).
+     * @return False if the file could not be written.
+     */
+    bool writeLSQDepths(const std::string& filename) const;
+
+    /**
+     * @brief Writes a C++ program that simulates the netlist (compiled simulation).
+     * The program has the same options as the simulate command (-cycles, -args,
+     * -mem, -mem_out) and prints the same report as writeReport.
+     * @param filename Name of the C++ file.
+     * @return False if the netlist is tagged or has LSQs, or the file could
+     * not be written.
+     */
+    bool writeCompiled(const std::string& filename) const;
+
+private:
+    std::vector<Node> nodes;
+    std::vector<Channel> channels;
+    std::vector<std::vector<uint64_t>> memories;
+    std::map<std::string, int> memoryIndex;
+    ErrorMgr error;
+
+    Status status = RUNNING;
+    long long cycle = 0;
+    uint64_t retValue = 0;
+    bool hasRet = false;
+    bool activity = false;      // Some state changed in the last clock edge
+
+    DFtraceWriter* trace = nullptr;
+
+    std::vector<int> worklist;  // Nodes pending evaluation in the fixed point
+    std::vector<char> inWorklist;
+
+    // Parallel simulation
+    struct Partition {
+        std::vector<int> nodes;
+        std::vector<int> chans;         // Channels with the source in the partition
+        std::vector<int> cutIn, cutOut; // Cut channels entering and leaving the partition
+        std::vector<int> worklist;
+        bool changed[2];                // Some ready of a cut channel changed (by parity of the round)
+        bool failed[2];                 // The combinational logic does not converge
+        bool active[2];                 // Activity (by parity of the cycle)
+    };
+    struct Barrier;
+
+    std::vector<Partition> partitions;
+    bool partitioned = false;   // The parallel simulation is running
+
+    bool isStateOutput(int c) const;
+    void setStateOutput(int c);
+    Status runParallel(long long max_cycles);
+    void runPartition(int p, long long max_cycles, Barrier& barrier, Status& final_status,
+                      long long& final_cycle, std::string& final_error);
+
+    bool countChannel(Channel& ch, long long cyc);
+    void countNode(Node& n);
+
+    bool buildNode(DFnetlist_Impl& DF, blockID b, Node& n);
+    int getMemoryIndex(const std::string& name);
+
+    bool valid(int c) const { return c >= 0 and channels[c].valid; }
+    bool ready(int c) const { return c < 0 or channels[c].ready; }
+    bool transfer(int c) const { return c >= 0 and channels[c].valid and channels[c].ready; }
+    uint64_t data(int c) const { return c < 0 ? 0 : channels[c].data; }
+    uint64_t tag(int c) const { return c < 0 ? 0 : channels[c].tag; }
+    void setOut(int c, bool v, uint64_t d, uint64_t t = 0);
+    uint64_t selectedTag(const Node& n) const;
+    void setReady(int c, bool r);
+    void schedule(int n);
+
+    bool evaluate();
+    void evalNode(int n);
+    void evalLSQ(Node& n);
+    bool clockNode(int n);
+    void clockLSQ(Node& n);
+    uint64_t compute(const Node& n) const;
+};
+
+}
+
+#endif // DFSIM_H
@@ -0,0 +1,1010 @@
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include "DFsim.h"
+
+using namespace Dataflow;
+using namespace std;
+
+/*
+ * Compiled simulation. The netlist is translated into a C++ program that
+ * performs the same computation as DFsim::step() with no interpretation:
+ *
+ * - Every channel is a set of static variables (valid, ready, data and
+ *   transfers), with a data type of the width of the channel.
+ *
+ * - The combinational logic of each node is split into three tasks: S (outputs
+ *   that only depend on the state, e.g., opaque buffers and pipelines), C (outputs
+ *   that depend on the inputs) and B (ready signals of the inputs). The tasks are
+ *   statically scheduled in topological order, so that every signal is computed
+ *   once per cycle. The tasks in combinational cycles (if any) are iterated until
+ *   the fixed point at their position in the order.
+ *
+ * - The behavior of the nodes is inlined with all the parameters (slots,
+ *   latencies, constants, widths) replaced by their values.
+ *
+ * The program prints the same report as DFsim::writeReport.
+ */
+
+namespace {
+
+string cType(int width)
+{
+    if (width <= 8) return "uint8_t";
+    if (width <= 16) return "uint16_t";
+    if (width <= 32) return "uint32_t";
+    return "uint64_t";
+}
+
+string quote(const string& s)
+{
+    string q = "\"";
+    for (char ch: s) {
+        if (ch == '"' or ch == '\\') q += '\\';
+        q += ch;
+    }
+    return q + '"';
+}
+
+string join(const vector<string>& terms, const string& op, const string& empty)
+{
+    if (terms.empty()) return empty;
+    string s = terms[0];
+    for (int i = 1; i < terms.size(); ++i) s += " " + op + " " + terms[i];
+    return terms.size() == 1 ? s : "(" + s + ")";
+}
+
+/*
+ * Strongly connected components of the task graph (Tarjan, iterative), in
+ * topological order: the components of the dependences of a task come first.
+ * The tasks of a cyclic component are ordered as in a topological sort that
+ * breaks the cycles at the task with fewest pending dependences, so that the
+ * fixed point of the component converges in few iterations.
+ */
+vector<vector<int>> taskOrder(const vector<vector<int>>& deps)
+{
+    int T = deps.size();
+    vector<int> index(T, -1), low(T, 0), comp(T, -1);
+    vector<char> onStack(T, false);
+    vector<int> stack;
+    vector<vector<int>> sccs;
+    vector<pair<int, int>> call;     // (task, next dependence)
+    int counter = 0;
+
+    for (int root = 0; root < T; ++root) {
+        if (index[root] >= 0) continue;
+        call.push_back({root, 0});
+        while (not call.empty()) {
+            int t = call.back().first;
+            int& next = call.back().second;
+            if (next == 0) {
+                index[t] = low[t] = counter++;
+                stack.push_back(t);
+                onStack[t] = true;
+            }
+            if (next < deps[t].size()) {
+                int d = deps[t][next++];
+                if (index[d] < 0) call.push_back({d, 0});
+                else if (onStack[d]) low[t] = min(low[t], index[d]);
+                continue;
+            }
+            call.pop_back();
+            if (not call.empty()) low[call.back().first] = min(low[call.back().first], low[t]);
+            if (low[t] != index[t]) continue;
+            vector<int> scc;
+            int u;
+            do {
+                u = stack.back();
+                stack.pop_back();
+                onStack[u] = false;
+                comp[u] = sccs.size();
+                scc.push_back(u);
+            } while (u != t);
+            sccs.push_back(scc);
+        }
+    }
+
+    for (int k = 0; k < sccs.size(); ++k) {
+        vector<int>& scc = sccs[k];
+        if (scc.size() == 1) continue;
+        map<int, int> pending;
+        map<int, vector<int>> users;
+        for (int t: scc) {
+            pending[t] = 0;
+            for (int d: deps[t]) {
+                if (comp[d] != k) continue;
+                pending[t]++;
+                users[d].push_back(t);
+            }
+        }
+        vector<int> sorted;
+        while (sorted.size() < scc.size()) {
+            int best = -1;
+            for (int t: scc) {
+                if (pending[t] >= 0 and (best < 0 or pending[t] < pending[best])) best = t;
+            }
+            vector<int> ready = {best};
+            pending[best] = -1;
+            for (int i = 0; i < ready.size(); ++i) {
+                sorted.push_back(ready[i]);
+                for (int u: users[ready[i]]) {
+                    if (pending[u] > 0 and --pending[u] == 0) {
+                        pending[u] = -1;
+                        ready.push_back(u);
+                    }
+                }
+            }
+        }
+        scc = sorted;
+    }
+    return sccs;
+}
+
+/*
+ * Writes a sequence of blocks of code as functions of bounded size, since large functions are
+ * very slow to compile. The functions are not static, otherwise the compiler inlines them
+ * (they are called once) and the size is not bounded.
+ */
+int writeFunctions(ostream& os, const string& name, const string& type, const vector<string>& blocks,
+                   const string& ret)
+{
+    const int max_size = 8000;
+    int num = 0, size = max_size;
+    for (const string& b: blocks) {
+        if (size + b.size() > max_size and size > 0) {
+            if (num > 0) os << ret << "}\n\n";
+            os << type << " " << name << num++ << "()\n{\n";
+            size = 0;
+        }
+        os << b;
+        size += b.size();
+    }
+    if (num > 0) os << ret << "}\n\n";
+    return num;
+}
+
+// Functions shared by the interpreter (DFsim.cpp) and the generated program
+const char* prelude = R"(#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static inline int64_t sx(uint64_t v, int width)
+{
+    if (width <= 0 or width >= 64) return (int64_t) v;
+    uint64_t sign = 1ULL << (width - 1);
+    return (int64_t) ((v ^ sign) - sign);
+}
+
+static inline double fx(uint64_t v, int width)
+{
+    if (width > 32) {
+        double d;
+        memcpy(&d, &v, sizeof(d));
+        return d;
+    }
+    uint32_t w = (uint32_t) v;
+    float f;
+    memcpy(&f, &w, sizeof(f));
+    return f;
+}
+
+static inline uint64_t tf(double d, int width)
+{
+    if (width > 32) {
+        uint64_t v;
+        memcpy(&v, &d, sizeof(v));
+        return v;
+    }
+    float f = (float) d;
+    uint32_t w;
+    memcpy(&w, &f, sizeof(w));
+    return w;
+}
+
+)";
+
+}
+
+bool DFsim::writeCompiled(const string& filename) const
+{
+    // Tagged components and LSQs are only modeled by the interpreted simulation
+    if (isTagged() or hasLSQ()) return false;
+
+    ofstream os(filename);
+    if (not os.is_open()) return false;
+
+    int N = nodes.size();
+    int C = channels.size();
+
+    // Names of the signals
+    auto V = [&](int c) { return c < 0 ? string("false") : "v" + to_string(c); };
+    auto R = [&](int c) { return c < 0 ? string("true") : "r" + to_string(c); };
+    auto D = [&](int c) { return c < 0 ? string("(uint64_t) 0") : "(uint64_t) d" + to_string(c); };
+    auto T = [&](int c) { return c < 0 ? string("(false)") : "(v" + to_string(c) + " and r" + to_string(c) + ")"; };
+    auto S = [&](int n, const string& var) { return "n" + to_string(n) + "_" + var; };
+
+    auto setOut = [&](ostream& o, int c, const string& v, const string& d) {
+        if (c < 0) return;
+        const Channel& ch = channels[c];
+        o << "    v" << c << " = " << v << ";\n";
+        if (ch.width == 0) o << "    d" << c << " = 0;\n";
+        else {
+            string data = d;
+            if (ch.width != 8 and ch.width != 16 and ch.width != 32 and ch.width != 64)
+                data = "(" + d + ") & " + to_string(ch.mask) + "ULL";
+            o << "    d" << c << " = v" << c << " ? (" << cType(ch.width) << ") (" << data << ") : 0;\n";
+        }
+    };
+    auto setReady = [&](ostream& o, int c, const string& r) {
+        if (c >= 0) o << "    r" << c << " = " << r << ";\n";
+    };
+    // Same ready signal for several channels (joins)
+    auto setReadies = [&](ostream& o, const vector<int>& chans, const string& r) {
+        if (chans.size() <= 1) {
+            for (int c: chans) setReady(o, c, r);
+            return;
+        }
+        o << "    {\n    bool ready = " << r << ";\n";
+        for (int c: chans) if (c >= 0) o << "    r" << c << " = ready;\n";
+        o << "    }\n";
+    };
+    auto allValid = [&](const vector<int>& chans) {
+        vector<string> t;
+        for (int c: chans) t.push_back(V(c));
+        return join(t, "and", "true");
+    };
+    auto allReady = [&](const vector<int>& chans) {
+        vector<string> t;
+        for (int c: chans) t.push_back(R(c));
+        return join(t, "and", "true");
+    };
+
+    // Expression of an operation (same semantics as DFsim::compute)
+    auto opExpr = [&](const Node& n) {
+        auto in = [&](int i) { return D(n.in[i]); };
+        auto sin = [&](int i) { return "sx(" + D(n.in[i]) + ", " + to_string(n.inWidth[i]) + ")"; };
+        auto fin = [&](int i) { return "fx(" + D(n.in[i]) + ", " + to_string(n.inWidth[i]) + ")"; };
+        string w = to_string(n.outWidth.empty() ? 0 : n.outWidth[0]);
+        string s = n.in.size() > 1 ? "(int) (" + in(1) + " & 63)" : "0";
+        auto bin = [&](const string& op) { return "(" + in(0) + " " + op + " " + in(1) + ")"; };
+        auto sbin = [&](const string& op) { return "(uint64_t) (" + sin(0) + " " + op + " " + sin(1) + ")"; };
+        auto fbin = [&](const string& op) { return "(" + fin(0) + " " + op + " " + fin(1) + ")"; };
+        auto fop = [&](const string& op) { return "tf(" + fin(0) + " " + op + " " + fin(1) + ", " + w + ")"; };
+
+        switch (n.opcode) {
+            case OP_ADD: return bin("+");
+            case OP_SUB: return bin("-");
+            case OP_MUL: return bin("*");
+            case OP_UDIV: return "(" + in(1) + " == 0 ? 0 : " + bin("/") + ")";
+            case OP_SDIV: return "(" + sin(1) + " == 0 ? 0 : " + sbin("/") + ")";
+            case OP_UREM: return "(" + in(1) + " == 0 ? 0 : " + bin("%") + ")";
+            case OP_SREM: return "(" + sin(1) + " == 0 ? 0 : " + sbin("%") + ")";
+            case OP_SHL: return "(" + in(0) + " << " + s + ")";
+            case OP_LSHR: return "(" + in(0) + " >> " + s + ")";
+            case OP_ASHR: return "(uint64_t) (" + sin(0) + " >> " + s + ")";
+            case OP_AND: return bin("&");
+            case OP_OR: return bin("|");
+            case OP_XOR: return bin("^");
+            case OP_ICMP_EQ: return bin("==");
+            case OP_ICMP_NE: return bin("!=");
+            case OP_ICMP_UGT: return bin(">");
+            case OP_ICMP_UGE: return bin(">=");
+            case OP_ICMP_ULT: return bin("<");
+            case OP_ICMP_ULE: return bin("<=");
+            case OP_ICMP_SGT: return "(" + sin(0) + " > " + sin(1) + ")";
+            case OP_ICMP_SGE: return "(" + sin(0) + " >= " + sin(1) + ")";
+            case OP_ICMP_SLT: return "(" + sin(0) + " < " + sin(1) + ")";
+            case OP_ICMP_SLE: return "(" + sin(0) + " <= " + sin(1) + ")";
+            case OP_FADD: return fop("+");
+            case OP_FSUB: return fop("-");
+            case OP_FMUL: return fop("*");
+            case OP_FDIV: return fop("/");
+            case OP_FNEG: return "tf(-" + fin(0) + ", " + w + ")";
+            case OP_FCMP_OEQ: return fbin("==");
+            case OP_FCMP_ONE: return "(" + fbin("<") + " or " + fbin(">") + ")";
+            case OP_FCMP_OGT: return fbin(">");
+            case OP_FCMP_OGE: return fbin(">=");
+            case OP_FCMP_OLT: return fbin("<");
+            case OP_FCMP_OLE: return fbin("<=");
+            case OP_FCMP_UEQ: return "(not (" + fbin("<") + " or " + fbin(">") + "))";
+            case OP_FCMP_UNE: return "(not " + fbin("==") + ")";
+            case OP_FCMP_UGT: return "(not " + fbin("<=") + ")";
+            case OP_FCMP_UGE: return "(not " + fbin("<") + ")";
+            case OP_FCMP_ULT: return "(not " + fbin(">=") + ")";
+            case OP_FCMP_ULE: return "(not " + fbin(">") + ")";
+            case OP_FCMP_ORD: return "(not (std::isnan(" + fin(0) + ") or std::isnan(" + fin(1) + ")))";
+            case OP_FCMP_UNO: return "(std::isnan(" + fin(0) + ") or std::isnan(" + fin(1) + "))";
+            case OP_ZEXT: return in(0);
+            case OP_SEXT: return "(uint64_t) " + sin(0);
+            case OP_TRUNC: return in(0);
+            case OP_SITOFP: return "tf((double) " + sin(0) + ", " + w + ")";
+            case OP_FPTOSI: return "(uint64_t) (int64_t) " + fin(0);
+            case OP_SELECT: return "((" + in(0) + " & 1) ? " + in(1) + " : " + in(2) + ")";
+            case OP_GETPTR: {
+                int vars = n.in.size() - n.consts;
+                vector<string> terms;
+                for (int i = 0; i < vars; ++i) {
+                    string t = in(i);
+                    for (int j = vars + i; j < (int) n.in.size(); ++j) t += " * " + in(j);
+                    terms.push_back(t);
+                }
+                return join(terms, "+", "(uint64_t) 0");
+            }
+            case OP_RET: return in(0);
+        }
+        assert(false);
+        return string("0");
+    };
+
+    /*
+     * Tasks of the combinational logic: 3*n (S), 3*n+1 (C) and 3*n+2 (B).
+     * prod[c] is the task that computes the valid and data of channel c.
+     */
+    enum {TASK_S = 0, TASK_C = 1, TASK_B = 2};
+    vector<int> prod(C, -1);
+    for (int n = 0; n < N; ++n) {
+        const Node& nd = nodes[n];
+        auto task = [&](int c, bool state) { if (c >= 0) prod[c] = 3*n + (state ? TASK_S : TASK_C); };
+        switch (nd.kind) {
+            case NODE_ENTRY:
+            case NODE_SOURCE:
+                for (int c: nd.out) task(c, true);
+                break;
+            case NODE_OPERATOR:
+                for (int c: nd.out) task(c, nd.latency > 0);
+                break;
+            case NODE_LOAD:
+                task(nd.out[0], false);
+                task(nd.out[1], true);
+                break;
+            case NODE_BUFFER:
+                task(nd.out[0], not nd.transparent);
+                break;
+            case NODE_MEMORY:
+                for (int c: nd.ldData) task(c, true);
+                task(nd.endOut, false);
+                break;
+            default:
+                for (int c: nd.out) task(c, false);
+                break;
+        }
+    }
+
+    // Input channels of a node
+    auto inputs = [](const Node& nd) {
+        if (nd.kind != NODE_MEMORY) return nd.in;
+        vector<int> ins = nd.ctrl;
+        ins.insert(ins.end(), nd.ldAddr.begin(), nd.ldAddr.end());
+        ins.insert(ins.end(), nd.stAddr.begin(), nd.stAddr.end());
+        ins.insert(ins.end(), nd.stData.begin(), nd.stData.end());
+        return ins;
+    };
+
+    vector<vector<int>> deps(3*N);
+    for (int n = 0; n < N; ++n) {
+        const Node& nd = nodes[n];
+        vector<int> outs = nd.out;
+        if (nd.kind == NODE_MEMORY) {
+            outs = nd.ldData;
+            outs.push_back(nd.endOut);
+        }
+        for (int c: inputs(nd)) {
+            if (c < 0 or prod[c] < 0) continue;
+            deps[3*n + TASK_C].push_back(prod[c]);
+            deps[3*n + TASK_B].push_back(prod[c]);
+        }
+        for (int c: outs) {
+            if (c >= 0 and channels[c].dst >= 0) deps[3*n + TASK_B].push_back(3*channels[c].dst + TASK_B);
+        }
+        deps[3*n + TASK_B].push_back(3*n + TASK_C);
+    }
+
+    vector<vector<int>> order = taskOrder(deps);
+
+    // Code of a task
+    auto emitTask = [&](ostream& o, int t) {
+        int n = t / 3;
+        int kind = t % 3;
+        const Node& nd = nodes[n];
+        ostringstream code;
+
+        switch (nd.kind) {
+            case NODE_ENTRY:
+                if (kind == TASK_S) for (int c: nd.out) setOut(code, c, "not " + S(n, "done"), S(n, "value"));
+                break;
+
+            case NODE_EXIT:
+                if (kind == TASK_B) {
+                    vector<string> mem, any;
+                    for (int i = 0; i < nd.in.size(); ++i)
+                        (nd.memEnd[i] ? mem : any).push_back(V(nd.in[i]));
+                    string fire = join(mem, "and", "true") + " and " + join(any, "or", "false");
+                    setReadies(code, nd.in, fire);
+                }
+                break;
+
+            case NODE_SOURCE:
+                if (kind == TASK_S) for (int c: nd.out) setOut(code, c, "true", "0");
+                break;
+
+            case NODE_SINK:
+                if (kind == TASK_B) for (int c: nd.in) setReady(code, c, "true");
+                break;
+
+            case NODE_CONSTANT:
+                if (kind == TASK_C) setOut(code, nd.out[0], V(nd.in[0]), to_string(nd.value) + "ULL");
+                if (kind == TASK_B) setReady(code, nd.in[0], R(nd.out[0]));
+                break;
+
+            case NODE_FORK:
+                if (kind == TASK_C) {
+                    for (int i = 0; i < nd.out.size(); ++i)
+                        setOut(code, nd.out[i], V(nd.in[0]) + " and not " + S(n, "sent" + to_string(i)), D(nd.in[0]));
+                }
+                if (kind == TASK_B) {
+                    vector<string> t;
+                    for (int i = 0; i < nd.out.size(); ++i)
+                        t.push_back("(" + S(n, "sent" + to_string(i)) + " or " + R(nd.out[i]) + ")");
+                    setReady(code, nd.in[0], join(t, "and", "true"));
+                }
+                break;
+
+            case NODE_OPERATOR: {
+                string all = allValid(nd.in);
+                if (nd.latency == 0) {
+                    if (kind == TASK_C) {
+                        for (int c: nd.out) setOut(code, c, all, all + " ? " + opExpr(nd) + " : 0");
+                    }
+                    if (kind == TASK_B) {
+                        string accept = all + " and " + allReady(nd.out);
+                        setReadies(code, nd.in, accept);
+                    }
+                } else {
+                    string last = to_string(nd.latency - 1);
+                    if (kind == TASK_S) {
+                        for (int c: nd.out) setOut(code, c, S(n, "pv[" + last + "]"), S(n, "pd[" + last + "]"));
+                    }
+                    if (kind == TASK_B) {
+                        string accept = all + " and (not " + S(n, "pv[" + last + "]") + " or " + allReady(nd.out) + ")";
+                        if (nd.II > 1)
+                            accept += " and (" + S(n, "last") + " < 0 or cycle - " + S(n, "last") + " >= " + to_string(nd.II) + ")";
+                        setReadies(code, nd.in, accept);
+                    }
+                }
+                break;
+            }
+
+            case NODE_LOAD:
+                if (kind == TASK_C) setOut(code, nd.out[0], V(nd.in[0]), D(nd.in[0]));
+                if (kind == TASK_S) setOut(code, nd.out[1], S(n, "done"), S(n, "reg"));
+                if (kind == TASK_B) {
+                    setReady(code, nd.in[0], R(nd.out[0]));
+                    setReady(code, nd.in[1], "not " + S(n, "done") + " or " + R(nd.out[1]));
+                }
+                break;
+
+            case NODE_STORE: {
+                string all = allValid(nd.in);
+                if (kind == TASK_C) {
+                    for (int i = 0; i < nd.out.size(); ++i) setOut(code, nd.out[i], all, i < 2 ? D(nd.in[i]) : "0");
+                }
+                if (kind == TASK_B) {
+                    string r = all + " and " + allReady(nd.out);
+                    setReadies(code, nd.in, r);
+                }
+                break;
+            }
+
+            case NODE_MERGE:
+            case NODE_MUX:
+            case NODE_CMERGE: {
+                int ndata = nd.kind == NODE_MUX ? nd.in.size() - 1 : nd.in.size();
+                string sel = S(n, "sel"), full = S(n, "full");
+                if (kind == TASK_C) {
+                    code << "    " << sel << " = -1;\n";
+                    if (nd.kind == NODE_MUX) {
+                        int s = nd.in.back();
+                        for (int i = 0; i < ndata; ++i) {
+                            code << "    if (" << V(s) << " and " << D(s) << " == " << i << " and "
+                                 << V(nd.in[i]) << ") " << sel << " = " << i << ";\n";
+                        }
+                    } else {
+                        for (int i = ndata - 1; i >= 0; --i)
+                            code << "    if (" << V(nd.in[i]) << ") " << sel << " = " << i << ";\n";
+                    }
+                    code << "    {\n";
+                    code << "    bool tv = " << full << " or " << sel << " >= 0;\n";
+                    code << "    uint64_t td = " << full << " ? " << S(n, "reg") << " : 0;\n";
+                    for (int i = 0; i < ndata; ++i)
+                        code << "    if (not " << full << " and " << sel << " == " << i << ") td = " << D(nd.in[i]) << ";\n";
+                    if (nd.kind == NODE_CMERGE) {
+                        code << "    uint64_t ti = " << full << " ? " << S(n, "idx") << " : " << sel << ";\n";
+                        setOut(code, nd.out[0], "tv and not " + S(n, "sent0"), "td");
+                        setOut(code, nd.out[1], "tv and not " + S(n, "sent1"), "ti");
+                    } else {
+                        setOut(code, nd.out[0], "tv", "td");
+                    }
+                    code << "    }\n";
+                }
+                if (kind == TASK_B) {
+                    for (int i = 0; i < ndata; ++i)
+                        setReady(code, nd.in[i], "not " + full + " and " + sel + " == " + to_string(i));
+                    if (nd.kind == NODE_MUX) setReady(code, nd.in.back(), "not " + full + " and " + sel + " >= 0");
+                }
+                break;
+            }
+
+            case NODE_BRANCH: {
+                string all = V(nd.in[0]) + " and " + V(nd.in[1]);
+                string cond = "(" + D(nd.in[1]) + " & 1)";
+                if (kind == TASK_C) {
+                    setOut(code, nd.out[0], all + " and " + cond, D(nd.in[0]));
+                    setOut(code, nd.out[1], all + " and not " + cond, D(nd.in[0]));
+                }
+                if (kind == TASK_B) {
+                    string r = all + " and (" + cond + " ? " + R(nd.out[0]) + " : " + R(nd.out[1]) + ")";
+                    setReady(code, nd.in[0], r);
+                    setReady(code, nd.in[1], r);
+                }
+                break;
+            }
+
+            case NODE_BUFFER: {
+                int ci = nd.in[0], co = nd.out[0];
+                string count = S(n, "count"), head = S(n, "q[" + S(n, "head") + "]");
+                if (kind == TASK_S and not nd.transparent) setOut(code, co, count + " > 0", head);
+                if (kind == TASK_C and nd.transparent) setOut(code, co, count + " > 0 or " + V(ci), count + " > 0 ? " + head + " : " + D(ci));
+                if (kind == TASK_B) setReady(code, ci, count + " < " + to_string(nd.slots) + " or " + R(co));
+                break;
+            }
+
+            case NODE_MEMORY:
+                if (kind == TASK_S) {
+                    for (int i = 0; i < nd.ldAddr.size(); ++i)
+                        setOut(code, nd.ldData[i], S(n, "ldv[" + to_string(i) + "]"), S(n, "ldd[" + to_string(i) + "]"));
+                }
+                if (kind == TASK_C) {
+                    vector<string> busy;
+                    for (int c: nd.ctrl) busy.push_back(V(c));
+                    for (int i = 0; i < nd.stAddr.size(); ++i)
+                        busy.push_back("(" + V(nd.stAddr[i]) + " and " + V(nd.stData[i]) + ")");
+                    setOut(code, nd.endOut, "not " + join(busy, "or", "false") + " and " + S(n, "pending") + " == 0", "0");
+                }
+                if (kind == TASK_B) {
+                    for (int c: nd.ctrl) setReady(code, c, "true");
+                    for (int i = 0; i < nd.ldAddr.size(); ++i)
+                        setReady(code, nd.ldAddr[i], "not " + S(n, "ldv[" + to_string(i) + "]") + " or " + R(nd.ldData[i]));
+                    for (int i = 0; i < nd.stAddr.size(); ++i) {
+                        string all = V(nd.stAddr[i]) + " and " + V(nd.stData[i]);
+                        setReady(code, nd.stAddr[i], all);
+                        setReady(code, nd.stData[i], all);
+                    }
+                }
+                break;
+
+            case NODE_TAGGER:
+            case NODE_UNTAGGER:
+            case NODE_FREE_TAGS:
+            case NODE_ALIGNER_BRANCH:
+                // Tagged netlists are not compiled
+                assert(false);
+                break;
+        }
+
+        string s = code.str();
+        if (not s.empty()) o << "    // " << nd.name << " (" << "SCB"[kind] << ")\n" << s;
+    };
+
+    // Clock edge of a node (same semantics as DFsim::clockNode)
+    auto emitClock = [&](ostream& o, int n) {
+        const Node& nd = nodes[n];
+        ostringstream code;
+
+        switch (nd.kind) {
+            case NODE_ENTRY:
+                for (int c: nd.out) code << "    if " << T(c) << " " << S(n, "done") << " = true;\n";
+                break;
+
+            case NODE_EXIT: {
+                vector<string> t;
+                for (int c: nd.in) t.push_back(T(c));
+                code << "    if (" << join(t, "or", "false") << ") {\n";
+                code << "        status = FINISHED;\n";
+                for (int i = 0; i < nd.in.size(); ++i) {
+                    if (nd.memEnd[i] or nd.inWidth[i] == 0 or nd.in[i] < 0) continue;
+                    code << "        if (" << V(nd.in[i]) << ") { ret = " << D(nd.in[i]) << "; has_ret = true; }\n";
+                }
+                code << "    }\n";
+                break;
+            }
+
+            case NODE_FORK:
+                code << "    if " << T(nd.in[0]) << " {\n";
+                for (int i = 0; i < nd.out.size(); ++i) code << "        " << S(n, "sent" + to_string(i)) << " = false;\n";
+                code << "    } else {\n";
+                for (int i = 0; i < nd.out.size(); ++i)
+                    code << "        if " << T(nd.out[i]) << " " << S(n, "sent" + to_string(i)) << " = true;\n";
+                code << "    }\n";
+                break;
+
+            case NODE_OPERATOR: {
+                string fired = nd.in.empty() ? "false" : T(nd.in[0]);
+                if (nd.II > 1 or nd.latency > 0) code << "    {\n    bool fired = " << fired << ";\n";
+                if (nd.II > 1) code << "    if (fired) " << S(n, "last") << " = cycle;\n";
+                if (nd.latency > 0) {
+                    string pv = S(n, "pv"), pd = S(n, "pd");
+                    int L = nd.latency;
+                    code << "    if (not " << pv << "[" << L - 1 << "] or " << allReady(nd.out) << ") {\n";
+                    code << "        uint64_t d = fired ? " << opExpr(nd) << " : 0;\n";
+                    for (int s = L - 1; s > 0; --s) {
+                        code << "        " << pv << "[" << s << "] = " << pv << "[" << s - 1 << "]; "
+                             << pd << "[" << s << "] = " << pd << "[" << s - 1 << "];\n";
+                    }
+                    code << "        " << pv << "[0] = fired; " << pd << "[0] = d;\n";
+                    for (int s = 0; s < L; ++s) code << "        act = act or " << pv << "[" << s << "];\n";
+                    code << "    }\n";
+                }
+                if (nd.II > 1 or nd.latency > 0) code << "    }\n";
+                break;
+            }
+
+            case NODE_LOAD:
+                code << "    if " << T(nd.out[1]) << " " << S(n, "done") << " = false;\n";
+                code << "    if " << T(nd.in[1]) << " { " << S(n, "done") << " = true; "
+                     << S(n, "reg") << " = " << D(nd.in[1]) << "; }\n";
+                break;
+
+            case NODE_MERGE:
+            case NODE_MUX:
+            case NODE_CMERGE: {
+                string full = S(n, "full"), sel = S(n, "sel");
+                code << "    {\n";
+                if (nd.kind == NODE_CMERGE) {
+                    code << "    bool tv = " << full << " or " << sel << " >= 0;\n";
+                    code << "    bool ot = tv and (" << S(n, "sent0") << " or " << R(nd.out[0]) << ") and ("
+                         << S(n, "sent1") << " or " << R(nd.out[1]) << ");\n";
+                    for (int i = 0; i < 2; ++i) {
+                        string sent = S(n, "sent" + to_string(i));
+                        code << "    if (ot) " << sent << " = false; else if " << T(nd.out[i]) << " " << sent << " = true;\n";
+                    }
+                } else {
+                    code << "    bool ot = " << T(nd.out[0]) << ";\n";
+                }
+                int ndata = nd.kind == NODE_MUX ? nd.in.size() - 1 : nd.in.size();
+                code << "    if (" << full << ") { if (ot) " << full << " = false; }\n";
+                code << "    else if (" << sel << " >= 0 and not ot) {\n";
+                code << "        " << full << " = true;\n";
+                code << "        " << S(n, "idx") << " = " << sel << ";\n";
+                for (int i = 0; i < ndata; ++i)
+                    code << "        if (" << sel << " == " << i << ") " << S(n, "reg") << " = " << D(nd.in[i]) << ";\n";
+                code << "    }\n";
+                code << "    }\n";
+                break;
+            }
+
+            case NODE_BUFFER: {
+                string head = S(n, "head"), count = S(n, "count"), q = S(n, "q");
+                string slots = to_string(nd.slots);
+                code << "    {\n";
+                code << "    bool in_t = " << T(nd.in[0]) << ", out_t = " << T(nd.out[0]) << ";\n";
+                code << "    bool bypass = " << (nd.transparent ? count + " == 0" : string("false")) << ";\n";
+                code << "    if (out_t and not bypass) { " << head << " = (" << head << " + 1) % " << slots
+                     << "; " << count << "--; }\n";
+                code << "    if (in_t and not (bypass and out_t)) { " << q << "[(" << head << " + " << count << ") % "
+                     << slots << "] = " << D(nd.in[0]) << "; " << count << "++; }\n";
+                code << "    }\n";
+                break;
+            }
+
+            case NODE_MEMORY: {
+                string mem = "mem[" + to_string(nd.memory) + "]";
+                string pending = S(n, "pending");
+                for (int i = 0; i < nd.ctrl.size(); ++i) {
+                    code << "    if " << T(nd.ctrl[i]) << " " << pending << " += "
+                         << "(long long) " << D(nd.ctrl[i]) << ";\n";
+                }
+                for (int i = 0; i < nd.ldAddr.size(); ++i) {
+                    string ldv = S(n, "ldv[" + to_string(i) + "]"), ldd = S(n, "ldd[" + to_string(i) + "]");
+                    code << "    if " << T(nd.ldData[i]) << " " << ldv << " = false;\n";
+                    code << "    if " << T(nd.ldAddr[i]) << " {\n";
+                    code << "        uint64_t addr = " << D(nd.ldAddr[i]) << ";\n";
+                    code << "        " << ldv << " = true;\n";
+                    code << "        " << ldd << " = addr < " << mem << ".size() ? " << mem << "[addr] : 0;\n";
+                    code << "    }\n";
+                }
+                for (int i = 0; i < nd.stAddr.size(); ++i) {
+                    code << "    if " << T(nd.stAddr[i]) << " {\n";
+                    code << "        uint64_t addr = " << D(nd.stAddr[i]) << ";\n";
+                    code << "        if (addr >= " << mem << ".size()) " << mem << ".resize(addr + 1, 0);\n";
+                    code << "        " << mem << "[addr] = " << D(nd.stData[i]) << ";\n";
+                    code << "        " << pending << "--;\n";
+                    code << "    }\n";
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        string s = code.str();
+        if (not s.empty()) o << "    // " << nd.name << "\n" << s;
+    };
+
+    os << "// Compiled simulation of a dataflow netlist (" << N << " nodes, " << C << " channels).\n";
+    os << "// Generated by \"buffers simulate -compile\". Do not edit.\n\n";
+    os << prelude;
+
+    os << "enum Status {RUNNING, FINISHED, DEADLOCK, CYCLE_LIMIT};\n";
+    os << "static const char* status_names[] = {\"running\", \"finished\", \"deadlock\", \"cycle limit\"};\n";
+    os << "static Status status = RUNNING;\n";
+    os << "static long long cycle = 0;\n";
+    os << "static uint64_t ret = 0;\n";
+    os << "static bool has_ret = false;\n";
+    os << "static bool act;     // Some state changed in the cycle\n\n";
+
+    // Channels
+    os << "// Channels\n";
+    for (int c = 0; c < C; ++c) {
+        os << "static bool v" << c << ", r" << c << "; static " << cType(channels[c].width) << " d" << c
+           << "; static long long t" << c << ";\n";
+    }
+    os << "static const char* channel_names[" << max(C, 1) << "] = {\n";
+    for (int c = 0; c < C; ++c) os << "    " << quote(channels[c].name) << ",\n";
+    os << "};\n";
+    os << "static long long* transfers[" << max(C, 1) << "] = {";
+    for (int c = 0; c < C; ++c) os << (c % 8 == 0 ? "\n    " : " ") << "&t" << c << ",";
+    os << "\n};\n\n";
+
+    // Memories
+    int M = memories.size();
+    os << "// Memories\n";
+    os << "static vector<uint64_t> mem[" << max(M, 1) << "];\n";
+    os << "static const char* mem_names[" << max(M, 1) << "] = {";
+    vector<string> memNames(M);
+    for (const auto& m: memoryIndex) memNames[m.second] = m.first;
+    for (int m = 0; m < M; ++m) os << quote(memNames[m]) << (m + 1 < M ? ", " : "");
+    os << "};\n";
+    os << "static const int num_mems = " << M << ";\n";
+    os << "static map<string, vector<uint64_t>> other_mems; // Memories of the file not accessed by the netlist\n\n";
+
+    // State of the nodes
+    os << "// State of the nodes\n";
+    for (int n = 0; n < N; ++n) {
+        const Node& nd = nodes[n];
+        switch (nd.kind) {
+            case NODE_ENTRY:
+                os << "static bool " << S(n, "done") << " = false; static uint64_t " << S(n, "value")
+                   << " = " << nd.value << "ULL; // " << nd.name << "\n";
+                break;
+            case NODE_FORK:
+                os << "static bool ";
+                for (int i = 0; i < nd.out.size(); ++i) os << (i ? ", " : "") << S(n, "sent" + to_string(i));
+                os << "; // " << nd.name << "\n";
+                break;
+            case NODE_OPERATOR:
+                if (nd.latency > 0) {
+                    os << "static bool " << S(n, "pv") << "[" << nd.latency << "]; static uint64_t " << S(n, "pd")
+                       << "[" << nd.latency << "]; // " << nd.name << "\n";
+                }
+                if (nd.II > 1) os << "static long long " << S(n, "last") << " = -1;\n";
+                break;
+            case NODE_LOAD:
+                os << "static bool " << S(n, "done") << "; static uint64_t " << S(n, "reg") << "; // " << nd.name << "\n";
+                break;
+            case NODE_MERGE:
+            case NODE_MUX:
+            case NODE_CMERGE:
+                os << "static bool " << S(n, "full") << "; static uint64_t " << S(n, "reg") << "; static int "
+                   << S(n, "idx") << ", " << S(n, "sel") << ";";
+                if (nd.kind == NODE_CMERGE) os << " static bool " << S(n, "sent0") << ", " << S(n, "sent1") << ";";
+                os << " // " << nd.name << "\n";
+                break;
+            case NODE_BUFFER:
+                os << "static uint64_t " << S(n, "q") << "[" << nd.slots << "]; static int " << S(n, "head") << ", "
+                   << S(n, "count") << "; // " << nd.name << "\n";
+                break;
+            case NODE_MEMORY: {
+                int L = max((int) nd.ldAddr.size(), 1);
+                os << "static bool " << S(n, "ldv") << "[" << L << "]; static uint64_t " << S(n, "ldd") << "[" << L
+                   << "]; static long long " << S(n, "pending") << "; // " << nd.name << "\n";
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    os << "\n";
+
+    // Entries (arguments)
+    os << "static bool set_argument(const string& name, uint64_t value)\n{\n";
+    for (int n = 0; n < N; ++n) {
+        if (nodes[n].kind != NODE_ENTRY) continue;
+        os << "    if (name == " << quote(nodes[n].name) << ") { " << S(n, "value") << " = value; return true; }\n";
+    }
+    os << "    return false;\n}\n\n";
+
+    // Combinational logic
+    vector<string> comb;
+    for (const vector<int>& scc: order) {
+        ostringstream b;
+        bool loop = scc.size() > 1 or find(deps[scc[0]].begin(), deps[scc[0]].end(), scc[0]) != deps[scc[0]].end();
+        if (not loop) {
+            emitTask(b, scc[0]);
+            comb.push_back(b.str());
+            continue;
+        }
+
+        // Combinational cycle: fixed point from all signals low
+        set<int> vchans, rchans;
+        for (int t: scc) {
+            const Node& nd = nodes[t / 3];
+            vector<int> outs = nd.kind == NODE_MEMORY ? nd.ldData : nd.out;
+            if (nd.kind == NODE_MEMORY) outs.push_back(nd.endOut);
+            for (int c: outs) if (c >= 0 and prod[c] == t) vchans.insert(c);
+            if (t % 3 == TASK_B) for (int c: inputs(nd)) if (c >= 0) rchans.insert(c);
+        }
+        b << "    // Combinational cycle\n";
+        for (int c: vchans) b << "    v" << c << " = false; d" << c << " = 0;\n";
+        for (int c: rchans) b << "    r" << c << " = false;\n";
+        b << "    for (int it = 0; ; ++it) {\n";
+        b << "    if (it > " << 64 * scc.size() + 64 << ") return false;\n";
+        b << "    bool same = it > 0;\n";
+        for (int c: vchans) b << "    bool pv" << c << " = v" << c << "; uint64_t pd" << c << " = d" << c << ";\n";
+        for (int c: rchans) b << "    bool pr" << c << " = r" << c << ";\n";
+        for (int t: scc) emitTask(b, t);
+        for (int c: vchans) b << "    same = same and v" << c << " == pv" << c << " and d" << c << " == pd" << c << ";\n";
+        for (int c: rchans) b << "    same = same and r" << c << " == pr" << c << ";\n";
+        b << "    if (same) break;\n";
+        b << "    }\n";
+        comb.push_back(b.str());
+    }
+    int num_comb = writeFunctions(os, "comb", "bool", comb, "    return true;\n");
+
+    // Transfers
+    vector<string> transfer;
+    for (int c = 0; c < C; ++c) transfer.push_back("    if (v" + to_string(c) + " and r" + to_string(c) + ") { t" +
+                                                   to_string(c) + "++; act = true; }\n");
+    for (int n = 0; n < N; ++n) {
+        const Node& nd = nodes[n];
+        if (nd.kind != NODE_OPERATOR or nd.II <= 1) continue;
+        transfer.push_back("    if (" + S(n, "last") + " >= 0 and cycle - " + S(n, "last") + " < " + to_string(nd.II) +
+                           ") act = true;\n");
+    }
+    int num_transfer = writeFunctions(os, "transfer", "void", transfer, "");
+
+    // Clock edge
+    vector<string> clock;
+    for (int n = 0; n < N; ++n) {
+        ostringstream b;
+        emitClock(b, n);
+        clock.push_back(b.str());
+    }
+    int num_clock = writeFunctions(os, "clock", "void", clock, "");
+
+    // One cycle
+    os << "static void step()\n{\n";
+    for (int i = 0; i < num_comb; ++i) {
+        os << "    if (not comb" << i << "()) {\n";
+        os << "        cerr << \"Cycle \" << cycle << \": the combinational logic does not converge.\" << endl;\n";
+        os << "        status = DEADLOCK;\n";
+        os << "        return;\n";
+        os << "    }\n";
+    }
+    os << "    act = false;\n";
+    for (int i = 0; i < num_transfer; ++i) os << "    transfer" << i << "();\n";
+    for (int i = 0; i < num_clock; ++i) os << "    clock" << i << "();\n";
+    os << "    cycle++;\n";
+    os << "    if (status == RUNNING and not act) status = DEADLOCK;\n";
+    os << "}\n\n";
+
+    os << R"(static bool read_memories(const string& filename)
+{
+    ifstream f(filename);
+    if (not f.is_open()) return false;
+    string line;
+    while (getline(f, line)) {
+        istringstream iss(line);
+        string name, word;
+        if (not (iss >> name) or name[0] == '#') continue;
+        vector<uint64_t> contents;
+        while (iss >> word) {
+            if (word.find('.') != string::npos) contents.push_back(tf(atof(word.c_str()), 32));
+            else contents.push_back((uint64_t) strtoll(word.c_str(), nullptr, 0));
+        }
+        int m = 0;
+        while (m < num_mems and name != mem_names[m]) ++m;
+        if (m < num_mems) mem[m] = contents;
+        else other_mems[name] = contents;
+    }
+    return true;
+}
+
+// Same format and order (by name) as DFsim::writeMemories
+static bool write_memories(const string& filename)
+{
+    ofstream f(filename);
+    if (not f.is_open()) return false;
+    map<string, const vector<uint64_t>*> all;
+    for (int m = 0; m < num_mems; ++m) all[mem_names[m]] = &mem[m];
+    for (const auto& m: other_mems) all[m.first] = &m.second;
+    for (const auto& m: all) {
+        f << m.first;
+        for (uint64_t w: *m.second) f << ' ' << (int64_t) w;
+        f << endl;
+    }
+    return true;
+}
+
+)";
+
+    os << R"(int main(int argc, char* argv[])
+{
+    long long max_cycles = 1000000;
+    string mem_in, mem_out;
+    for (int i = 1; i < argc; ++i) {
+        string param = argv[i];
+        string value = param.substr(param.find("=") + 1);
+        if (param.compare(0, 8, "-cycles=") == 0) max_cycles = atoll(value.c_str());
+        else if (param.compare(0, 5, "-mem=") == 0) mem_in = value;
+        else if (param.compare(0, 9, "-mem_out=") == 0) mem_out = value;
+        else if (param.compare(0, 6, "-args=") == 0) {
+            stringstream ss(value);
+            string arg;
+            while (getline(ss, arg, ',')) {
+                size_t eq = arg.find("=");
+                if (eq == string::npos or not set_argument(arg.substr(0, eq), strtoll(arg.substr(eq + 1).c_str(), nullptr, 0))) {
+                    cerr << "Argument " << arg << " not found." << endl;
+                    return 1;
+                }
+            }
+        } else {
+            cerr << param << " is invalid argument" << endl;
+            return 1;
+        }
+    }
+    if (not mem_in.empty() and not read_memories(mem_in)) {
+        cerr << "File " << mem_in << " could not be opened." << endl;
+        return 1;
+    }
+
+    while (status == RUNNING) {
+        if (cycle >= max_cycles) {
+            status = CYCLE_LIMIT;
+            break;
+        }
+        step();
+    }
+
+    cout << "Simulation status: " << status_names[status] << endl;
+    cout << "Cycles: " << cycle << endl;
+    if (has_ret) cout << "Return value: " << (int64_t) ret << endl;
+    cout << endl << "Tokens per channel:" << endl;
+    for (size_t c = 0; c < sizeof(transfers) / sizeof(transfers[0]); ++c) {
+        if (channel_names[c] == nullptr) continue;
+        double th = cycle == 0 ? 0 : (double) *transfers[c] / cycle;
+        cout << setw(10) << *transfers[c] << "  " << fixed << setprecision(3) << th << "  " << channel_names[c] << endl;
+    }
+
+    if (not mem_out.empty() and not write_memories(mem_out)) {
+        cerr << "File " << mem_out << " could not be written." << endl;
+        return 1;
+    }
+    return status == FINISHED ? 0 : 1;
+}
+)";
+
+    return os.good();
+}
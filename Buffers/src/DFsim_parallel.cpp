@@ -0,0 +1,313 @@
+#include <atomic>
+#include <cassert>
+#include <numeric>
+#include <thread>
+#include "DFsim.h"
+
+using namespace Dataflow;
+using namespace std;
+
+/*
+ * Parallel simulation. The netlist is partitioned along the channels whose
+ * valid and data signals only depend on the state of their source, e.g., the
+ * outputs of opaque buffers and pipelined operators. These signals are known
+ * at the beginning of the cycle. The ready signals still propagate backwards
+ * (a full buffer is ready if its output is ready), so every cycle is
+ * evaluated in rounds:
+ *
+ *   1. Every partition computes the fixed point of its combinational logic,
+ *      with the readies of its outgoing cut channels from the previous round
+ *      (initially low). The readies of the incoming cut channels are kept
+ *      in nextReady.
+ *   2. The readies of the cut channels are exchanged. If some of them changed,
+ *      the source nodes are scheduled and a new round starts.
+ *
+ * This is the same fixed point computed by the sequential simulation. At the
+ * end of the cycle, every partition counts the transfers of its channels and
+ * updates the state of its nodes. The threads synchronize with barriers.
+ */
+
+/**
+ * @brief Barrier for a fixed number of threads. The threads spin since
+ * the phases of a cycle are short, unless there are more threads than cores.
+ */
+struct DFsim::Barrier {
+    int threads;
+    int spins;
+    atomic<int> waiting{0};
+    atomic<int> generation{0};
+
+    Barrier(int n) : threads(n) {
+        spins = n <= (int) thread::hardware_concurrency() ? 1024 : 0;
+    }
+
+    void wait() {
+        int gen = generation.load(memory_order_acquire);
+        if (waiting.fetch_add(1, memory_order_acq_rel) == threads - 1) {
+            waiting.store(0, memory_order_relaxed);
+            generation.fetch_add(1, memory_order_acq_rel);
+            return;
+        }
+        for (int spin = 0; generation.load(memory_order_acquire) == gen; ++spin) {
+            if (spin >= spins) this_thread::yield();
+        }
+    }
+};
+
+bool DFsim::isStateOutput(int c) const
+{
+    const Channel& ch = channels[c];
+    if (ch.src < 0) return false;
+    const Node& n = nodes[ch.src];
+    switch (n.kind) {
+        case NODE_ENTRY:
+        case NODE_SOURCE:
+            return true;
+        case NODE_BUFFER:
+            return not n.transparent;
+        case NODE_OPERATOR:
+            return n.latency > 0;
+        case NODE_LOAD:
+            return c == n.out[1];
+        case NODE_MEMORY:
+            return find(n.ldData.begin(), n.ldData.end(), c) != n.ldData.end();
+        default:
+            return false;
+    }
+}
+
+void DFsim::setStateOutput(int c)
+{
+    // Same values as evalNode
+    const Node& n = nodes[channels[c].src];
+    switch (n.kind) {
+        case NODE_ENTRY:
+            setOut(c, not n.done, n.value);
+            break;
+        case NODE_SOURCE:
+            setOut(c, true, 0);
+            break;
+        case NODE_BUFFER:
+            setOut(c, n.count > 0, n.count > 0 ? n.regs[n.head] : 0, n.count > 0 ? n.regTags[n.head] : 0);
+            break;
+        case NODE_OPERATOR:
+            setOut(c, n.full[n.latency - 1], n.regs[n.latency - 1], n.regTags[n.latency - 1]);
+            break;
+        case NODE_LOAD:
+            setOut(c, n.done, n.reg);
+            break;
+        case NODE_MEMORY:
+            for (int i = 0; i < n.ldData.size(); ++i) {
+                if (n.ldData[i] == c) setOut(c, n.ldValid[i], n.ldValue[i]);
+            }
+            break;
+        default:
+            assert(false);
+    }
+}
+
+int DFsim::setThreads(int threads)
+{
+    partitions.clear();
+    for (Node& n: nodes) n.part = 0;
+    int N = nodes.size();
+    if (threads <= 1 or N == 0) return 1;
+
+    // Regions: nodes connected by channels whose valid depends on the inputs of the source
+    vector<int> parent(N);
+    iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int n) {
+        while (parent[n] != n) n = parent[n] = parent[parent[n]];
+        return n;
+    };
+    auto unite = [&](int a, int b) { parent[find(a)] = find(b); };
+
+    for (int c = 0; c < channels.size(); ++c) {
+        const Channel& ch = channels[c];
+        if (ch.src >= 0 and ch.dst >= 0 and not isStateOutput(c)) unite(ch.src, ch.dst);
+    }
+
+    // The interfaces of the same memory share its contents
+    map<int, int> memNode;
+    for (int n = 0; n < N; ++n) {
+        if (nodes[n].kind != NODE_MEMORY) continue;
+        auto it = memNode.find(nodes[n].memory);
+        if (it == memNode.end()) memNode[nodes[n].memory] = n;
+        else unite(n, it->second);
+    }
+
+    map<int, vector<int>> regions;
+    for (int n = 0; n < N; ++n) regions[find(n)].push_back(n);
+    if (regions.size() < 2) return 1;
+
+    // Largest regions first, each one to the partition with fewest nodes
+    vector<vector<int>*> sorted;
+    for (auto& r: regions) sorted.push_back(&r.second);
+    stable_sort(sorted.begin(), sorted.end(), [](const vector<int>* a, const vector<int>* b) {
+        return a->size() > b->size();
+    });
+
+    int P = min(threads, (int) regions.size());
+    partitions.resize(P);
+    for (const vector<int>* r: sorted) {
+        int p = 0;
+        for (int q = 1; q < P; ++q) if (partitions[q].nodes.size() < partitions[p].nodes.size()) p = q;
+        for (int n: *r) nodes[n].part = p;
+        partitions[p].nodes.insert(partitions[p].nodes.end(), r->begin(), r->end());
+    }
+
+    for (Partition& part: partitions) sort(part.nodes.begin(), part.nodes.end());
+    for (int c = 0; c < channels.size(); ++c) {
+        const Channel& ch = channels[c];
+        int src = ch.src >= 0 ? nodes[ch.src].part : nodes[ch.dst].part;
+        int dst = ch.dst >= 0 ? nodes[ch.dst].part : src;
+        partitions[src].chans.push_back(c);
+        if (src == dst) continue;
+        partitions[src].cutOut.push_back(c);
+        partitions[dst].cutIn.push_back(c);
+    }
+    return P;
+}
+
+DFsim::Status DFsim::runParallel(long long max_cycles)
+{
+    if (status != RUNNING) return status;
+    if (cycle >= max_cycles) return status = CYCLE_LIMIT;
+
+    for (Partition& part: partitions) {
+        for (int c: part.cutOut) channels[c].cut = true;
+        part.worklist.clear();
+        for (int i = 0; i < 2; ++i) part.changed[i] = part.failed[i] = part.active[i] = false;
+    }
+    inWorklist.assign(nodes.size(), false);
+    partitioned = true;
+
+    // The threads take the same decisions. The one of partition 0 reports the result.
+    int P = partitions.size();
+    Barrier barrier(P);
+    Status final_status = RUNNING;
+    long long final_cycle = cycle;
+    string final_error;
+    Status dummy_status;
+    long long dummy_cycle;
+    string dummy_error;
+
+    vector<thread> workers;
+    for (int p = 1; p < P; ++p) {
+        workers.emplace_back([&, p]() { runPartition(p, max_cycles, barrier, dummy_status, dummy_cycle, dummy_error); });
+    }
+    runPartition(0, max_cycles, barrier, final_status, final_cycle, final_error);
+    for (thread& t: workers) t.join();
+
+    partitioned = false;
+    for (Channel& ch: channels) ch.cut = false;
+
+    status = final_status;
+    cycle = final_cycle;
+    if (not final_error.empty()) error.set(final_error);
+    return status;
+}
+
+void DFsim::runPartition(int p, long long max_cycles, Barrier& barrier, Status& final_status,
+                         long long& final_cycle, string& final_error)
+{
+    Partition& part = partitions[p];
+    int P = partitions.size();
+    int cuts = 0;
+    for (const Partition& q: partitions) cuts += q.cutOut.size();
+    long long max_evals = 64 * (long long) part.nodes.size() + 1024;
+    int round = 0;      // Rounds since the beginning (for the parity of the flags)
+
+    for (long long cyc = cycle; ; ++cyc) {
+        // Reset of the signals of the partition. Outputs of the cut channels.
+        if (p == 0 and cycle != cyc) cycle = cyc;
+        for (int c: part.chans) {
+            Channel& ch = channels[c];
+            ch.valid = ch.ready = false;
+            ch.data = 0;
+        }
+        for (int c: part.cutIn) channels[c].nextReady = false;
+        for (int c: part.cutOut) setStateOutput(c);
+        for (int n: part.nodes) schedule(n);
+        barrier.wait();
+
+        // Fixed point of the cycle
+        for (int rounds = 0; ; ++rounds, ++round) {
+            int r = round % 2;
+            long long evals = 0;
+            part.failed[r] = false;
+            while (not part.worklist.empty()) {
+                int n = part.worklist.back();
+                part.worklist.pop_back();
+                inWorklist[n] = false;
+                evalNode(n);
+                if (++evals > max_evals) {
+                    part.failed[r] = true;
+                    for (int m: part.worklist) inWorklist[m] = false;
+                    part.worklist.clear();
+                    break;
+                }
+            }
+            barrier.wait();
+
+            part.changed[r] = false;
+            for (int c: part.cutOut) {
+                Channel& ch = channels[c];
+                if (ch.ready == ch.nextReady) continue;
+                ch.ready = ch.nextReady;
+                schedule(ch.src);
+                part.changed[r] = true;
+            }
+            barrier.wait();
+
+            bool changed = false, failed = false;
+            for (const Partition& q: partitions) {
+                changed = changed or q.changed[r];
+                failed = failed or q.failed[r];
+            }
+            // The readies of the cut channels can only change a bounded number of times
+            if (failed or (changed and rounds > 2 * cuts + 2)) {
+                if (p == 0) {
+                    final_status = DEADLOCK;
+                    final_cycle = cyc;
+                    final_error = "Cycle " + to_string(cyc) + ": the combinational logic does not converge.";
+                }
+                for (int n: part.worklist) inWorklist[n] = false;
+                part.worklist.clear();
+                return;
+            }
+            if (not changed) break;
+        }
+
+        // Transfers and clock edge
+        int a = cyc % 2;
+        bool active = false;
+        for (int c: part.chans) {
+            if (countChannel(channels[c], cyc)) active = true;
+        }
+        for (int n: part.nodes) {
+            const Node& nd = nodes[n];
+            if (nd.kind == NODE_OPERATOR and nd.II > 1 and nd.lastFire >= 0 and cyc - nd.lastFire < nd.II) active = true;
+        }
+        for (int n: part.nodes) {
+            countNode(nodes[n]);
+            if (clockNode(n)) active = true;
+        }
+        part.active[a] = active;
+        barrier.wait();
+
+        // The exit (in some partition) sets the status at the clock edge
+        bool any_active = false;
+        for (int q = 0; q < P; ++q) any_active = any_active or partitions[q].active[a];
+        Status s = status;
+        if (s == RUNNING and not any_active) s = DEADLOCK;
+        if (s == RUNNING and cyc + 1 >= max_cycles) s = CYCLE_LIMIT;
+        if (s != RUNNING) {
+            if (p == 0) {
+                final_status = s;
+                final_cycle = cyc + 1;
+            }
+            return;
+        }
+    }
+}
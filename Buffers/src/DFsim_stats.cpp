@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "DFnetlist.h"
+#include "DFsim.h"
+
+using namespace Dataflow;
+using namespace std;
+
+/*
+ * Statistics of the simulation. Every cycle, after the fixed point of the
+ * handshakes, each channel is in one of four states: transfer (valid and
+ * ready), stall (valid without ready: the destination back-pressures),
+ * starvation (ready without valid: the destination waits for a token) or idle.
+ * The occupancy of the buffers and memory interfaces is sampled before the
+ * clock edge, i.e., it is the number of tokens stored during the cycle.
+ */
+
+namespace {
+
+// Heat color (green to red) of a fraction in [0,1], in the HSV format of graphviz
+string heatColor(double heat)
+{
+    heat = min(max(heat, 0.0), 1.0);
+    ostringstream s;
+    s << fixed << setprecision(3) << 0.33 * (1 - heat) << " 1.000 1.000";
+    return s.str();
+}
+
+double fraction(long long n, long long d)
+{
+    return d == 0 ? 0 : (double) n / d;
+}
+
+const int maxGap = 4096;   // Last bucket of the histograms of gaps between transfers
+
+double meanOccupancy(const vector<long long>& hist)
+{
+    long long cycles = 0, tokens = 0;
+    for (int i = 0; i < hist.size(); ++i) {
+        cycles += hist[i];
+        tokens += i * hist[i];
+    }
+    return fraction(tokens, cycles);
+}
+
+}
+
+bool DFsim::countChannel(Channel& ch, long long cyc)
+{
+    if (ch.valid and ch.ready) {
+        ch.transfers++;
+        if (ch.watched) {
+            if (ch.lastTransfer >= 0) {
+                // Long gaps are accumulated in the last bucket
+                long long gap = min(cyc - ch.lastTransfer, (long long) maxGap);
+                if (gap >= ch.gaps.size()) ch.gaps.resize(gap + 1, 0);
+                ch.gaps[gap]++;
+            }
+            ch.lastTransfer = cyc;
+        }
+        return true;
+    }
+    if (ch.valid) ch.stalls++;
+    else if (ch.ready) ch.starves++;
+    return false;
+}
+
+void DFsim::countNode(Node& n)
+{
+    long long tokens;
+    switch (n.kind) {
+        case NODE_OPERATOR:
+            if (not n.in.empty() and transfer(n.in[0])) n.fires++;
+            return;
+        case NODE_BUFFER:
+            tokens = n.count;
+            break;
+        case NODE_MEMORY:
+            // LSQ: entries of the queues. MC: stores announced by the control ports and loads in flight
+            if (n.lsq) tokens = n.pendingLoads + n.pendingStores;
+            else tokens = max(n.pendingStores, 0LL) + count(n.ldValid.begin(), n.ldValid.end(), true);
+            break;
+        default:
+            return;
+    }
+    if (tokens >= n.occupancy.size()) n.occupancy.resize(tokens + 1, 0);
+    n.occupancy[tokens]++;
+}
+
+void DFsim::writeBottlenecks(ostream& os, int top) const
+{
+    auto limit = [top](int n) { return top <= 0 ? n : min(n, top); };
+    os << "Bottlenecks (" << cycle << " cycles)" << endl;
+
+    // Channels ranked by a counter
+    auto rankChannels = [&](const string& title, long long Channel::*counter) {
+        vector<int> ranked;
+        for (int c = 0; c < channels.size(); ++c) {
+            if (channels[c].*counter > 0) ranked.push_back(c);
+        }
+        stable_sort(ranked.begin(), ranked.end(), [&](int a, int b) {
+            return channels[a].*counter > channels[b].*counter;
+        });
+        os << endl << title << ":" << endl;
+        for (int i = 0; i < limit(ranked.size()); ++i) {
+            const Channel& ch = channels[ranked[i]];
+            os << setw(10) << ch.*counter << "  " << fixed << setprecision(3) << fraction(ch.*counter, cycle)
+               << "  " << ch.name << endl;
+        }
+    };
+    rankChannels("Back pressure (valid without ready)", &Channel::stalls);
+    rankChannels("Starvation (ready without valid)", &Channel::starves);
+
+    // Operators ranked by the fraction of initiation slots used
+    vector<int> ops, stores;
+    for (int n = 0; n < nodes.size(); ++n) {
+        if (nodes[n].kind == NODE_OPERATOR) ops.push_back(n);
+        else if (not nodes[n].occupancy.empty()) stores.push_back(n);
+    }
+    auto util = [&](int n) { return fraction(nodes[n].fires * nodes[n].II, cycle); };
+    stable_sort(ops.begin(), ops.end(), [&](int a, int b) { return util(a) > util(b); });
+    os << endl << "Operator utilization (fires, fires*II/cycles, latency, II):" << endl;
+    for (int i = 0; i < limit(ops.size()); ++i) {
+        const Node& n = nodes[ops[i]];
+        os << setw(10) << n.fires << "  " << fixed << setprecision(3) << util(ops[i]) << "  "
+           << setw(3) << n.latency << "  " << setw(3) << n.II << "  " << n.name << endl;
+    }
+
+    // Buffers and memory interfaces ranked by the mean occupancy
+    stable_sort(stores.begin(), stores.end(), [&](int a, int b) {
+        return meanOccupancy(nodes[a].occupancy) > meanOccupancy(nodes[b].occupancy);
+    });
+    os << endl << "Occupancy (mean, max, slots, cycles with 0,1,2,... tokens):" << endl;
+    for (int i = 0; i < limit(stores.size()); ++i) {
+        const Node& n = nodes[stores[i]];
+        os << setw(10) << fixed << setprecision(3) << meanOccupancy(n.occupancy) << "  "
+           << setw(3) << n.occupancy.size() - 1 << "  ";
+        if (n.kind == NODE_BUFFER) os << setw(3) << n.slots;
+        else os << (n.lsq ? "LSQ" : " MC");
+        os << "  " << n.name << " [";
+        for (int k = 0; k < n.occupancy.size(); ++k) os << (k == 0 ? "" : " ") << n.occupancy[k];
+        os << "]" << endl;
+    }
+}
+
+double DFsim::steadyThroughput(int c) const
+{
+    const vector<long long>& gaps = channels[c].gaps;
+    long long total = 0;
+    for (long long n: gaps) total += n;
+    if (total == 0) return 0;
+
+    long long median = 0;
+    for (long long acc = 0; 2 * (acc + gaps[median]) < total + 1; ++median) acc += gaps[median];
+
+    long long cycles = 0, intervals = 0;
+    for (long long gap = 1; gap < gaps.size() and gap <= 4 * median; ++gap) {
+        cycles += gap * gaps[gap];
+        intervals += gaps[gap];
+    }
+    return fraction(intervals, cycles);
+}
+
+bool DFsim::startTrace(DFtraceWriter& writer, const string& filename, bool with_data)
+{
+    vector<DFtraceNode> trace_nodes;
+    vector<DFtraceChannel> trace_channels;
+    for (const Node& n: nodes) trace_nodes.push_back({n.name, n.latency});
+    for (const Channel& ch: channels) trace_channels.push_back({ch.src, ch.dst, ch.width, ch.name});
+    if (not writer.open(filename, trace_nodes, trace_channels, with_data)) return false;
+    trace = &writer;
+    return true;
+}
+
+bool DFsim::stopTrace()
+{
+    if (not trace) return true;
+    bool ok = trace->close();
+    trace = nullptr;
+    return ok;
+}
+
+bool DFsim::writeLSQDepths(const string& filename) const
+{
+    ofstream f(filename);
+    if (not f.is_open()) return false;
+    f << "# LSQ depths measured by simulation (" << cycle << " cycles)" << endl;
+    f << "# <name> <depth>  (peak entries of the load and store queues)" << endl;
+    for (const Node& n: nodes) {
+        if (n.kind != NODE_MEMORY or not n.lsq) continue;
+        long long depth = 2;
+        while (depth < max(n.peakLoads, n.peakStores)) depth *= 2;
+        f << n.name << ' ' << depth << "  # loads " << n.peakLoads << ", stores " << n.peakStores << endl;
+    }
+    return f.good();
+}
+
+bool DFsim::writeHeatDot(DFnetlist& DF, const string& filename) const
+{
+    map<blockID, string> block_colors;
+    map<channelID, string> channel_colors;
+
+    for (const Channel& ch: channels) channel_colors[ch.id] = heatColor(fraction(ch.stalls, cycle));
+    for (const Node& n: nodes) {
+        if (n.kind == NODE_OPERATOR) {
+            block_colors[n.id] = heatColor(fraction(n.fires * n.II, cycle));
+        } else if (not n.occupancy.empty()) {
+            // Buffers: relative to the slots. Memories: relative to the maximum occupancy.
+            int capacity = n.kind == NODE_BUFFER ? n.slots : n.occupancy.size() - 1;
+            block_colors[n.id] = heatColor(capacity == 0 ? 0 : meanOccupancy(n.occupancy) / capacity);
+        }
+    }
+
+    DFnetlist_Impl& DFI = *DF.DFI;
+    DFI.setDotColors(block_colors, channel_colors);
+    bool ok = DFI.writeDot(filename);
+    DFI.setDotColors({}, {});
+    return ok;
+}
@@ -0,0 +1,177 @@
+#include <sstream>
+#include <zlib.h>
+#include "DFtrace.h"
+
+using namespace Dataflow;
+using namespace std;
+
+namespace {
+
+const size_t blockSize = 1 << 16;   // Size of the uncompressed blocks
+
+void putVarint(string& s, uint64_t v)
+{
+    while (v >= 0x80) {
+        s += (char) ((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    s += (char) v;
+}
+
+bool getVarint(const string& s, size_t& pos, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; pos < s.size() and shift < 64; shift += 7) {
+        uint8_t byte = s[pos++];
+        v |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+void putWord(ostream& os, uint32_t w)
+{
+    char b[4] = {(char) w, (char) (w >> 8), (char) (w >> 16), (char) (w >> 24)};
+    os.write(b, 4);
+}
+
+bool getWord(istream& is, uint32_t& w)
+{
+    unsigned char b[4];
+    if (not is.read((char*) b, 4)) return false;
+    w = b[0] | b[1] << 8 | b[2] << 16 | (uint32_t) b[3] << 24;
+    return true;
+}
+
+}
+
+bool DFtraceWriter::open(const string& filename, const vector<DFtraceNode>& nodes,
+                         const vector<DFtraceChannel>& channels, bool with_data)
+{
+    close();
+    file.open(filename, ios::binary);
+    if (not file.is_open()) return false;
+
+    withData = with_data;
+    lastCycle = records = 0;
+    failed = false;
+    block.clear();
+
+    file << "DFTRACE 1" << endl;
+    file << "data " << (with_data ? 1 : 0) << endl;
+    for (const DFtraceNode& n: nodes) file << "node " << n.latency << ' ' << n.name << endl;
+    for (const DFtraceChannel& ch: channels) {
+        file << "channel " << ch.src << ' ' << ch.dst << ' ' << ch.width << ' ' << ch.name << endl;
+    }
+    file << "end" << endl;
+    return file.good();
+}
+
+void DFtraceWriter::record(long long cycle, int channel, uint64_t data)
+{
+    putVarint(block, cycle - lastCycle);
+    putVarint(block, channel);
+    if (withData) putVarint(block, data);
+    lastCycle = cycle;
+    records++;
+    if (block.size() >= blockSize) flushBlock();
+}
+
+void DFtraceWriter::flushBlock()
+{
+    if (block.empty()) return;
+    uLongf size = compressBound(block.size());
+    string compressed(size, '\0');
+    if (compress2((Bytef*) &compressed[0], &size, (const Bytef*) block.data(), block.size(), 6) != Z_OK) {
+        failed = true;
+        block.clear();
+        return;
+    }
+    putWord(file, block.size());
+    putWord(file, size);
+    file.write(compressed.data(), size);
+    block.clear();
+}
+
+bool DFtraceWriter::close()
+{
+    if (not file.is_open()) return true;
+    flushBlock();
+    bool ok = file.good() and not failed;
+    file.close();
+    return ok;
+}
+
+bool DFtraceReader::open(const string& filename)
+{
+    file.open(filename, ios::binary);
+    if (not file.is_open()) {
+        error = "File " + filename + " could not be opened.";
+        return false;
+    }
+
+    string line, key;
+    if (not getline(file, line) or line != "DFTRACE 1") {
+        error = "File " + filename + " is not a trace.";
+        return false;
+    }
+    while (getline(file, line)) {
+        istringstream iss(line);
+        iss >> key;
+        if (key == "end") return true;
+        if (key == "data") {
+            iss >> withData;
+        } else if (key == "node") {
+            DFtraceNode n;
+            iss >> n.latency >> ws;
+            getline(iss, n.name);
+            nodes.push_back(n);
+        } else if (key == "channel") {
+            DFtraceChannel ch;
+            iss >> ch.src >> ch.dst >> ch.width >> ws;
+            getline(iss, ch.name);
+            channels.push_back(ch);
+        }
+        if (iss.fail()) break;
+    }
+    error = "Wrong header in trace " + filename + ".";
+    return false;
+}
+
+bool DFtraceReader::readBlock()
+{
+    uint32_t raw, size;
+    block.clear();
+    pos = 0;
+    if (not getWord(file, raw)) return false;       // End of the trace
+    if (not getWord(file, size)) {
+        error = "Truncated trace.";
+        return false;
+    }
+    string compressed(size, '\0');
+    block.resize(raw);
+    uLongf len = raw;
+    if (not file.read(&compressed[0], size) or
+        uncompress((Bytef*) &block[0], &len, (const Bytef*) compressed.data(), size) != Z_OK or len != raw) {
+        error = "Corrupted block in the trace.";
+        block.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DFtraceReader::next(DFtraceRecord& r)
+{
+    if (pos >= block.size() and not readBlock()) return false;
+    uint64_t delta, channel, data = 0;
+    if (not getVarint(block, pos, delta) or not getVarint(block, pos, channel) or
+        (withData and not getVarint(block, pos, data))) {
+        error = "Corrupted record in the trace.";
+        return false;
+    }
+    cycle += delta;
+    r.cycle = cycle;
+    r.channel = channel;
+    r.data = data;
+    return true;
+}
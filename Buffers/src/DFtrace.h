@@ -0,0 +1,121 @@
+#ifndef DFTRACE_H
+#define DFTRACE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Dataflow
+{
+
+/*
+ * Binary trace of the transfers of a simulation (see DFsim::startTrace).
+ *
+ * The file starts with a text header that describes the netlist:
+ *   DFTRACE 1
+ *   data <0|1>                                   (records with data)
+ *   node <latency> <name>                        (one per node, in order)
+ *   channel <src> <dst> <width> <name>           (one per channel, in order)
+ *   end
+ *
+ * followed by compressed blocks: <raw size> <compressed size> (32-bit little
+ * endian) and the block compressed with zlib. The contents of the blocks are
+ * records of varints (LEB128): <cycle delta> <channel> [<data>], where the delta
+ * is the number of cycles since the previous record. The records of a cycle
+ * are in the order of the channels.
+ */
+
+struct DFtraceNode {
+    std::string name;
+    int latency;
+};
+
+struct DFtraceChannel {
+    int src, dst;           // Nodes (-1 if none)
+    int width;
+    std::string name;
+};
+
+struct DFtraceRecord {
+    long long cycle;
+    int channel;
+    uint64_t data;          // 0 if the trace has no data
+};
+
+class DFtraceWriter
+{
+public:
+    ~DFtraceWriter() { close(); }
+
+    /**
+     * @brief Creates the trace file and writes the header.
+     * @param with_data If asserted, the data of the transfers are recorded.
+     * @return False if the file could not be created.
+     */
+    bool open(const std::string& filename, const std::vector<DFtraceNode>& nodes,
+              const std::vector<DFtraceChannel>& channels, bool with_data);
+
+    bool isOpen() const { return file.is_open(); }
+
+    /**
+     * @brief Records a transfer. The cycles must be non-decreasing.
+     */
+    void record(long long cycle, int channel, uint64_t data);
+
+    /**
+     * @brief Writes the pending block and closes the file.
+     * @return False if some write failed.
+     */
+    bool close();
+
+    long long numRecords() const { return records; }
+
+private:
+    std::ofstream file;
+    std::string block;      // Records of the current block (uncompressed)
+    bool withData = false;
+    long long lastCycle = 0;
+    long long records = 0;
+    bool failed = false;
+
+    void flushBlock();
+};
+
+class DFtraceReader
+{
+public:
+    /**
+     * @brief Opens a trace and reads its header.
+     * @return False if the file could not be read or has a wrong format (see getError).
+     */
+    bool open(const std::string& filename);
+
+    bool hasData() const { return withData; }
+    const std::vector<DFtraceNode>& getNodes() const { return nodes; }
+    const std::vector<DFtraceChannel>& getChannels() const { return channels; }
+
+    /**
+     * @brief Reads the next record.
+     * @return False at the end of the trace or if the trace is corrupted (see getError).
+     */
+    bool next(DFtraceRecord& r);
+
+    const std::string& getError() const { return error; }
+
+private:
+    std::ifstream file;
+    std::vector<DFtraceNode> nodes;
+    std::vector<DFtraceChannel> channels;
+    bool withData = false;
+    std::string block;
+    size_t pos = 0;
+    long long cycle = 0;
+    std::string error;
+
+    bool readBlock();
+};
+
+}
+
+#endif // DFTRACE_H
@@ -373,6 +373,11 @@ bool DFnetlist::writeDot(std::ostream& s)
     return DFI->writeDot(s);
 }
 
+bool DFnetlist::writeVhdl(const string& filename)
+{
+    return DFI->writeVhdl(filename);
+}
+
 bool DFnetlist::writeDotMG(const std::string &filename) {
     return DFI->writeDotMG(filename);
 }
@@ -404,6 +409,26 @@ void DFnetlist::setMilpSolver(const string& solver)
     return DFI->setMilpSolver(solver);
 }
 
+void DFnetlist::setMilpCorpusDir(const string& dir)
+{
+    return DFI->setMilpCorpusDir(dir);
+}
+
+void DFnetlist::setMilpRelaxation(bool relax)
+{
+    return DFI->setMilpRelaxation(relax);
+}
+
+void DFnetlist::setBufferCheckpoint(const string& filename, bool resume)
+{
+    return DFI->setBufferCheckpoint(filename, resume);
+}
+
+bool DFnetlist::writeThroughputs(const string& filename)
+{
+    return DFI->writeThroughputs(filename);
+}
+
 bool DFnetlist::addElasticBuffers(double Period, double BufferDelay, bool maxThroughput, double coverage)
 {
     return DFI->addElasticBuffers(Period, BufferDelay, maxThroughput, coverage);
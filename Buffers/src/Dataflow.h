@@ -143,6 +143,33 @@ public:
      */
     void setMilpSolver(const std::string& solver = "cbc");
 
+    /**
+     * @brief Sets a directory to persist the MILP models solved during optimization.
+     * @param dir Name of the directory (no models are persisted if empty).
+     */
+    void setMilpCorpusDir(const std::string& dir);
+
+    /**
+     * @brief Solves the LP relaxation of the buffer placement MILPs and rounds
+     * the solution (faster, but not optimal).
+     * @param relax True to use the relaxation.
+     */
+    void setMilpRelaxation(bool relax = true);
+
+    /**
+     * @brief Enables checkpointing of the buffer placement (addElasticBuffersBB_sc).
+     * @param filename Name of the checkpoint file (no checkpointing if empty).
+     * @param resume If asserted, the completed steps stored in the file are reused.
+     */
+    void setBufferCheckpoint(const std::string& filename, bool resume = false);
+
+    /**
+     * @brief Writes the throughput of every CFDFC claimed by the last buffer placement.
+     * @param filename Name of the file.
+     * @return True if successful, and false otherwise.
+     */
+    bool writeThroughputs(const std::string& filename);
+
     /**
      * @brief Checks that the netlist is well-formed.
      * @return True if it is well-formed and false otherwise.
@@ -610,6 +637,15 @@ public:
      */
     bool writeDot(std::ostream& s);
 
+    /**
+     * @brief Writes the VHDL of the dataflow netlist with dot2vhdl (libdot2vhdl),
+     * giving it the netlist in memory instead of a dot file.
+     * @param filename The name of the dot file the netlist would be written to,
+     * without the extension (<filename>.vhd is written).
+     * @return true if successful, and false otherwise.
+     */
+    bool writeVhdl(const std::string& filename);
+
     bool writeDotMG(const std::string& filename = "");
     bool writeDotMG(std::ostream& s);
 
@@ -3,7 +3,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
 #include <map>
 #include <sstream>
 #include <string>
@@ -382,7 +386,10 @@ public:
         }
 
         // AYA: 06/12/2023: Added a hardcode of the solver to ensure that it is gurobi not cbc!!
-        solver = "gurobi_cl";
+        if (not pinnedSolver) solver = "gurobi_cl";
+
+        // Everything between init() and solve() is accounted as model construction
+        buildTime = elapsedMs(initStamp);
 
         cout << "\n\n&&Ayaa from inside MILP_Modle.h&&\n\n";
 
@@ -395,19 +402,27 @@ public:
         } else
             outfile = createTempFilename("MILP_solution", ".gsol");
         string command = writeCommand(solver, lpfile, outfile, timelimit) + " >/dev/null 2>&1";
+        auto stamp = chrono::steady_clock::now();
         writeLP(lpfile);
+        writeTime = elapsedMs(stamp);
+
+        string corpus_entry = dumpCorpusModel(lpfile);
 
+        stamp = chrono::steady_clock::now();
         int status = system(command.c_str());
+        solveTime = elapsedMs(stamp);
 
         if (status != 0) {
             deleteTempFilename(outfile);
             setError("Error when executing " + solver + ".");
             cout << "\n\n&&Error when executing the solver!!&&\n\n";
+            dumpCorpusMeta(corpus_entry, timelimit, false);
             return false;
         }
 
         cout << "\n\n&&No error when executing the solver!!&&\n\n";
         bool opt_status; //Carmine 25.02.22 Important to check if the status optimization is OPTIMAL or SUBOPTIMAL
+        stamp = chrono::steady_clock::now();
         if (solver == "cbc") {
             cout << "AYAA: calling cbc!!" << endl;
             opt_status = readCbcSolution(outfile);
@@ -421,10 +436,13 @@ public:
             opt_status = readGurobiSolution(outfile); //Carmine 25.02.22 gurobi_cl included as MILP solver
         }
         else assert(false);
+        parseTime = elapsedMs(stamp);
 
         if(!opt_status)
             cout << "*ERROR* MILP solution is UNFEASIBLE or UNBOUNDED" << endl;
 
+        dumpCorpusMeta(corpus_entry, timelimit, true);
+
         deleteTempFilename(lpfile);
         deleteTempFilename(outfile);
         return true;
@@ -448,9 +466,206 @@ public:
         Matrix.clear();
         Name2Var.clear();
         Name2delays.clear();
+        buildTime = writeTime = solveTime = parseTime = 0;
+        initStamp = chrono::steady_clock::now();
         return find_solver(solver);
     }
 
+    /**
+     * @brief Prevents solve() from replacing the solver selected at init().
+     * @param pin True to keep the selected solver.
+     * @note Needed to compare backends on the same model (e.g., milp_replay).
+     */
+    void pinSolver(bool pin = true) {
+        pinnedSolver = pin;
+    }
+
+    /**
+     * @brief Solves the LP relaxation of the model: integer and boolean
+     * variables are treated as real variables (booleans within [0,1]).
+     * @param relax True to solve the relaxation.
+     * @note The setting survives init(), so that a model object can be reused.
+     */
+    void setRelaxation(bool relax = true) {
+        relaxed = relax;
+    }
+
+    /**
+     * @return True if solve() only solves the LP relaxation of the model.
+     */
+    bool isRelaxation() const {
+        return relaxed;
+    }
+
+    /**
+     * @return The name of the solver that will be invoked by solve().
+     */
+    const string& getSolver() const {
+        return solver;
+    }
+
+    /**
+     * @brief Defines a directory where every solved model is persisted
+     * (LP file plus metadata) to build a corpus for offline benchmarking.
+     * @param dir Name of the directory (no dump if empty).
+     * @note The setting survives init(), so that a model object can be reused.
+     */
+    void setCorpusDir(const string& dir) {
+        corpusDir = dir;
+    }
+
+    /**
+     * @brief Defines the metadata stored with the next dumped models.
+     * @param design Name of the netlist that produced the model.
+     * @param producer Name of the function that built the model.
+     * @param mg Index of the marked graph (-1 if not applicable).
+     * @param period Target clock period (0 if not applicable).
+     */
+    void setCorpusTag(const string& design, const string& producer, int mg = -1, double period = 0) {
+        corpusDesign = design;
+        corpusProducer = producer;
+        corpusMG = mg;
+        corpusPeriod = period;
+    }
+
+    /**
+     * @return Time (ms) between init() and the last call to solve(),
+     * i.e., the time to build the model.
+     */
+    double getBuildTime() const {
+        return buildTime;
+    }
+
+    /**
+     * @return Time (ms) to write the LP file in the last call to solve().
+     */
+    double getWriteTime() const {
+        return writeTime;
+    }
+
+    /**
+     * @return Time (ms) spent by the external solver in the last call to solve().
+     */
+    double getSolveTime() const {
+        return solveTime;
+    }
+
+    /**
+     * @return Time (ms) to read the solution in the last call to solve().
+     */
+    double getParseTime() const {
+        return parseTime;
+    }
+
+    /**
+     * @brief Reads a model in CPLEX LP format, as generated by writeLP.
+     * The model is added to the current one (init() should be called before).
+     * @param filename Name of the file.
+     * @return True if successful, and false otherwise.
+     * @note Only the subset of the format generated by writeLP is supported.
+     */
+    bool readLP(const string& filename) {
+        ifstream f(filename);
+        if (not f.is_open()) {
+            setError("Could not open file " + filename + ".");
+            return false;
+        }
+
+        enum {NONE, COST, ROWS, BOUNDS, GENERAL, BINARY} section = NONE;
+        string line;
+        int nline = 0;
+        while (getline(f, line)) {
+            ++nline;
+            istringstream iss(line);
+            vector<string> tokens {istream_iterator<string>{iss}, istream_iterator<string>{}};
+            if (tokens.empty()) continue;
+
+            const string& first = tokens[0];
+            if (first == "Minimize" or first == "Maximize") {
+                MinMax = first == "Minimize";
+                section = COST;
+                continue;
+            }
+            if (first == "Subject") { section = ROWS; continue; }
+            if (first == "Bounds") { section = BOUNDS; continue; }
+            if (first == "General") { section = GENERAL; continue; }
+            if (first == "Binary") { section = BINARY; continue; }
+            if (first == "End") break;
+
+            string err = filename + ":" + to_string(nline) + ": syntax error.";
+            switch (section) {
+            case COST: {
+                vecTerms terms;
+                if (not readLPTerms(tokens, 0, tokens.size(), terms)) {
+                    setError(err);
+                    return false;
+                }
+                for (auto t: terms) newCostTerm(t.first, t.second);
+                break;
+            }
+            case ROWS: {
+                int k = 0;
+                string name;
+                if (first.back() == ':') {
+                    name = first.substr(0, first.size() - 1);
+                    k = 1;
+                }
+                int op = tokens.size() - 2;
+                if (op <= k) {
+                    setError(err);
+                    return false;
+                }
+                char type;
+                if (tokens[op] == "<=") type = '<';
+                else if (tokens[op] == ">=") type = '>';
+                else if (tokens[op] == "=") type = '=';
+                else {
+                    setError(err);
+                    return false;
+                }
+                vecTerms terms;
+                if (not readLPTerms(tokens, k, op, terms)) {
+                    setError(err);
+                    return false;
+                }
+                newRow(terms, type, stod(tokens.back()), name);
+                break;
+            }
+            case BOUNDS: {
+                // lb <= name <= ub
+                if (tokens.size() != 5) {
+                    setError(err);
+                    return false;
+                }
+                Var& v = Vars[lpVar(tokens[2])];
+                v.lower_bound = stod(tokens[0]);
+                v.upper_bound = stod(tokens[4]);
+                break;
+            }
+            case GENERAL:
+            case BINARY:
+                for (const string& name: tokens) {
+                    Var& v = Vars[lpVar(name)];
+                    if (v.type == REAL) numRealVars--;
+                    if (section == GENERAL) {
+                        v.type = INTEGER;
+                        numIntegerVars++;
+                    } else {
+                        v.type = BOOLEAN;
+                        v.lower_bound = 0;
+                        v.upper_bound = 1;
+                        numBooleanVars++;
+                    }
+                }
+                break;
+            default:
+                setError(err);
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * @brief Writes a output file to save output pin timing to retrieve critical path
      * @param file_name name of the file where to save the output
@@ -516,6 +731,129 @@ private:
 
     map<int, string> Name2delays; //Carmine 07.02.2022 map containing the output delay of the blocks
 
+    bool pinnedSolver = false;  /// Do not override the solver in solve()
+    bool relaxed = false;       /// Solve the LP relaxation (no integrality)
+
+    string corpusDir;           /// Directory to dump the solved models (none if empty)
+    string corpusDesign;        /// Metadata of the dumped models
+    string corpusProducer;
+    int corpusMG = -1;
+    double corpusPeriod = 0;
+
+    chrono::steady_clock::time_point initStamp; /// Time of the last init()
+    double buildTime = 0;       /// Phase times (ms) of the last solve()
+    double writeTime = 0;
+    double solveTime = 0;
+    double parseTime = 0;
+
+    /**
+     * @brief Returns the milliseconds elapsed since a time point.
+     * @param since The time point.
+     * @return The elapsed time in ms.
+     */
+    static double elapsedMs(const chrono::steady_clock::time_point& since) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+    }
+
+    /**
+     * @brief Copies the LP file of the model into the corpus directory.
+     * @param lpfile Name of the LP file.
+     * @return The name of the corpus entry (without extension), or empty
+     * if no corpus is defined or the file could not be written.
+     */
+    string dumpCorpusModel(const string& lpfile) {
+        if (corpusDir.empty()) return "";
+
+        // Function-local counter to keep the entries of a run unique and ordered
+        static int seq = 0;
+        ostringstream entry;
+        entry << corpusDir << '/';
+        if (not corpusDesign.empty()) entry << corpusDesign << '_';
+        entry << (corpusProducer.empty() ? "milp" : corpusProducer);
+        if (corpusMG >= 0) entry << "_mg" << corpusMG;
+        entry << '_' << getpid() << '_' << seq++;
+
+        ifstream src(lpfile);
+        ofstream dst(entry.str() + ".lp");
+        if (not src.is_open() or not dst.is_open()) {
+            cerr << "Warning: could not dump MILP model into " << entry.str() << ".lp" << endl;
+            return "";
+        }
+        dst << src.rdbuf();
+        return entry.str();
+    }
+
+    /**
+     * @brief Writes the metadata of a dumped model (key=value per line).
+     * @param entry Name of the corpus entry (nothing is done if empty).
+     * @param timelimit Time limit used for the solver.
+     * @param solved Whether the solver finished and the solution was read.
+     */
+    void dumpCorpusMeta(const string& entry, int timelimit, bool solved) {
+        if (entry.empty()) return;
+        ofstream f(entry + ".meta");
+        f << "design=" << corpusDesign << endl;
+        f << "producer=" << corpusProducer << endl;
+        f << "mg=" << corpusMG << endl;
+        f << "period=" << corpusPeriod << endl;
+        f << "solver=" << solver << endl;
+        f << "timelimit=" << timelimit << endl;
+        f << "relaxed=" << relaxed << endl;
+        f << "vars=" << Vars.size() << endl;
+        f << "rows=" << Matrix.size() << endl;
+        f << "build_ms=" << buildTime << endl;
+        f << "write_ms=" << writeTime << endl;
+        f << "solve_ms=" << solveTime << endl;
+        f << "parse_ms=" << parseTime << endl;
+        if (solved) {
+            f << "status=" << stat << endl;
+            f << "obj=" << setprecision(12) << obj << endl;
+        }
+    }
+
+    /**
+     * @brief Returns the index of a variable read from an LP file.
+     * The variable is created (real, lower bound 0, unbounded) if it does not exist.
+     * @param name Name of the variable.
+     * @return The index of the variable.
+     */
+    int lpVar(const string& name) {
+        auto it = Name2Var.find(name);
+        if (it != Name2Var.end()) return it->second;
+        return newVar(name, REAL, 0.0, -1.0);
+    }
+
+    /**
+     * @brief Parses the terms of a linear expression written by writeTerms.
+     * @param tokens The tokens of the line.
+     * @param from First token of the expression.
+     * @param to Last token (not included) of the expression.
+     * @param terms The terms of the expression (output).
+     * @return True if successful, and false otherwise.
+     */
+    bool readLPTerms(const vector<string>& tokens, int from, int to, vecTerms& terms) {
+        double sign = 1.0;
+        double coeff = 1.0;
+        for (int i = from; i < to; ++i) {
+            const string& t = tokens[i];
+            if (t == "+") continue;
+            if (t == "-") {
+                sign = -sign;
+                continue;
+            }
+            bool neg = t[0] == '-';
+            char c = t[neg ? 1 : 0];
+            if (isdigit(c) or c == '.') {
+                coeff = stod(t);
+                continue;
+            }
+            if (neg) sign = -sign;
+            terms.push_back({sign * coeff, lpVar(neg ? t.substr(1) : t)});
+            sign = coeff = 1.0;
+        }
+        return sign == 1.0 and coeff == 1.0;
+    }
+
     bool find_solver(const string& s) {
 
         if (not s.empty() and s != "cbc" and s != "glpsol" and s != "gurobi_cl") { //Carmine 25.02.22 gurobi_cl included as MILP solver
@@ -728,9 +1066,15 @@ private:
         numUsedVars = 0;
         for (bool b: appeared) if (b) ++numUsedVars;
 
+        // In the relaxation, booleans are real variables in [0,1]
+        auto bounded = [this](const Var& v) {
+            if (v.type == BOOLEAN) return relaxed;
+            return v.lower_bound <= v.upper_bound;
+        };
+
         bool need_bounds = false;
         for (const Var& v: Vars) {
-            if (v.type != BOOLEAN and v.lower_bound <= v.upper_bound) {
+            if (bounded(v)) {
                 need_bounds = true;
                 break;
             }
@@ -739,12 +1083,17 @@ private:
         if (need_bounds) {
             f << "Bounds" << endl;
             for (const Var& v: Vars) {
-                if (v.type != BOOLEAN and v.lower_bound <= v.upper_bound) {
+                if (bounded(v)) {
                     f << "  " << v.lower_bound << " <= " << v.name << " <= " << v.upper_bound << endl;
                 }
             }
         }
 
+        if (relaxed) {
+            f << "End" << endl;
+            return;
+        }
+
         if (numIntegerVars > 0) {
             f << "General" << endl << ' ';
             for (const Var& v: Vars) {
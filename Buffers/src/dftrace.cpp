@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+#include "DFtrace.h"
+
+using namespace Dataflow;
+using namespace std;
+
+/*
+ * dftrace: offline analysis of the binary traces written by
+ * "buffers simulate -trace=<file>". The trace is read once, as a stream:
+ *
+ * - Throughput per window: transfers per cycle in windows of a fixed number of
+ *   cycles (all the channels, and the channel given with -channel).
+ *
+ * - Latency of a token path: the k-th transfer of the -from channel is matched
+ *   with the k-th transfer of the -to channel (the tokens of a dataflow path are
+ *   in order).
+ *
+ * - Critical cycle: every time a node sends a token, the input with the latest
+ *   transfer since its previous output is the critical one. Following the most
+ *   critical input of every node backwards leads to cycles; the one with the
+ *   longest delay around it limits the throughput. The delay of each channel of
+ *   a cycle is the mean number of cycles from its critical transfers to the
+ *   output of its destination.
+ */
+
+struct trace_input {
+    string trace;
+    long long window;
+    string channel;
+    string from, to;
+    bool dump;
+};
+
+void clear_input(trace_input& input) {
+    input.trace = "";
+    input.window = 1000;
+    input.channel = "";
+    input.from = input.to = "";
+    input.dump = false;
+}
+
+void show_help() {
+    cout << "Usage: dftrace -trace=<file> [options]" << endl;
+    cout << "-trace: trace written by buffers simulate -trace=<file>" << endl;
+    cout << "-window: number of cycles of the windows for the throughput" << endl;
+    cout << "\tdefault value is 1000" << endl;
+    cout << "-channel: channel whose throughput is reported per window (index, name or part of the name)" << endl;
+    cout << "-from, -to: channels of a token path, to report its latency" << endl;
+    cout << "-dump: print the records of the trace (cycle, channel, data)" << endl;
+}
+
+bool parse_user_input(int argc, char *argv[], trace_input& input) {
+    clear_input(input);
+    regex trace_regex("(-trace=)(.*)");
+    regex window_regex("(-window=)(.*)");
+    regex channel_regex("(-channel=)(.*)");
+    regex from_regex("(-from=)(.*)");
+    regex to_regex("(-to=)(.*)");
+    for (int i = 1; i < argc; ++i) {
+        string param = argv[i];
+        string value = param.substr(param.find("=") + 1);
+        if (regex_match(param, trace_regex)) {
+            input.trace = value;
+        } else if (regex_match(param, window_regex)) {
+            input.window = max(1LL, atoll(value.c_str()));
+        } else if (regex_match(param, channel_regex)) {
+            input.channel = value;
+        } else if (regex_match(param, from_regex)) {
+            input.from = value;
+        } else if (regex_match(param, to_regex)) {
+            input.to = value;
+        } else if (param == "-dump") {
+            input.dump = true;
+        } else {
+            cout << param << " is invalid argument" << endl;
+            return false;
+        }
+    }
+    if (input.trace.empty() or input.from.empty() != input.to.empty()) {
+        show_help();
+        return false;
+    }
+    return true;
+}
+
+// Channel given by its index, its name or a unique part of its name (-1 if not found)
+int find_channel(const vector<DFtraceChannel>& channels, const string& s) {
+    if (not s.empty() and all_of(s.begin(), s.end(), ::isdigit)) {
+        int c = atoi(s.c_str());
+        return c < channels.size() ? c : -1;
+    }
+    int found = -1;
+    for (int c = 0; c < channels.size(); ++c) {
+        if (channels[c].name == s) return c;
+        if (channels[c].name.find(s) == string::npos) continue;
+        if (found >= 0) {
+            cerr << "Channel " << s << " is ambiguous." << endl;
+            return -1;
+        }
+        found = c;
+    }
+    if (found < 0) cerr << "Channel " << s << " not found." << endl;
+    return found;
+}
+
+int main(int argc, char *argv[])
+{
+    trace_input input;
+    if (not parse_user_input(argc, argv, input)) return 1;
+
+    DFtraceReader reader;
+    if (not reader.open(input.trace)) {
+        cerr << reader.getError() << endl;
+        return 1;
+    }
+    const vector<DFtraceNode>& nodes = reader.getNodes();
+    const vector<DFtraceChannel>& channels = reader.getChannels();
+    int N = nodes.size(), C = channels.size();
+
+    int sel = -1, from = -1, to = -1;
+    if (not input.channel.empty() and (sel = find_channel(channels, input.channel)) < 0) return 1;
+    if (not input.from.empty()) {
+        from = find_channel(channels, input.from);
+        to = find_channel(channels, input.to);
+        if (from < 0 or to < 0) return 1;
+    }
+
+    // Throughput per window
+    vector<pair<long long, long long>> windows;     // Transfers (all, selected channel)
+
+    // Latency of the path
+    deque<long long> in_flight;
+    map<long long, long long> latencies;
+
+    // Critical inputs
+    vector<long long> pending_cycle(N, -1);         // Latest input transfer since the last output
+    vector<int> pending_chan(N, -1);
+    vector<long long> last_output(N, -1);
+    vector<long long> critical(C, 0), delay(C, 0);
+
+    // The records of a cycle are processed together: inputs before outputs
+    vector<int> cycle_chans;
+    long long cycle = -1, records = 0;
+    auto endCycle = [&]() {
+        for (int c: cycle_chans) {
+            int n = channels[c].dst;
+            if (n < 0) continue;
+            pending_cycle[n] = cycle;
+            pending_chan[n] = c;
+        }
+        for (int c: cycle_chans) {
+            int n = channels[c].src;
+            if (n < 0 or last_output[n] == cycle) continue;
+            last_output[n] = cycle;
+            if (pending_chan[n] < 0) continue;
+            critical[pending_chan[n]]++;
+            delay[pending_chan[n]] += cycle - pending_cycle[n];
+            pending_chan[n] = -1;
+            pending_cycle[n] = -1;
+        }
+        cycle_chans.clear();
+    };
+
+    DFtraceRecord r;
+    while (reader.next(r)) {
+        if (r.channel < 0 or r.channel >= C) {
+            cerr << "Wrong channel in the trace: " << r.channel << endl;
+            return 1;
+        }
+        if (r.cycle != cycle) {
+            endCycle();
+            cycle = r.cycle;
+        }
+        cycle_chans.push_back(r.channel);
+        records++;
+        if (input.dump) {
+            cout << r.cycle << ' ' << r.channel;
+            if (reader.hasData()) cout << ' ' << r.data;
+            cout << "  " << channels[r.channel].name << endl;
+        }
+
+        long long w = r.cycle / input.window;
+        if (w >= windows.size()) windows.resize(w + 1, {0, 0});
+        windows[w].first++;
+        if (r.channel == sel) windows[w].second++;
+
+        if (r.channel == from) in_flight.push_back(r.cycle);
+        if (r.channel == to and not in_flight.empty()) {
+            latencies[r.cycle - in_flight.front()]++;
+            in_flight.pop_front();
+        }
+    }
+    endCycle();
+    if (not reader.getError().empty()) {
+        cerr << reader.getError() << endl;
+        return 1;
+    }
+
+    struct stat st;
+    long long bytes = stat(input.trace.c_str(), &st) == 0 ? st.st_size : 0;
+    cout << "Trace: " << records << " transfers, " << cycle + 1 << " cycles, " << N << " nodes, " << C
+         << " channels, " << bytes << " bytes (" << fixed << setprecision(2)
+         << (records > 0 ? (double) bytes / records : 0) << " bytes/transfer)" << endl;
+
+    cout << endl << "Throughput per window of " << input.window << " cycles (transfers/cycle";
+    if (sel >= 0) cout << ", " << channels[sel].name;
+    cout << "):" << endl;
+    for (long long w = 0; w < windows.size(); ++w) {
+        long long len = min(input.window, cycle + 1 - w * input.window);
+        cout << setw(12) << w * input.window << setw(10) << setprecision(3) << (double) windows[w].first / len;
+        if (sel >= 0) cout << setw(8) << (double) windows[w].second / len;
+        cout << endl;
+    }
+
+    if (from >= 0) {
+        long long count = 0, sum = 0;
+        for (auto& l: latencies) {
+            count += l.second;
+            sum += l.first * l.second;
+        }
+        cout << endl << "Latency from " << channels[from].name << " to " << channels[to].name << ": ";
+        if (count == 0) cout << "no tokens" << endl;
+        else {
+            cout << count << " tokens, min " << latencies.begin()->first << ", mean " << setprecision(2)
+                 << (double) sum / count << ", max " << latencies.rbegin()->first << " cycles" << endl;
+            for (auto& l: latencies) cout << setw(12) << l.first << setw(12) << l.second << endl;
+        }
+        if (not in_flight.empty()) cout << in_flight.size() << " tokens did not reach " << channels[to].name << endl;
+    }
+
+    // Most critical input of every node: the critical inputs form a graph with
+    // at most one predecessor per node, and its cycles are the candidates
+    vector<int> pred(N, -1);
+    for (int c = 0; c < C; ++c) {
+        int n = channels[c].dst;
+        if (n >= 0 and channels[c].src >= 0 and critical[c] > 0 and
+            (pred[n] < 0 or critical[c] > critical[pred[n]])) pred[n] = c;
+    }
+    auto meanDelay = [&](int c) { return (double) delay[c] / critical[c]; };
+
+    // The critical cycle is the candidate with the longest delay around it
+    vector<int> best_cycle, walk(N, -1);
+    double best_total = -1;
+    for (int first = 0; first < N; ++first) {
+        int n = first;
+        while (n >= 0 and walk[n] < 0) {
+            walk[n] = first;
+            n = pred[n] < 0 ? -1 : channels[pred[n]].src;
+        }
+        if (n < 0 or walk[n] != first) continue;    // No new cycle in this walk
+        vector<int> cycle_path;
+        double total = 0;
+        int m = n;
+        do {
+            cycle_path.push_back(pred[m]);
+            total += meanDelay(pred[m]);
+            m = channels[pred[m]].src;
+        } while (m != n);
+        if (total > best_total) {
+            best_total = total;
+            best_cycle = cycle_path;
+        }
+    }
+    if (best_cycle.empty()) {
+        cout << endl << "Critical cycle: not found (the critical inputs form no cycle)" << endl;
+        return 0;
+    }
+
+    reverse(best_cycle.begin(), best_cycle.end());
+    cout << endl << "Critical cycle (critical transfers, mean delay, latency of the destination):" << endl;
+    for (int ch: best_cycle) {
+        cout << setw(10) << critical[ch] << setw(8) << setprecision(2) << meanDelay(ch) << setw(4)
+             << nodes[channels[ch].dst].latency << "  " << channels[ch].name << endl;
+    }
+    cout << "Cycle length: " << best_cycle.size() << " channels, " << setprecision(2) << best_total
+         << " cycles per token around the cycle" << endl;
+    return 0;
+}
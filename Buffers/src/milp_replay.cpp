@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+#include "MILP_Model.h"
+
+using namespace std;
+
+/*
+ * milp_replay: solves a corpus of MILP models dumped by "buffers -dump_milp=<dir>"
+ * and reports the time of each phase and the objective, so that changes in
+ * Milp_Model, in the formulation or in the solver can be evaluated offline.
+ *
+ * Each entry of the corpus is a pair of files: <entry>.lp (CPLEX LP format)
+ * and <entry>.meta (key=value lines with the producer, MG index, period and
+ * the results obtained when the model was dumped).
+ */
+
+struct replay_input {
+    string corpus;
+    string solver;
+    string filter;
+    int timeout;
+    int repeat;
+};
+
+void clear_input(replay_input& input) {
+    input.corpus = "";
+    input.solver = "cbc";
+    input.filter = "";
+    input.timeout = -1;
+    input.repeat = 1;
+}
+
+void show_help() {
+    cout << "Usage: milp_replay -corpus=<dir> [options]" << endl;
+    cout << "-corpus: directory with the models dumped by buffers -dump_milp=<dir>" << endl;
+    cout << "-solver: the milp solver (cbc, glpsol or gurobi_cl)" << endl;
+    cout << "\tdefault value is cbc" << endl;
+    cout << "-timeout: the milp timeout in seconds. If -1, no limit will be applied" << endl;
+    cout << "\tdefault value is -1" << endl;
+    cout << "-repeat: number of times each model is solved (the best time is reported)" << endl;
+    cout << "\tdefault value is 1" << endl;
+    cout << "-filter: only replay the entries whose name contains this string" << endl;
+    cout << "\tdefault value is \"\" (all entries)" << endl;
+}
+
+bool parse_user_input(int argc, char *argv[], replay_input& input) {
+    clear_input(input);
+    regex corpus_regex("(-corpus=)(.*)");
+    regex solver_regex("(-solver=)(.*)");
+    regex filter_regex("(-filter=)(.*)");
+    regex timeout_regex("(-timeout=)(.*)");
+    regex repeat_regex("(-repeat=)(.*)");
+    for (int i = 1; i < argc; ++i) {
+        string param = argv[i];
+        string value = param.substr(param.find("=") + 1);
+        if (regex_match(param, corpus_regex)) input.corpus = value;
+        else if (regex_match(param, solver_regex)) input.solver = value;
+        else if (regex_match(param, filter_regex)) input.filter = value;
+        else if (regex_match(param, timeout_regex)) input.timeout = atoi(value.c_str());
+        else if (regex_match(param, repeat_regex)) input.repeat = max(1, atoi(value.c_str()));
+        else {
+            cerr << param << " is invalid argument" << endl;
+            return false;
+        }
+    }
+    return not input.corpus.empty();
+}
+
+/**
+ * @brief Returns the names of the entries of the corpus (sorted, without extension).
+ * @param dir Directory of the corpus.
+ * @param filter Only entries containing this string are returned.
+ * @return The names of the entries.
+ */
+vector<string> corpusEntries(const string& dir, const string& filter) {
+    vector<string> entries;
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr) return entries;
+    while (struct dirent* e = readdir(d)) {
+        string name = e->d_name;
+        if (name.size() <= 3 or name.substr(name.size() - 3) != ".lp") continue;
+        name = name.substr(0, name.size() - 3);
+        if (name.find(filter) != string::npos) entries.push_back(name);
+    }
+    closedir(d);
+    sort(entries.begin(), entries.end());
+    return entries;
+}
+
+/**
+ * @brief Reads the metadata of a corpus entry.
+ * @param filename Name of the .meta file.
+ * @return Map key -> value (empty if the file does not exist).
+ */
+map<string, string> readMeta(const string& filename) {
+    map<string, string> meta;
+    ifstream f(filename);
+    string line;
+    while (getline(f, line)) {
+        size_t eq = line.find('=');
+        if (eq != string::npos) meta[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+    return meta;
+}
+
+int main(int argc, char *argv[])
+{
+    replay_input input;
+    if (not parse_user_input(argc, argv, input)) {
+        show_help();
+        return 1;
+    }
+
+    vector<string> entries = corpusEntries(input.corpus, input.filter);
+    if (entries.empty()) {
+        cerr << "No models found in " << input.corpus << "." << endl;
+        return 1;
+    }
+
+    cout << "Replaying " << entries.size() << " models with " << input.solver;
+    if (input.timeout > 0) cout << " (timeout " << input.timeout << " s)";
+    cout << endl << endl;
+
+    printf("%-48s %-30s %4s %6s %7s %7s %9s %9s %9s %9s %10s %14s %14s\n",
+           "model", "producer", "mg", "period", "vars", "rows",
+           "build_ms", "write_ms", "solve_ms", "parse_ms", "status", "obj", "recorded_obj");
+
+    double total_build = 0, total_write = 0, total_solve = 0, total_parse = 0;
+    int failures = 0, mismatches = 0;
+
+    for (const string& entry: entries) {
+        string base = input.corpus + "/" + entry;
+        map<string, string> meta = readMeta(base + ".meta");
+
+        // Keep the best time of each phase among the repetitions
+        double build = -1, write = -1, solve = -1, parse = -1;
+        Milp_Model milp;
+        bool ok = true;
+        for (int r = 0; r < input.repeat and ok; ++r) {
+            ok = milp.init(input.solver);
+            milp.pinSolver();
+            ok = ok and milp.readLP(base + ".lp");
+            ok = ok and milp.solve(input.timeout);
+            if (not ok) break;
+            auto best = [](double& t, double v) { if (t < 0 or v < t) t = v; };
+            best(build, milp.getBuildTime());
+            best(write, milp.getWriteTime());
+            best(solve, milp.getSolveTime());
+            best(parse, milp.getParseTime());
+        }
+
+        string status = "ERROR";
+        Milp_Model::Status stat = milp.getStatus();
+        if (ok) {
+            if (stat == Milp_Model::OPTIMAL) status = "OPTIMAL";
+            else if (stat == Milp_Model::NONOPTIMAL) status = "NONOPTIMAL";
+            else if (stat == Milp_Model::UNFEASIBLE) status = "UNFEASIBLE";
+            else if (stat == Milp_Model::UNBOUNDED) status = "UNBOUNDED";
+            else status = "UNKNOWN";
+        }
+        bool solved = ok and (stat == Milp_Model::OPTIMAL or stat == Milp_Model::NONOPTIMAL);
+        if (not solved) failures++;
+
+        string recorded = meta.count("obj") ? meta["obj"] : "-";
+        if (solved and recorded != "-" and abs(stod(recorded) - milp.getObj()) > 1e-6 * max(1.0, abs(milp.getObj())))
+            mismatches++;
+
+        printf("%-48s %-30s %4s %6s %7d %7d %9.1f %9.1f %9.1f %9.1f %10s %14.6g %14s\n",
+               entry.c_str(), meta["producer"].c_str(),
+               meta.count("mg") ? meta["mg"].c_str() : "-",
+               meta.count("period") ? meta["period"].c_str() : "-",
+               milp.numVariables(), milp.numConstraints(),
+               build, write, solve, parse, status.c_str(),
+               solved ? milp.getObj() : 0.0, recorded.c_str());
+        if (not ok) cerr << "  " << entry << ": " << milp.getError() << endl;
+
+        if (ok) {
+            total_build += build;
+            total_write += write;
+            total_solve += solve;
+            total_parse += parse;
+        }
+    }
+
+    cout << endl;
+    printf("Total time [ms]: build %.1f, write %.1f, solve %.1f, parse %.1f\n",
+           total_build, total_write, total_solve, total_parse);
+    printf("Models: %zu, failures: %d, objective mismatches: %d\n", entries.size(), failures, mismatches);
+
+    return failures > 0 ? 1 : 0;
+}
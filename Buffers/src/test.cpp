@@ -7,7 +7,17 @@
 #include "MILP_Model.h"
 //#include "Dataflow.h"
 #include "DFnetlist.h"
+#include "DFsim.h"
+#include "DFcosim.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <set>
 #include <sstream>
+#include <sys/stat.h>
 
 
 using namespace std;
@@ -61,6 +71,11 @@ int main_help()
     cerr << "Available commands:" << endl;
     cerr << "  dataflow:      handling dataflow netlists." << endl;
     cerr << "  buffers:       add elastic buffers to a netlist." << endl;
+    cerr << "  simulate:      cycle-accurate simulation of a buffered netlist." << endl;
+    cerr << "  verify:        validate the throughput of the buffer placement by simulation." << endl;
+    cerr << "  cosim:         compare the simulation of a netlist with its C kernel on test vectors." << endl;
+    cerr << "  trim:          remove the buffer slots that do not improve the simulated cycles." << endl;
+    cerr << "  tags:          choose the number of tags of a tagged netlist by simulation." << endl;
     cerr << "  async_synth:   synthesize an asynchronous circuit." << endl;
     cerr << "  solveCSC:      solve state encoding in an asynchronous circuit." << endl;
     cerr << "  hideSignals:   hide signals in an asynchronous specification." << endl;
@@ -80,6 +95,10 @@ struct user_input {
     double first;
     int timeout;
     bool set;
+    string dump_milp;
+    bool resume;
+    bool relax;
+    bool vhdl;
 };
 
 void clear_input(user_input& input) {
@@ -90,6 +109,10 @@ void clear_input(user_input& input) {
     input.period = 5;
     input.timeout = 180;
     input.solver = "cbc";
+    input.dump_milp = "";
+    input.resume = false;
+    input.relax = false;
+    input.vhdl = false;
 }
 
 void print_input(const user_input& input) {
@@ -100,6 +123,10 @@ void print_input(const user_input& input) {
     cout << "timeout: " << input.timeout << endl;
     cout << "set optimization: " << (input.set ? "true" : "false") << endl;
     cout << "first MG optimization: " << (input.first ? "true" : "false") << endl;
+    if (not input.dump_milp.empty()) cout << "MILP corpus directory: " << input.dump_milp << endl;
+    cout << "resume from checkpoint: " << (input.resume ? "true" : "false") << endl;
+    cout << "LP relaxation: " << (input.relax ? "true" : "false") << endl;
+    cout << "write VHDL: " << (input.vhdl ? "true" : "false") << endl;
     cout << "****************************************" << endl;
 }
 void parse_user_input(const vecParams& params, user_input& input) {
@@ -111,6 +138,10 @@ void parse_user_input(const vecParams& params, user_input& input) {
     regex set_regex("(-set=)(.*)");
     regex solver_regex("(-solver=)(.*)");
     regex first_regex("(-first=)(.*)");
+    regex dump_milp_regex("(-dump_milp=)(.*)");
+    regex resume_regex("(-resume)(=.*)?");
+    regex relax_regex("(-relax)(=.*)?");
+    regex vhdl_regex("(-vhdl)(=.*)?");
     for (auto param: params) {
         if (regex_match(param, period_regex)) {
             input.period = atof(param.substr(param.find("=") + 1).c_str());
@@ -128,6 +159,14 @@ void parse_user_input(const vecParams& params, user_input& input) {
         } else if (regex_match(param, first_regex)) {
             string tmp = param.substr(param.find("=") + 1);
             input.first = (tmp == "false") ? false : true;
+        } else if (regex_match(param, dump_milp_regex)) {
+            input.dump_milp = param.substr(param.find("=") + 1);
+        } else if (regex_match(param, resume_regex)) {
+            input.resume = param.find("=") == string::npos or param.substr(param.find("=") + 1) != "false";
+        } else if (regex_match(param, relax_regex)) {
+            input.relax = param.find("=") == string::npos or param.substr(param.find("=") + 1) != "false";
+        } else if (regex_match(param, vhdl_regex)) {
+            input.vhdl = param.find("=") == string::npos or param.substr(param.find("=") + 1) != "false";
         } else {
             cout << param << " is invalid argument" << endl;
             assert(false);
@@ -138,6 +177,7 @@ void parse_user_input(const vecParams& params, user_input& input) {
 void show_help_shab() {
     cout << "-filename: <filename>_graph.dot and <filename>_bbgraph.dot should contain DFC and CFG respectively" << endl;
     cout << "\toptimized output will be writen to <filename>_graph_buf.dot and <filename>_bbgraph_buf.dot" << endl;
+    cout << "\tthe throughput of every CFDFC is written to <filename>_throughput.txt (see verify)" << endl;
     cout << "\tdefault value is \"dataflow\"" << endl;
     cout << "-period: the clock period" << endl;
     cout << "\tdefault value is 3" << endl;
@@ -151,6 +191,20 @@ void show_help_shab() {
     cout << "\tdefault value is false" << endl;
     cout << "-first: whether the milp should only consider the throughput for the first MG or not" << endl;
     cout << "\tdefault value is false" << endl;
+    cout << "-dump_milp: directory where every solved MILP model is stored (LP file and .meta)" << endl;
+    cout << "\tthe corpus can be solved offline with bin/milp_replay" << endl;
+    cout << "\tdefault value is \"\" (no dump)" << endl;
+    cout << "-resume: resume the buffer placement from <filename>_buffers.ckpt, skipping the" << endl;
+    cout << "\tCFDFCs and MGs completed by a previous (interrupted) run with the same period and delay" << endl;
+    cout << "\tthe checkpoint is always written when set optimization is applied" << endl;
+    cout << "\tdefault value is false" << endl;
+    cout << "-relax: solve the LP relaxation of the MILP of each MG and round the solution" << endl;
+    cout << "\t(faster but not optimal; the throughput gap versus the LP bound is reported)" << endl;
+    cout << "\tonly applied with set optimization" << endl;
+    cout << "\tdefault value is false" << endl;
+    cout << "-vhdl: also write <filename>_graph_buf.vhd (dot2vhdl on the buffered netlist in memory," << endl;
+    cout << "\twithout reading <filename>_graph_buf.dot), with its LSQs and synthesis scripts" << endl;
+    cout << "\tdefault value is false" << endl;
 }
 
 int main_shab(const vecParams& params){
@@ -186,6 +240,13 @@ int main_shab(const vecParams& params){
 	cout << "\nAya: Before calling DF.setMilpSolver!\n";
     DF.setMilpSolver(input.solver);
 	cout << "\nAya: After returning from DF.setMilpSolver!\n";
+    DF.setBufferCheckpoint(input.graph_name + "_buffers.ckpt", input.resume);
+    DF.setMilpRelaxation(input.relax);
+
+    if (not input.dump_milp.empty()) {
+        mkdir(input.dump_milp.c_str(), 0755); // Fails harmlessly if it already exists
+        DF.setMilpCorpusDir(input.dump_milp);
+    }
 
     bool stat;
 
@@ -200,9 +261,976 @@ int main_shab(const vecParams& params){
    }
     if (stat) {
         DF.instantiateElasticBuffers();
+        DF.writeThroughputs(input.graph_name + "_throughput.txt");
     }
     DF.writeDot(input.graph_name + "_graph_buf.dot");
     DF.writeDotBB(input.graph_name + "_bbgraph_buf.dot");
+    if (input.vhdl and not DF.writeVhdl(input.graph_name + "_graph_buf")) {
+        cerr << "The VHDL of " << input.graph_name << "_graph_buf could not be written" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+struct sim_input {
+    string graph_name;      // Base name of the files of the circuit
+    string graph_file;      // Buffered netlist (<graph_name>_graph_buf.dot or a .dot file)
+    long long cycles;
+    vector<pair<string, long long>> args;
+    string mem_in;
+    string mem_out;
+    string compile_file;    // Only write the compiled simulator
+    bool compiled;          // Run the compiled simulator
+    bool check;             // Run both simulators and compare them
+    int threads;            // Threads of the parallel simulation
+    string stats_file;      // Bottleneck report
+    string heat_file;       // Dot file with heat colors
+    int top;                // Entries of each ranking of the bottleneck report
+    string trace_file;      // Binary trace of the transfers
+    bool trace_data;        // Record the data in the trace
+    string lsq_depths;      // Depths of the LSQ queues (for dot2vhdl)
+};
+
+void show_help_simulate() {
+    cout << "-filename: <filename>_graph_buf.dot contains the buffered DFC (a file ending with .dot is read as is)" << endl;
+    cout << "\tthe other files (e.g., <filename>_sim.cpp) are named without .dot and _graph_buf" << endl;
+    cout << "\tdefault value is \"dataflow\"" << endl;
+    cout << "-cycles: maximum number of simulated cycles" << endl;
+    cout << "\tdefault value is 1000000" << endl;
+    cout << "-args: values of the function arguments (entry blocks), e.g., -args=n=100,k=3" << endl;
+    cout << "\tdefault value is 0 for all arguments" << endl;
+    cout << "-mem: file with the initial contents of the memories" << endl;
+    cout << "\tone line per memory: <name> <word0> <word1> ... (words with a decimal point are floats)" << endl;
+    cout << "-mem_out: file where the final contents of the memories are written" << endl;
+    cout << "-compile: writes a C++ program that simulates the circuit (compiled simulation), e.g., -compile=sim.cpp" << endl;
+    cout << "-compiled: simulates with the compiled program (<filename>_sim.cpp, built with $CXX, default g++)" << endl;
+    cout << "-check: runs the interpreted and the compiled simulations and compares their results" << endl;
+    cout << "\t-compile, -compiled and -check are not supported for netlists with LSQs or tagged components" << endl;
+    cout << "\twith -threads, compares the parallel and the sequential simulations" << endl;
+    cout << "-threads: number of threads of the simulation (the netlist is partitioned at the opaque buffers)" << endl;
+    cout << "\tdefault value is 1" << endl;
+    cout << "-stats: file with the bottleneck report (back pressure, starvation, utilization, occupancy)" << endl;
+    cout << "\t\"-\" writes the report to the standard output" << endl;
+    cout << "-heat: dot file of the netlist with heat colors (back pressure of the channels, utilization" << endl;
+    cout << "\tof the operators and occupancy of the buffers and memories)" << endl;
+    cout << "-top: number of entries of each ranking of the bottleneck report (0: all)" << endl;
+    cout << "\tdefault value is 20" << endl;
+    cout << "-trace: binary trace of the transfers, to be analyzed with bin/dftrace (the simulation is sequential)" << endl;
+    cout << "-trace_data: also record the data of the transfers in the trace" << endl;
+    cout << "-lsq_depths: file with the depth of the queues of each LSQ (peak occupancy), for dot2vhdl -lsq_depths" << endl;
+}
+
+bool parse_sim_input(const vecParams& params, sim_input& input) {
+    input.graph_name = "dataflow";
+    input.cycles = 1000000;
+    input.threads = 1;
+    input.top = 20;
+    regex name_regex("(-filename=)(.*)");
+    regex cycles_regex("(-cycles=)(.*)");
+    regex args_regex("(-args=)(.*)");
+    regex mem_regex("(-mem=)(.*)");
+    regex mem_out_regex("(-mem_out=)(.*)");
+    regex compile_regex("(-compile=)(.*)");
+    regex threads_regex("(-threads=)(.*)");
+    regex stats_regex("(-stats=)(.*)");
+    regex heat_regex("(-heat=)(.*)");
+    regex top_regex("(-top=)(.*)");
+    regex trace_regex("(-trace=)(.*)");
+    regex lsq_regex("(-lsq_depths=)(.*)");
+    for (auto param: params) {
+        string value = param.substr(param.find("=") + 1);
+        if (regex_match(param, name_regex)) {
+            input.graph_name = value;
+        } else if (regex_match(param, cycles_regex)) {
+            input.cycles = atoll(value.c_str());
+        } else if (regex_match(param, args_regex)) {
+            stringstream ss(value);
+            string arg;
+            while (getline(ss, arg, ',')) {
+                size_t eq = arg.find("=");
+                if (eq == string::npos) {
+                    cout << arg << " is invalid argument value" << endl;
+                    return false;
+                }
+                input.args.push_back({arg.substr(0, eq), strtoll(arg.substr(eq + 1).c_str(), nullptr, 0)});
+            }
+        } else if (regex_match(param, mem_regex)) {
+            input.mem_in = value;
+        } else if (regex_match(param, mem_out_regex)) {
+            input.mem_out = value;
+        } else if (regex_match(param, compile_regex)) {
+            input.compile_file = value;
+        } else if (regex_match(param, threads_regex)) {
+            input.threads = atoi(value.c_str());
+        } else if (regex_match(param, stats_regex)) {
+            input.stats_file = value;
+        } else if (regex_match(param, heat_regex)) {
+            input.heat_file = value;
+        } else if (regex_match(param, top_regex)) {
+            input.top = atoi(value.c_str());
+        } else if (regex_match(param, trace_regex)) {
+            input.trace_file = value;
+        } else if (regex_match(param, lsq_regex)) {
+            input.lsq_depths = value;
+        } else if (param == "-trace_data") {
+            input.trace_data = true;
+        } else if (param == "-compiled") {
+            input.compiled = true;
+        } else if (param == "-check") {
+            input.check = true;
+        } else {
+            cout << param << " is invalid argument" << endl;
+            return false;
+        }
+    }
+    if (input.compiled and not input.check and not (input.stats_file.empty() and input.heat_file.empty() and
+                                                    input.trace_file.empty() and input.lsq_depths.empty())) {
+        cout << "-stats, -heat, -trace and -lsq_depths require the interpreted simulation" << endl;
+        return false;
+    }
+
+    // A filename ending with .dot is the netlist itself; the other files of the circuit
+    // (_throughput.txt, _sim.cpp, ...) are named after it without .dot and _graph_buf.
+    string& name = input.graph_name;
+    if (name.size() >= 4 and name.substr(name.size() - 4) == ".dot") {
+        input.graph_file = name;
+        name = name.substr(0, name.size() - 4);
+        const string suffix = "_graph_buf";
+        if (name.size() > suffix.size() and name.substr(name.size() - suffix.size()) == suffix)
+            name = name.substr(0, name.size() - suffix.size());
+    } else input.graph_file = name + "_graph_buf.dot";
+    return true;
+}
+
+string shell_quote(const string& s) {
+    string q = "'";
+    for (char ch: s) {
+        if (ch == '\'') q += "'\\''";
+        else q += ch;
+    }
+    return q + "'";
+}
+
+// Generates, builds and runs the compiled simulator of a netlist. The report is returned
+// in a string and the time of the simulation (without the build) in milliseconds.
+bool run_compiled_sim(const DFsim& sim, const sim_input& input, const string& mem_out,
+                      string& report, double& ms) {
+    string source = input.graph_name + "_sim.cpp";
+    string binary = input.graph_name + "_sim";
+    if (not sim.writeCompiled(source)) {
+        cerr << "File " << source << " could not be written." << endl;
+        return false;
+    }
+
+    const char* cxx = getenv("CXX");
+    string build = string(cxx ? cxx : "g++") + " -O2 -o " + shell_quote(binary) + " " + shell_quote(source);
+    if (system(build.c_str())) {
+        cerr << "Error when compiling " << source << "." << endl;
+        return false;
+    }
+
+    string run = (binary.find('/') == string::npos ? "./" : "") + shell_quote(binary);
+    run += " -cycles=" + to_string(input.cycles);
+    if (not input.args.empty()) {
+        string args;
+        for (auto& arg: input.args) args += (args.empty() ? "" : ",") + arg.first + "=" + to_string(arg.second);
+        run += " " + shell_quote("-args=" + args);
+    }
+    if (not input.mem_in.empty()) run += " " + shell_quote("-mem=" + input.mem_in);
+    if (not mem_out.empty()) run += " " + shell_quote("-mem_out=" + mem_out);
+
+    auto stamp = chrono::steady_clock::now();
+    FILE* pipe = popen(run.c_str(), "r");
+    if (pipe == nullptr) {
+        cerr << "Error when executing " << binary << "." << endl;
+        return false;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) report.append(buffer, n);
+    pclose(pipe);
+    ms = chrono::duration<double, milli>(chrono::steady_clock::now() - stamp).count();
+    return true;
+}
+
+int main_simulate(const vecParams& params) {
+    if (params.size() == 1 && params[0] == "-help") {
+        show_help_simulate();
+        return 1;
+    }
+
+    sim_input input{};
+    if (not parse_sim_input(params, input)) return 1;
+
+    DFnetlist DF(input.graph_file);
+    if (DF.hasError()) {
+        cerr << DF.getError() << endl;
+        return 1;
+    }
+
+    // The elastic buffers are the Buffer blocks of the netlist (they are already instantiated
+    // in _graph_buf.dot files). Do not call instantiateElasticBuffers: the reader annotates the
+    // output channels of the buffers with their slots.
+    DFsim sim(DF);
+    if (sim.hasError()) {
+        cerr << sim.getError() << endl;
+        return 1;
+    }
+
+    for (auto& arg: input.args) {
+        if (not sim.setArgument(arg.first, arg.second)) {
+            cerr << "Argument " << arg.first << " not found." << endl;
+            return 1;
+        }
+    }
+    if (not input.mem_in.empty() and not sim.readMemories(input.mem_in)) {
+        cerr << sim.getError() << endl;
+        return 1;
+    }
+
+    if ((input.compiled or input.check or not input.compile_file.empty()) and sim.isTagged()) {
+        cerr << "The compiled simulation does not support tagged netlists." << endl;
+        return 1;
+    }
+    if ((input.compiled or input.check or not input.compile_file.empty()) and sim.hasLSQ()) {
+        cerr << "The compiled simulation does not support LSQs." << endl;
+        return 1;
+    }
+
+    if (not input.compile_file.empty()) {
+        if (not sim.writeCompiled(input.compile_file)) {
+            cerr << "File " << input.compile_file << " could not be written." << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // With -check, the other simulation (compiled or sequential) writes the memories
+    // to <mem_out>.compiled or <mem_out>.sequential
+    bool parallel = input.threads > 1 and not input.compiled;
+    string other_report, other_mem_out = input.mem_out;
+    double other_ms = 0;
+    if (input.compiled or (input.check and not parallel)) {
+        if (input.check and not input.mem_out.empty()) other_mem_out += ".compiled";
+        if (not run_compiled_sim(sim, input, other_mem_out, other_report, other_ms)) return 1;
+        if (not input.check) {
+            cout << other_report;
+            return other_report.find("Simulation status: finished") == 0 ? 0 : 1;
+        }
+    }
+
+    int partitions = 1;
+    if (parallel) {
+        if (input.check) {
+            DFsim sequential(sim);
+            auto stamp = chrono::steady_clock::now();
+            sequential.run(input.cycles);
+            other_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - stamp).count();
+            ostringstream report;
+            sequential.writeReport(report);
+            other_report = report.str();
+            if (not input.mem_out.empty()) {
+                other_mem_out += ".sequential";
+                sequential.writeMemories(other_mem_out);
+            }
+        }
+        partitions = sim.setThreads(input.threads);
+    }
+
+    DFtraceWriter trace;
+    if (not input.trace_file.empty() and not sim.startTrace(trace, input.trace_file, input.trace_data)) {
+        cerr << "File " << input.trace_file << " could not be written." << endl;
+        return 1;
+    }
+
+    auto stamp = chrono::steady_clock::now();
+    sim.run(input.cycles);
+    double sim_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - stamp).count();
+    if (sim.hasError()) cerr << sim.getError() << endl;
+    if (not sim.stopTrace()) cerr << "File " << input.trace_file << " could not be written." << endl;
+    ostringstream report;
+    sim.writeReport(report);
+    cout << report.str();
+
+    if (not input.mem_out.empty() and not sim.writeMemories(input.mem_out)) {
+        cerr << "File " << input.mem_out << " could not be written." << endl;
+        return 1;
+    }
+
+    if (input.stats_file == "-") {
+        cout << endl;
+        sim.writeBottlenecks(cout, input.top);
+    } else if (not input.stats_file.empty()) {
+        ofstream stats(input.stats_file);
+        sim.writeBottlenecks(stats, input.top);
+        if (not stats) {
+            cerr << "File " << input.stats_file << " could not be written." << endl;
+            return 1;
+        }
+    }
+    if (not input.heat_file.empty() and not sim.writeHeatDot(DF, input.heat_file)) {
+        cerr << "File " << input.heat_file << " could not be written." << endl;
+        return 1;
+    }
+    if (not input.lsq_depths.empty() and not sim.writeLSQDepths(input.lsq_depths)) {
+        cerr << "File " << input.lsq_depths << " could not be written." << endl;
+        return 1;
+    }
+
+    if (input.check) {
+        string modes = parallel ? "parallel and sequential" : "interpreted and compiled";
+        bool same = report.str() == other_report;
+        if (not same) cerr << "Check: the reports of the " << modes << " simulations differ." << endl;
+        if (not input.mem_out.empty()) {
+            ifstream f1(input.mem_out), f2(other_mem_out);
+            stringstream m1, m2;
+            m1 << f1.rdbuf();
+            m2 << f2.rdbuf();
+            if (m1.str() != m2.str()) {
+                cerr << "Check: the memories of the " << modes << " simulations differ ("
+                     << input.mem_out << ", " << other_mem_out << ")." << endl;
+                same = false;
+            }
+        }
+        cout << endl << "Check: " << (same ? "passed" : "FAILED") << endl;
+        if (parallel) {
+            cout << "Sequential: " << fixed << setprecision(1) << other_ms << " ms, parallel (" << partitions
+                 << " partitions): " << sim_ms << " ms (speedup " << setprecision(2)
+                 << (sim_ms > 0 ? other_ms / sim_ms : 0) << ")" << endl;
+        } else {
+            cout << "Interpreted: " << fixed << setprecision(1) << sim_ms << " ms, compiled: "
+                 << other_ms << " ms (speedup " << setprecision(2)
+                 << (other_ms > 0 ? sim_ms / other_ms : 0) << ")" << endl;
+        }
+        if (not same) return 1;
+    } else if (parallel) {
+        cout << endl << "Parallel simulation: " << partitions << " partitions, " << fixed << setprecision(1)
+             << sim_ms << " ms" << endl;
+    }
+    return sim.getStatus() == DFsim::FINISHED ? 0 : 1;
+}
+
+// Throughput of a CFDFC claimed by the buffer placement (a line of <filename>_throughput.txt)
+struct cfdfc_claim {
+    int index;
+    double throughput;
+    double freq;
+    set<int> bbs;
+    set<pair<int, int>> arcs;
+};
+
+bool read_throughputs(const string& filename, vector<cfdfc_claim>& claims) {
+    ifstream f(filename);
+    if (not f.is_open()) return false;
+    string line, key;
+    while (getline(f, line)) {
+        istringstream iss(line);
+        if (not (iss >> key) or key != "cfdfc") continue;
+        cfdfc_claim claim;
+        int n;
+        if (not (iss >> claim.index >> claim.throughput >> claim.freq >> n)) return false;
+        for (int i = 0, bb; i < n and iss >> bb; ++i) claim.bbs.insert(bb);
+        if (not (iss >> n)) return false;
+        for (int i = 0, src, dst; i < n and iss >> src >> dst; ++i) claim.arcs.insert({src, dst});
+        claims.push_back(claim);
+    }
+    return true;
+}
+
+void show_help_verify() {
+    cout << "Simulates <filename>_graph_buf.dot and compares the steady-state throughput of every CFDFC" << endl;
+    cout << "with the one claimed by the buffer placement (<filename>_throughput.txt, written by buffers)" << endl;
+    cout << "-tolerance: maximum relative deviation between the simulated and the claimed throughputs" << endl;
+    cout << "\tdefault value is 0.05" << endl;
+    cout << "The simulation options are the ones of simulate (-compile, -compiled and -check are not supported):" << endl;
+    show_help_simulate();
+}
+
+double median(vector<double> v) {
+    if (v.empty()) return 0;
+    sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+int main_verify(const vecParams& params) {
+    if (params.size() == 1 && params[0] == "-help") {
+        show_help_verify();
+        return 1;
+    }
+
+    double tolerance = 0.05;
+    vecParams sim_params;
+    regex tolerance_regex("(-tolerance=)(.*)");
+    for (auto param: params) {
+        if (regex_match(param, tolerance_regex)) tolerance = atof(param.substr(param.find("=") + 1).c_str());
+        else sim_params.push_back(param);
+    }
+    sim_input input{};
+    if (not parse_sim_input(sim_params, input)) return 1;
+    if (input.compiled or input.check or not input.compile_file.empty()) {
+        cout << "verify only supports the interpreted simulation" << endl;
+        return 1;
+    }
+
+    vector<cfdfc_claim> claims;
+    string th_file = input.graph_name + "_throughput.txt";
+    if (not read_throughputs(th_file, claims)) {
+        cerr << "File " << th_file << " could not be read." << endl;
+        return 1;
+    }
+
+    DFnetlist DF(input.graph_file);
+    if (DF.hasError()) {
+        cerr << DF.getError() << endl;
+        return 1;
+    }
+    DFsim sim(DF);
+    if (sim.hasError()) {
+        cerr << sim.getError() << endl;
+        return 1;
+    }
+    for (auto& arg: input.args) {
+        if (not sim.setArgument(arg.first, arg.second)) {
+            cerr << "Argument " << arg.first << " not found." << endl;
+            return 1;
+        }
+    }
+    if (not input.mem_in.empty() and not sim.readMemories(input.mem_in)) {
+        cerr << sim.getError() << endl;
+        return 1;
+    }
+
+    // Channels of each CFDFC: inside its BBs or along its arcs
+    DFnetlist_Impl& DFI = *DF.DFI;
+    vector<vector<int>> cfdfc_chans(claims.size());
+    for (int c = 0; c < sim.numChannels(); ++c) {
+        channelID id = sim.getChannel(c).id;
+        int bb_src = DFI.getBasicBlock(DFI.getSrcBlock(id));
+        int bb_dst = DFI.getBasicBlock(DFI.getDstBlock(id));
+        for (int k = 0; k < claims.size(); ++k) {
+            bool inside = bb_src == bb_dst and claims[k].bbs.count(bb_src);
+            if (not inside and not claims[k].arcs.count({bb_src, bb_dst})) continue;
+            cfdfc_chans[k].push_back(c);
+            sim.watchChannel(c);
+        }
+    }
+
+    if (input.threads > 1) sim.setThreads(input.threads);
+    sim.run(input.cycles);
+    if (sim.hasError()) cerr << sim.getError() << endl;
+    cout << "Simulation status: " << DFsim::statusName(sim.getStatus()) << endl;
+    cout << "Cycles: " << sim.getCycles() << endl;
+
+    // The throughput of a CFDFC is the median of the steady-state throughputs of its channels
+    int deviations = 0;
+    cout << endl << "Throughput of the CFDFCs (tolerance " << fixed << setprecision(1) << 100 * tolerance << "%):" << endl;
+    cout << " CFDFC        freq  iterations   MILP  simulated  deviation" << endl;
+    for (int k = 0; k < claims.size(); ++k) {
+        const cfdfc_claim& claim = claims[k];
+        vector<double> th, tokens;
+        for (int c: cfdfc_chans[k]) {
+            if (sim.getChannel(c).transfers < 2) continue;
+            th.push_back(sim.steadyThroughput(c));
+            tokens.push_back(sim.getChannel(c).transfers);
+        }
+        cout << setw(6) << claim.index << setw(12) << setprecision(0) << claim.freq << setw(12) << median(tokens)
+             << setw(7) << setprecision(2) << claim.throughput;
+        if (th.empty()) {
+            cout << "          -          -  not executed" << endl;
+            continue;
+        }
+        double measured = median(th);
+        double dev = claim.throughput > 0 ? (measured - claim.throughput) / claim.throughput : 0;
+        bool ok = abs(dev) <= tolerance;
+        cout << setw(11) << setprecision(3) << measured << setw(10) << setprecision(1) << 100 * dev << "%  "
+             << (ok ? "ok" : (dev < 0 ? "BELOW CLAIM" : "ABOVE CLAIM"));
+        // The inputs of the simulation do not exercise the CFDFC as in the profiling
+        if (claim.freq > 0 and abs(median(tokens) - claim.freq) > tolerance * claim.freq) cout << " (freq differs)";
+        cout << endl;
+        if (not ok) deviations++;
+    }
+
+    if (input.stats_file == "-") {
+        cout << endl;
+        sim.writeBottlenecks(cout, input.top);
+    } else if (not input.stats_file.empty()) {
+        ofstream stats(input.stats_file);
+        sim.writeBottlenecks(stats, input.top);
+    }
+    if (not input.heat_file.empty()) sim.writeHeatDot(DF, input.heat_file);
+    if (not input.lsq_depths.empty()) sim.writeLSQDepths(input.lsq_depths);
+
+    cout << endl << "Verification: " << (deviations == 0 ? "passed" : "FAILED") << " (" << deviations
+         << " CFDFCs beyond the tolerance)" << endl;
+    return deviations == 0 and sim.getStatus() == DFsim::FINISHED ? 0 : 1;
+}
+
+void show_help_cosim() {
+    cout << "Runs the C kernel natively and simulates <filename>_graph_buf.dot on the test vectors of" << endl;
+    cout << "the hls_verifier flow, and compares the final contents of the arrays and the return value" << endl;
+    cout << "-sim: directory with C_SRC/<kernel>.cpp and INPUT_VECTORS/input_<arg>.dat" << endl;
+    cout << "\tdefault value is \"sim\"" << endl;
+    cout << "-kernel: name of the C function" << endl;
+    cout << "\tdefault value is the base name of <filename>" << endl;
+    cout << "-filename, -cycles and -threads are the ones of simulate:" << endl;
+    show_help_simulate();
+}
+
+int main_cosim(const vecParams& params) {
+    if (params.size() == 1 && params[0] == "-help") {
+        show_help_cosim();
+        return 1;
+    }
+
+    string sim_dir = "sim", kernel;
+    vecParams sim_params;
+    regex sim_regex("(-sim=)(.*)");
+    regex kernel_regex("(-kernel=)(.*)");
+    for (auto param: params) {
+        string value = param.substr(param.find("=") + 1);
+        if (regex_match(param, sim_regex)) sim_dir = value;
+        else if (regex_match(param, kernel_regex)) kernel = value;
+        else sim_params.push_back(param);
+    }
+    sim_input input{};
+    if (not parse_sim_input(sim_params, input)) return 1;
+    if (input.compiled or input.check or not input.compile_file.empty() or not input.args.empty() or
+        not input.mem_in.empty() or not input.mem_out.empty() or not input.stats_file.empty() or
+        not input.heat_file.empty() or not input.trace_file.empty() or not input.lsq_depths.empty()) {
+        cout << "cosim only supports the options -filename, -cycles and -threads of simulate" << endl;
+        return 1;
+    }
+    if (kernel.empty()) kernel = input.graph_name.substr(input.graph_name.find_last_of('/') + 1);
+
+    DFcosim cosim(sim_dir + "/C_SRC/" + kernel + ".cpp", kernel);
+    if (cosim.hasError() or not cosim.readVectors(sim_dir + "/INPUT_VECTORS") or
+        not cosim.buildDriver(input.graph_name + "_cosim")) {
+        cerr << cosim.getError() << endl;
+        return 1;
+    }
+
+    DFnetlist DF(input.graph_file);
+    if (DF.hasError()) {
+        cerr << DF.getError() << endl;
+        return 1;
+    }
+    DFsim initial(DF);
+    if (initial.hasError()) {
+        cerr << initial.getError() << endl;
+        return 1;
+    }
+
+    // Every transaction is simulated from the initial state of the circuit
+    int failed = 0;
+    long long cycles = 0;
+    double c_ms = 0, sim_ms = 0;
+    cout << "Co-simulation of " << kernel << " (" << cosim.numTransactions() << " transactions)" << endl;
+    cout << " transaction      status      cycles  mismatches" << endl;
+    for (int t = 0; t < cosim.numTransactions(); ++t) {
+        DFcosim::Values golden;
+        auto stamp = chrono::steady_clock::now();
+        if (not cosim.runKernel(t, golden)) {
+            cerr << cosim.getError() << endl;
+            return 1;
+        }
+        c_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - stamp).count();
+
+        DFsim sim(initial);
+        if (not cosim.setInputs(sim, t)) {
+            cerr << cosim.getError() << endl;
+            return 1;
+        }
+        if (input.threads > 1) sim.setThreads(input.threads);
+        stamp = chrono::steady_clock::now();
+        sim.run(input.cycles);
+        sim_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - stamp).count();
+        if (sim.hasError()) cerr << sim.getError() << endl;
+        cycles += sim.getCycles();
+
+        ostringstream diffs;
+        int mismatches = cosim.compare(sim, golden, diffs);
+        bool ok = mismatches == 0 and sim.getStatus() == DFsim::FINISHED;
+        cout << setw(12) << t << setw(12) << DFsim::statusName(sim.getStatus()) << setw(12) << sim.getCycles()
+             << setw(12) << mismatches << (ok ? "" : "  FAILED") << endl;
+        cout << diffs.str();
+        if (not ok) failed++;
+    }
+
+    cout << endl << "Co-simulation: " << (failed == 0 ? "passed" : "FAILED") << " (" << failed
+         << " transactions failed, " << cycles << " cycles, C " << fixed << setprecision(1) << c_ms
+         << " ms, simulation " << sim_ms << " ms)" << endl;
+    return failed == 0 ? 0 : 1;
+}
+
+void show_help_trim() {
+    cout << "Removes or shrinks the buffers of <filename>_graph_buf.dot, in order of cost, while the" << endl;
+    cout << "simulation on the given inputs has the same results and does not take more cycles" << endl;
+    cout << "-tolerance: maximum relative increase of the cycles" << endl;
+    cout << "\tdefault value is 0" << endl;
+    cout << "-out: trimmed netlist" << endl;
+    cout << "\tdefault value is <filename>_trim_graph_buf.dot" << endl;
+    cout << "-summary: file with the buffers removed or shrunk" << endl;
+    cout << "\tdefault value is <filename>_trim.txt" << endl;
+    cout << "-filename, -cycles, -args, -mem and -threads are the ones of simulate:" << endl;
+    show_help_simulate();
+}
+
+// Results of a simulation that must be preserved by the trimming
+struct sim_outcome {
+    DFsim::Status status;
+    long long cycles;
+    map<string, vector<uint64_t>> memories;
+    bool has_ret;
+    uint64_t ret;
+};
+
+sim_outcome run_outcome(DFsim& sim, const sim_input& input) {
+    if (input.threads > 1) sim.setThreads(input.threads);
+    sim.run(input.cycles);
+    sim_outcome out{sim.getStatus(), sim.getCycles(), {}, sim.hasReturnValue(), sim.getReturnValue()};
+    for (const string& m: sim.getMemoryNames()) out.memories[m] = sim.getMemory(m);
+    return out;
+}
+
+int main_trim(const vecParams& params) {
+    if (params.size() == 1 && params[0] == "-help") {
+        show_help_trim();
+        return 1;
+    }
+
+    double tolerance = 0;
+    string out_file, summary_file;
+    vecParams sim_params;
+    regex tolerance_regex("(-tolerance=)(.*)");
+    regex out_regex("(-out=)(.*)");
+    regex summary_regex("(-summary=)(.*)");
+    for (auto param: params) {
+        string value = param.substr(param.find("=") + 1);
+        if (regex_match(param, tolerance_regex)) tolerance = atof(value.c_str());
+        else if (regex_match(param, out_regex)) out_file = value;
+        else if (regex_match(param, summary_regex)) summary_file = value;
+        else sim_params.push_back(param);
+    }
+    sim_input input{};
+    if (not parse_sim_input(sim_params, input)) return 1;
+    if (input.compiled or input.check or not input.compile_file.empty() or not input.mem_out.empty() or
+        not input.stats_file.empty() or not input.heat_file.empty() or not input.trace_file.empty() or
+        not input.lsq_depths.empty()) {
+        cout << "trim only supports the options -filename, -cycles, -args, -mem and -threads of simulate" << endl;
+        return 1;
+    }
+    if (out_file.empty()) out_file = input.graph_name + "_trim_graph_buf.dot";
+    if (summary_file.empty()) summary_file = input.graph_name + "_trim.txt";
+
+    DFnetlist DF(input.graph_file);
+    if (DF.hasError()) {
+        cerr << DF.getError() << endl;
+        return 1;
+    }
+    DFsim initial(DF);
+    if (initial.hasError()) {
+        cerr << initial.getError() << endl;
+        return 1;
+    }
+    for (auto& arg: input.args) {
+        if (not initial.setArgument(arg.first, arg.second)) {
+            cerr << "Argument " << arg.first << " not found." << endl;
+            return 1;
+        }
+    }
+    if (not input.mem_in.empty() and not initial.readMemories(input.mem_in)) {
+        cerr << initial.getError() << endl;
+        return 1;
+    }
+
+    DFsim base_sim(initial);
+    sim_outcome base = run_outcome(base_sim, input);
+    if (base.status != DFsim::FINISHED) {
+        cerr << "The simulation of the netlist does not finish (" << DFsim::statusName(base.status) << ")." << endl;
+        return 1;
+    }
+    long long max_cycles = base.cycles + (long long) floor(tolerance * base.cycles);
+
+    // Buffers by decreasing cost: slots times the bits of a slot (data and valid)
+    struct buffer_trim {
+        int node;
+        int slots, trimmed;
+        int bits;
+    };
+    vector<buffer_trim> buffers;
+    for (int n = 0; n < initial.numNodes(); ++n) {
+        const DFsim::Node& node = initial.getNode(n);
+        if (node.kind != DFsim::NODE_BUFFER) continue;
+        int bits = initial.getChannel(node.in[0]).width + 1;
+        buffers.push_back({n, node.slots, node.slots, bits});
+    }
+    stable_sort(buffers.begin(), buffers.end(), [](const buffer_trim& a, const buffer_trim& b) {
+        return a.slots * a.bits > b.slots * b.bits;
+    });
+
+    // Every trial is simulated with the buffers accepted so far. Opaque buffers keep one slot,
+    // since they cut the combinational paths assumed by the buffer placement.
+    DFsim current(initial);
+    int trials = 0;
+    sim_outcome last = base;
+    auto accepts = [&](int n, int slots, sim_outcome& out) {
+        DFsim trial(current);
+        trial.setBufferSlots(n, slots);
+        out = run_outcome(trial, input);
+        trials++;
+        return out.status == DFsim::FINISHED and out.cycles <= max_cycles and out.memories == base.memories and
+               out.has_ret == base.has_ret and out.ret == base.ret;
+    };
+    for (buffer_trim& buf: buffers) {
+        int lo = initial.getNode(buf.node).transparent ? 0 : 1;
+        int hi = buf.slots;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            sim_outcome out;
+            if (accepts(buf.node, mid, out)) {
+                hi = mid;
+                last = out;
+            } else lo = mid + 1;
+        }
+        if (hi == buf.slots) continue;
+        buf.trimmed = hi;
+        current.setBufferSlots(buf.node, hi);
+    }
+
+    // Apply the decisions to the netlist
+    DFnetlist_Impl& DFI = *DF.DFI;
+    ostringstream summary;
+    int slots_before = 0, slots_after = 0, bits_before = 0, bits_after = 0, removed = 0, shrunk = 0;
+    summary << "Trimmed buffers (slots before, after, bits of a slot):" << endl;
+    for (const buffer_trim& buf: buffers) {
+        slots_before += buf.slots;
+        slots_after += buf.trimmed;
+        bits_before += buf.slots * buf.bits;
+        bits_after += buf.trimmed * buf.bits;
+        if (buf.trimmed == buf.slots) continue;
+        blockID b = initial.getNode(buf.node).id;
+        summary << setw(6) << buf.slots << setw(6) << buf.trimmed << setw(6) << buf.bits << "  "
+                << DFI.getBlockName(b) << (buf.trimmed == 0 ? " (removed)" : "") << endl;
+        if (buf.trimmed == 0) {
+            DFI.removeBuffer(b);
+            removed++;
+            continue;
+        }
+        DFI.setBufferSize(b, buf.trimmed);
+        channelID out = initial.getChannel(initial.getNode(buf.node).out[0]).id;
+        if (DFI.getChannelBufferSize(out) > 0) DFI.setChannelBufferSize(out, buf.trimmed);
+        shrunk++;
+    }
+    summary << "Buffers: " << buffers.size() << ", removed: " << removed << ", shrunk: " << shrunk << endl;
+    summary << "Slots: " << slots_before << " -> " << slots_after << ", bits: " << bits_before << " -> "
+            << bits_after << endl;
+    summary << "Cycles: " << base.cycles << " -> " << last.cycles << " (" << trials << " simulations)" << endl;
+
+    cout << summary.str();
+    if (not DF.writeDot(out_file)) {
+        cerr << "File " << out_file << " could not be written." << endl;
+        return 1;
+    }
+    ofstream f(summary_file);
+    f << summary.str();
+    if (not f) {
+        cerr << "File " << summary_file << " could not be written." << endl;
+        return 1;
+    }
+    return 0;
+}
+
+extern std::string TAG_INFO_PATH;   // Defined in DFnetlist_buffers.cpp
+extern int N_tags;                  // Tags of the buffer placement (tag-info file)
+
+void show_help_tags() {
+    cout << "Simulates the tagged netlist <filename>_graph_buf.dot for a range of numbers of tags (N_tags)" << endl;
+    cout << "and writes the smallest number that reaches the knee of the throughput into the tag-info file" << endl;
+    cout << "(the simulations that do not finish within -cycles are failures)" << endl;
+    cout << "-min_tags, -max_tags: range of the number of tags" << endl;
+    cout << "\tdefault values are 1 and the outputs of the aligner branches (16 without aligners)" << endl;
+    cout << "-tolerance: maximum relative loss of throughput of the knee with respect to the best one" << endl;
+    cout << "\tdefault value is 0.05" << endl;
+    cout << "-tag_info: tag-info file to update (none: not written)" << endl;
+    cout << "\tdefault value is " << TAG_INFO_PATH << endl;
+    cout << "-filename, -cycles, -args, -mem and -threads are the ones of simulate:" << endl;
+    show_help_simulate();
+}
+
+int main_tags(const vecParams& params) {
+    if (params.size() == 1 && params[0] == "-help") {
+        show_help_tags();
+        return 1;
+    }
+
+    int min_tags = 1, max_tags = 0;
+    double tolerance = 0.05;
+    string tag_info = TAG_INFO_PATH;
+    vecParams sim_params;
+    regex min_regex("(-min_tags=)(.*)");
+    regex max_regex("(-max_tags=)(.*)");
+    regex tolerance_regex("(-tolerance=)(.*)");
+    regex tag_info_regex("(-tag_info=)(.*)");
+    for (auto param: params) {
+        string value = param.substr(param.find("=") + 1);
+        if (regex_match(param, min_regex)) min_tags = atoi(value.c_str());
+        else if (regex_match(param, max_regex)) max_tags = atoi(value.c_str());
+        else if (regex_match(param, tolerance_regex)) tolerance = atof(value.c_str());
+        else if (regex_match(param, tag_info_regex)) tag_info = value;
+        else sim_params.push_back(param);
+    }
+    sim_input input{};
+    if (not parse_sim_input(sim_params, input)) return 1;
+    if (input.compiled or input.check or not input.compile_file.empty() or not input.mem_out.empty() or
+        not input.stats_file.empty() or not input.heat_file.empty() or not input.trace_file.empty() or
+        not input.lsq_depths.empty()) {
+        cout << "tags only supports the options -filename, -cycles, -args, -mem and -threads of simulate" << endl;
+        return 1;
+    }
+
+    DFnetlist DF(input.graph_file);
+    if (DF.hasError()) {
+        cerr << DF.getError() << endl;
+        return 1;
+    }
+    DFsim initial(DF);
+    if (initial.hasError()) {
+        cerr << initial.getError() << endl;
+        return 1;
+    }
+    for (auto& arg: input.args) {
+        if (not initial.setArgument(arg.first, arg.second)) {
+            cerr << "Argument " << arg.first << " not found." << endl;
+            return 1;
+        }
+    }
+    if (not input.mem_in.empty() and not initial.readMemories(input.mem_in)) {
+        cerr << initial.getError() << endl;
+        return 1;
+    }
+
+    // The tokens leaving the tagged regions return their tags (first output of the untaggers).
+    // The aligner branches have one output per tag: the netlist supports up to that number of tags.
+    vector<int> freed;
+    int free_fifos = 0, aligner_outs = 0;
+    for (int n = 0; n < initial.numNodes(); ++n) {
+        const DFsim::Node& node = initial.getNode(n);
+        if (node.kind == DFsim::NODE_UNTAGGER and not node.out.empty() and node.out[0] >= 0) freed.push_back(node.out[0]);
+        else if (node.kind == DFsim::NODE_FREE_TAGS) free_fifos++;
+        else if (node.kind == DFsim::NODE_ALIGNER_BRANCH) {
+            int outs = node.out.size();
+            aligner_outs = aligner_outs == 0 ? outs : min(aligner_outs, outs);
+        }
+    }
+    if (freed.empty() or free_fifos == 0) {
+        cerr << "The netlist has no tagged region (untagger and free tags fifo)." << endl;
+        return 1;
+    }
+    if (max_tags == 0) max_tags = aligner_outs > 0 ? aligner_outs : 16;
+    if (aligner_outs > 0 and max_tags > aligner_outs) {
+        cerr << "The aligner branches of the netlist only support " << aligner_outs << " tags." << endl;
+        return 1;
+    }
+    if (min_tags < 1 or max_tags < min_tags) {
+        cerr << "Wrong range of tags: " << min_tags << " to " << max_tags << "." << endl;
+        return 1;
+    }
+
+    // Cost of the tags: the bits of the tag (as in the frontend) on every tagged channel,
+    // and the slots of the free tags fifos
+    DFnetlist_Impl& DFI = *DF.DFI;
+    int tagged_channels = 0;
+    for (int c = 0; c < initial.numChannels(); ++c) {
+        blockID src = DFI.getSrcBlock(initial.getChannel(c).id);
+        if (DFI.getBlockTagged(src) or DFI.getBlockType(src) == TAGGER) tagged_channels++;
+    }
+
+    struct tags_point {
+        int tags;
+        sim_outcome out;
+        double throughput;      // Tags returned per cycle
+        int bits;
+        long long cost;
+        bool ok;
+    };
+    vector<tags_point> points;
+    const sim_outcome* reference = nullptr;
+    for (int tags = min_tags; tags <= max_tags; ++tags) {
+        DFsim trial(initial);
+        if (not trial.setTags(tags)) {
+            cerr << "Wrong number of tags: " << tags << "." << endl;
+            return 1;
+        }
+        tags_point p;
+        p.tags = tags;
+        p.out = run_outcome(trial, input);
+        long long returned = 0;
+        for (int c: freed) returned += trial.getChannel(c).transfers;
+        p.throughput = p.out.cycles == 0 ? 0 : (double) returned / p.out.cycles;
+        p.bits = (int) floor(log2(tags)) + 1;
+        p.cost = (long long) p.bits * (tagged_channels + free_fifos * (tags + 1));
+        p.ok = p.out.status == DFsim::FINISHED;
+        points.push_back(p);
+    }
+
+    // The results of the finished simulations must not depend on the number of tags
+    for (tags_point& p: points) {
+        if (p.out.status != DFsim::FINISHED) continue;
+        if (reference == nullptr) reference = &p.out;
+        else if (p.out.memories != reference->memories or p.out.has_ret != reference->has_ret or
+                 p.out.ret != reference->ret) p.ok = false;
+    }
+
+    double best = 0;
+    for (const tags_point& p: points) if (p.ok) best = max(best, p.throughput);
+    const tags_point* knee = nullptr;
+    for (const tags_point& p: points) {
+        if (p.ok and best > 0 and p.throughput >= (1 - tolerance) * best) {
+            knee = &p;
+            break;
+        }
+    }
+
+    cout << "Tagged channels: " << tagged_channels << ", free tags fifos: " << free_fifos << endl;
+    cout << setw(6) << "tags" << setw(14) << "status" << setw(12) << "cycles" << setw(12) << "throughput"
+         << setw(10) << "relative" << setw(6) << "bits" << setw(10) << "cost" << endl;
+    for (const tags_point& p: points) {
+        cout << setw(6) << p.tags << setw(14) << DFsim::statusName(p.out.status) << setw(12) << p.out.cycles
+             << setw(12) << fixed << setprecision(4) << p.throughput << setw(10) << setprecision(3)
+             << (best > 0 ? p.throughput / best : 0) << setw(6) << p.bits << setw(10) << p.cost;
+        if (p.out.status == DFsim::FINISHED and not p.ok) cout << "  wrong results";
+        if (&p == knee) cout << "  <- knee";
+        cout << endl;
+    }
+    if (knee == nullptr) {
+        cerr << "No number of tags completes the simulation (see -cycles)." << endl;
+        return 1;
+    }
+    // The buffers of the netlist were sized for the N_tags of the placement
+    cout << "Selected N_tags: " << knee->tags << " (buffers placed for N_tags = " << N_tags << ")" << endl;
+    if (knee->tags > N_tags) {
+        cout << "The buffers may limit the throughput beyond " << N_tags
+             << " tags: place them again with the selected N_tags." << endl;
+    }
+
+    if (tag_info == "none") return 0;
+
+    // Tag-info file: "true" (tagged circuit), the number of tags, and other lines that are kept
+    vector<string> lines;
+    ifstream in(tag_info);
+    string line;
+    while (getline(in, line)) lines.push_back(line);
+    in.close();
+    if (lines.size() < 2) lines.resize(2);
+    lines[0] = "true";
+    lines[1] = to_string(knee->tags);
+    ofstream out(tag_info);
+    for (const string& l: lines) out << l << endl;
+    if (not out) {
+        cerr << "File " << tag_info << " could not be written." << endl;
+        return 1;
+    }
+    cout << "N_tags written to " << tag_info << endl;
     return 0;
 }
 
@@ -230,6 +1258,11 @@ int main(int argc, char *argv[])
 
     if (command == "buffers_old") return main_buffers(params);
     if (command == "buffers") return main_shab(params);
+    if (command == "simulate") return main_simulate(params);
+    if (command == "verify") return main_verify(params);
+    if (command == "cosim") return main_cosim(params);
+    if (command == "trim") return main_trim(params);
+    if (command == "tags") return main_tags(params);
     if (command == "test") return main_test(params);
 
 #if 0
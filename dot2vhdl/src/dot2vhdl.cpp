@@ -13,46 +13,22 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include "stdlib.h"
 #include <string.h>
 #include "dot2vhdl.h"
-#include "dot_parser.h"
-#include "vhdl_writer.h"
-#include "eda_if.h"
-#include "lsq_generator.h"
-#include "reports.h"
-#include "checks.h"
 #include "sys_utils.h"
+#include "libdot2vhdl.h"
+#include "perf_counters.h"
 
 
 using namespace std;
 
 
-int debug_mode = FALSE;
-int report_area_mode = FALSE;
-
-
-string input_filename[MAX_INPUT_FILES];
-string output_filename[MAX_INPUT_FILES];
-string top_level_filename;
-int dot_input_files = 0;
-    
 void arguments_parser ( int argc, char *argv[] )
 {		
     switch ( argc )
     {
-        case 3:
-            if ( ! ( strcmp(argv[2] , "-debug") ) )
-            {
-                printf ( "Debug Mode Activated\n\r" );
-                debug_mode = TRUE;
-            }
-            if ( ! ( strcmp(argv[2] , "-report_area") ) )
-            {
-                printf ( "Report Area Activated\n\r" );
-                report_area_mode = TRUE;
-            }
-            break;
         case 2:
             if ( ! ( strcmp(argv[1] , "--version") ) )
             {
@@ -64,7 +40,21 @@ void arguments_parser ( int argc, char *argv[] )
             if ( ! ( strcmp(argv[1] , "--help") ) )
             {
                 printf ("Dot2Vhdl version %s \n\r", VERSION_STRING );
-                printf ( "Usage: %s filename -debug [opt]\n\r\n\r\n\r", argv[0]);        
+                printf ( "Usage: %s filename [filename2 ...] [-debug] [-report_area] [-target=<name>] [-lsq_depths=<file>] [-lsq_cache=<dir>] [-jobs=N] [-force] [-perf_counters=all|cfdfc|<file>] [-perf_width=N]\n\r", argv[0]);
+                printf ( "  -report_area: estimate the area from $DHLS_INSTALL_DIR/etc/dynamatic/data/targets/<target>_area.dat, without generating the VHDL\n\r");
+                printf ( "  -target: characterized target of the area and delay tables (\"default\" by default);\n\r");
+                printf ( "           the default tables, used for the targets without a table (e.g., only delays are\n\r");
+                printf ( "           characterized for 5CSEMA4U23C7 and EP4CE30F23C7), give a device-independent estimate\n\r");
+                printf ( "  -lsq_depths: depths of the LSQ queues (written by buffers simulate -lsq_depths): the peak occupancy\n\r");
+                printf ( "               of the simulated inputs only, raised to the accesses of the largest group of each LSQ\n\r");
+                printf ( "  -lsq_cache: directory of the LSQs already generated, by configuration\n\r");
+                printf ( "  -jobs: threads writing the sections of a VHDL file and generating the LSQs (1 by default);\n\r");
+                printf ( "         the input files are written one after the other\n\r");
+                printf ( "  -force: write all the files and generate the LSQs, even if unchanged since the last run\n\r");
+                printf ( "  -perf_counters: transfer, stall and idle counters on all the channels, on the channels of the CFDFCs\n\r");
+                printf ( "      (<graph>_throughput.txt, written by buffers) or on the channels listed in the file (<from>[:outN] -> <to>[:inN]),\n\r");
+                printf ( "      read through the perf_select and perf_count ports; the counters are listed in <top>_perf_counters.json\n\r");
+                printf ( "  -perf_width: bits of the counters (%d by default)\n\r\n\r\n\r", PERF_COUNTERS_WIDTH_DEFAULT );
                 exit(1);
 
             }
@@ -78,11 +68,83 @@ void arguments_parser ( int argc, char *argv[] )
 
             }
             break;
-        default:
+        case 1:
             printf( "Invalid arguments \n\rTry %s --help for more informations\n\r\n\r\n\r", argv[0] );
             exit ( 0 );
             break;
+        default:
+            break;
+    }
+
+    // The options can follow the dot files; the other arguments are dot files
+    for ( int indx = 1; indx < argc; indx++ )
+    {
+        if ( ! ( strcmp(argv[indx] , "-debug") ) )
+        {
+            printf ( "Debug Mode Activated\n\r" );
+            debug_mode = TRUE;
+        }
+        else
+        if ( ! ( strcmp(argv[indx] , "-report_area") ) )
+        {
+            printf ( "Report Area Activated\n\r" );
+            report_area_mode = TRUE;
+        }
+        else
+        if ( ! ( strncmp(argv[indx] , "-target=", 8) ) )
+        {
+            target_name = argv[indx] + 8;
+        }
+        else
+        if ( ! ( strncmp(argv[indx] , "-lsq_depths=", 12) ) )
+        {
+            lsq_depths_filename = argv[indx] + 12;
+        }
+        else
+        if ( ! ( strncmp(argv[indx] , "-lsq_cache=", 11) ) )
+        {
+            lsq_cache_dirname = argv[indx] + 11;
+        }
+        else
+        if ( ! ( strcmp(argv[indx] , "-force") ) )
+        {
+            force_mode = TRUE;
+        }
+        else
+        if ( ! ( strncmp(argv[indx] , "-perf_counters=", 15) ) )
+        {
+            perf_counters_mode = argv[indx] + 15;
+        }
+        else
+        if ( ! ( strncmp(argv[indx] , "-perf_width=", 12) ) )
+        {
+            perf_counters_width = max( atoi( argv[indx] + 12 ), 1 );
         }
+        else
+        if ( ! ( strncmp(argv[indx] , "-jobs=", 6) ) )
+        {
+            jobs = max( atoi( argv[indx] + 6 ), 1 );
+        }
+        else
+        if ( argv[indx][0] == '-' )
+        {
+            printf( "Invalid argument %s \n\rTry %s --help for more informations\n\r\n\r\n\r", argv[indx], argv[0] );
+            exit ( 0 );
+        }
+        else
+        if ( dot_input_files < MAX_INPUT_FILES )
+        {
+            input_filename[dot_input_files] = argv[indx];
+            output_filename[dot_input_files] = argv[indx];
+            dot_input_files++;
+        }
+    }
+
+    if ( dot_input_files == 0 )
+    {
+        printf( "Invalid arguments \n\rTry %s --help for more informations\n\r\n\r\n\r", argv[0] );
+        exit ( 0 );
+    }
 
     return;
 }
@@ -95,61 +157,10 @@ int main( int argc, char* argv[] )
    
     signal_handler();
 
-    vhdl_writer vhdl_writer;
-    
     cout << INIT_STRING;
     
     arguments_parser ( argc, argv );
-        
-    dot_input_files = (argc-1);
             
-    top_level_filename = argv[1];
-
-    for ( int indx = 0; indx < dot_input_files; indx++ )
-    {
-        
-        input_filename[indx] = argv[indx+1];
-        output_filename[indx] = argv[indx+1];
-
-        cout << "Parsing "<< input_filename[indx] << ".dot" << endl;
-        
-        parse_dot ( input_filename[indx] );
-        
-        check_netlist ( );
-        
-        
-        if ( report_area_mode )
-        {
-            report_instances ();
-            return 0;
-            //report_area ();
-        }
-        else
-        {
-            report_instances ();
-            cout << "Generating " << output_filename[indx] << ".vhd" << endl;
-            vhdl_writer.write_vhdl ( output_filename[indx] , indx );
-        }
-    }
-    
-    
-    //vhdl_writer.write_tb_wrapper ( top_level_filename );
-    
-
-    lsq_generate_configuration ( top_level_filename );
-    lsq_generate ( top_level_filename );
-
-    write_vivado_script ( top_level_filename );
-    write_modelsim_script ( top_level_filename );
-    
-    cout << endl;
-    cout << "Done" ;
+    return dot2vhdl_generate ( );
     
-    cout << endl<< endl<< endl;
-    return 0;
-    
-} 
-
-
-
-
+}
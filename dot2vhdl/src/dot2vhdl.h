@@ -40,10 +40,18 @@ Thank you!*************************************************************\n\r\
 #define MAX_INPUT_FILES 16
 
 extern int debug_mode;
+extern int report_area_mode;
+extern int force_mode;
 
 extern string input_filename[MAX_INPUT_FILES];
 extern string output_filename[MAX_INPUT_FILES];
 extern string top_level_filename;
+extern string lsq_depths_filename;
+extern string lsq_cache_dirname;
+extern string target_name;
+extern string perf_counters_mode;
+extern int perf_counters_width;
+extern int jobs;
 extern int dot_input_files;
 
 #define FALSE   0
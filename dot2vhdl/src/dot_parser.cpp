@@ -17,7 +17,13 @@
 #include <vector>
 #include <algorithm> 
 #include <list>
+#include <unordered_map>
 #include <cctype>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "assert.h"
 #include "dot2vhdl.h"
 #include "dot_parser.h"
@@ -27,205 +33,177 @@
 
 using namespace std;
 
-NODE_T nodes[MAX_NODES];
+vector<NODE_T> nodes;
+unordered_map<string, int> node_ids; // Index of the nodes by name (the first one if repeated)
 
 int components_in_netlist;
 int lsqs_in_netlist;
 
 #define COMPONENT_DESCRIPTION_LINE  0
 #define COMPONENT_CONNECTION_LINE  1
+#define OTHER_LINE  2
 
 
-bool check_line ( string line )
+int check_line ( string_view line )
 {
     
-    if ( line.find("type") != std::string::npos )
+    if ( line.find("type") != string_view::npos )
     {
         return COMPONENT_DESCRIPTION_LINE;
     }
-    if ( line.find(">") != std::string::npos )
+    if ( line.find(">") != string_view::npos )
     {
         return COMPONENT_CONNECTION_LINE;
     }
+    return OTHER_LINE;
 }
 
-string get_value ( string parameter )
+string_view get_value ( string_view parameter )
 {
-    vector<string> v;
-    string_split( parameter, '=', v );
-    if ( v.size() > 0 )
-    {
-        return v[1];
-    }
-    
+    return string_field( parameter, '=' );
 }
 
-string get_component_type ( string parameters )
+// Value of an attribute without blanks, quotes and the closing "];" (as string_clean)
+string get_clean_value ( string_view parameter )
 {
+    string buffer;
+    return string( string_strip( get_value( parameter ), "\t \"];", buffer ) );
+}
 
-    parameters = string_clean( parameters );
-    
-    string type = get_value ( parameters );
+string get_component_type ( string_view parameters )
+{
+
+    string type = get_clean_value ( parameters );
     nodes[components_in_netlist].component_type = COMPONENT_GENERIC;
     
     return type;
 }
 
 // AYA: 05/08/2023
-string get_component_tagged ( string parameters )
+string get_component_tagged ( string_view parameters )
 {
 
-    parameters = string_clean( parameters );
-    
-    string is_tagged = get_value ( parameters );
+    string is_tagged = get_clean_value ( parameters );
     
     return is_tagged;
 }
 
 // AYA: 26/12/2023
-string get_component_tagger_id ( string parameters )
+string get_component_tagger_id ( string_view parameters )
 {
 
-    parameters = string_clean( parameters );
-    
-    string tagger_id = get_value ( parameters );
+    string tagger_id = get_clean_value ( parameters );
     
     return tagger_id;
 }
 
 // AYA: 26/12/2023
-string get_component_taggers_num ( string parameters )
+string get_component_taggers_num ( string_view parameters )
 {
 
-    parameters = string_clean( parameters );
-    
-    string taggers_num = get_value ( parameters );
+    string taggers_num = get_clean_value ( parameters );
     
     return taggers_num;
 }
 
 
-string get_component_operator ( string parameters )
+string get_component_operator ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
   
     return type;
 }
 
-string get_component_value ( string parameters )
+string get_component_value ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return type;
 }
 
-bool get_component_control (  string parameters )
+bool get_component_control ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
         
     return ((( type == "true" )) ? TRUE : FALSE);
 }
 
 
-int get_component_slots ( string parameters )
+int get_component_slots ( string_view parameters )
 {
     
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return stoi_p( type );
 }
 
 
-bool get_component_transparent (  string parameters )
+bool get_component_transparent ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     
     return ((( type == "true" )) ? TRUE : FALSE);
 }
 
 
-string get_component_memory ( string parameters )
+string get_component_memory ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return type;
 }
 
 
-string get_component_numloads ( string parameters )
+string get_component_numloads ( string_view parameters )
 {
     //parameters = string_clean( parameters );
 
-    string type = get_value ( parameters );
+    string type ( get_value ( parameters ) );
     return type;
 }
 
-string get_component_numstores ( string parameters )
+string get_component_numstores ( string_view parameters )
 {
     //parameters = string_clean( parameters );
 
-    string type = get_value ( parameters );
+    string type ( get_value ( parameters ) );
     return type;
 }
 
 
-int get_component_bbcount ( string parameters )
+int get_component_bbcount ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return stoi_p( type );
 }
 
-int get_component_bbId ( string parameters )
+int get_component_bbId ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return stoi_p( type );
 }
 
 
-int get_component_portId ( string parameters )
+int get_component_portId ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return stoi_p( type );
 }
 
-int get_component_offset ( string parameters )
+int get_component_offset ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return stoi_p( type );
 }
 
-bool get_component_mem_address (  string parameters )
+bool get_component_mem_address ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
            
     return ((( type == "true" )) ? TRUE : FALSE);
 
 }
 
-int get_component_constants ( string parameters )
+int get_component_constants ( string_view parameters )
 {
-    parameters = string_clean( parameters );
-        
-    string type = get_value ( parameters );
+    string type = get_clean_value ( parameters );
     return stoi_p( type );
 }
 
@@ -264,39 +242,32 @@ vector<vector<int>> get_component_orderings(string parameter){
     return orderings;
 }
 
-string get_input_type ( string in )
+string get_input_type ( string_view in )
 {
-    vector<string> par;
     string ret_val = "u";
+    string buffer;
     
-    string_split( in, '*', par );
-    
-    if ( par.size() )
+    if ( in.find( '*' ) != string_view::npos )
     {
-        par[1].erase( remove( par[1].begin(), par[1].end(), '"' ), par[1].end() );
-        ret_val = par[1].at(0);
+        string_view par = string_strip( string_field( in, '*' ), "\"", buffer );
+        ret_val = par.at(0);
     }
     
     
     return ret_val;
 }
 
-int get_input_port ( string in )
+int get_input_port ( string_view in )
 {
-    vector<string> par;
     int ret_val = 0;
-    string val;
+    string buffer;
     
-    string_split( in, '*', par );
-    
-    
-    if ( par.size() )
+    if ( in.find( '*' ) != string_view::npos )
     {
-        par[1].erase( remove( par[1].begin(), par[1].end(), '"' ), par[1].end() );
-        if ( par[1].size() > 1 )
+        string_view par = string_strip( string_field( in, '*' ), "\"", buffer );
+        if ( par.size() > 1 )
         {
-            val = par[1].at(1);
-            ret_val =  stoi_p ( val );
+            ret_val =  stoi_p ( string( 1, par[1] ) );
         }
     }
     
@@ -306,19 +277,17 @@ int get_input_port ( string in )
 }
 
 
-string get_info_type ( string in )
+string get_info_type ( string_view in )
 {
-    vector<string> par;
     string ret_val = "u";
+    string buffer;
 
-    string_split( in, '*', par );
-    
-    if ( par.size() )
+    if ( in.find( '*' ) != string_view::npos )
     {
-        par[1].erase( remove( par[1].begin(), par[1].end(), '"' ), par[1].end() );
-        if ( par[1].size() > 2 )
+        string_view par = string_strip( string_field( in, '*' ), "\"", buffer );
+        if ( par.size() > 2 )
         {
-            ret_val = par[1].at(2);
+            ret_val = par[2];
         }
     }
     
@@ -327,27 +296,22 @@ string get_info_type ( string in )
 }
 
 
-int get_input_size ( string in )
+int get_input_size ( string_view in )
 {
-    
-    vector<string> bit_sizes;
     int ret_val = 32;
+    string buffer;
     
-    string_split( in, ':', bit_sizes );
-    
-    if ( bit_sizes.size() )
+    if ( in.find( ':' ) != string_view::npos )
     {
-        bit_sizes[1].erase( remove( bit_sizes[1].begin(), bit_sizes[1].end(), '"' ), bit_sizes[1].end() );
-        bit_sizes[1].erase( remove( bit_sizes[1].begin(), bit_sizes[1].end(), ']' ), bit_sizes[1].end() );
-        bit_sizes[1].erase( remove( bit_sizes[1].begin(), bit_sizes[1].end(), ';' ), bit_sizes[1].end() );
+        int bit_size = stoi_p( string( string_strip( string_field( in, ':' ), "\"];", buffer ) ) );
 
-        if ( stoi_p( bit_sizes[1] ) == 0 ) // if 0 force to 1!! 
+        if ( bit_size == 0 ) // if 0 force to 1!! 
         {
             ret_val = 1; 
         }
         else
         {
-            ret_val = stoi_p( bit_sizes[1] );
+            ret_val = bit_size;
         }                        
 
     }
@@ -356,49 +320,77 @@ int get_input_size ( string in )
 
 }
 
-IN_T get_component_inputs ( string in , int components_in_netlist )
+// Highest N of the ports <prefix>N listed in an in/out attribute (0 if none)
+int get_ports_number ( string_view ports, string_view prefix )
 {
-    vector<string> v;
-    vector<string> par;
-    vector<string> bit_sizes;
-    IN_T inputs;
+    int ports_number = 0;
 
-    in.erase( remove( in.begin(), in.end(), '\t' ), in.end() );
-        
-    inputs.size = 0;
-    
-    string_split( in, '=', par ); 
-    
-    if ( par.size() )
+    for ( size_t pos = ports.find( prefix ); pos != string::npos; pos = ports.find( prefix, pos + 1 ) )
     {
-        par[1].erase( remove( par[1].begin(), par[1].end(), '"' ), par[1].end() );
+        int indx = 0;
+        for ( size_t digit = pos + prefix.size(); digit < ports.size() && isdigit( ports[digit] ); digit++ )
+        {
+            indx = indx * 10 + ( ports[digit] - '0' );
+        }
+        ports_number = max( ports_number, indx );
+    }
+
+    return ports_number;
+}
 
+// Appends a port to a component (e.g., the fake control input of a component without bbcount)
+void add_port ( IN_T &inputs )
+{
+    inputs.size += 1;
+    if ( ( int ) inputs.input.size() < inputs.size )
+    {
+        inputs.input.resize( inputs.size );
     }
-    
-    string test_string;
+}
 
-    for ( int indx = MAX_INPUTS ; indx > 0; indx-- )
+void add_port ( OUT_T &outputs )
+{
+    outputs.size += 1;
+    if ( ( int ) outputs.output.size() < outputs.size )
     {
-        test_string = "in";
-        test_string += to_string(indx);
-        if ( par[1].find(test_string) != std::string::npos )
-        {
-            inputs.size = indx;
-            break;
-        }
-            
+        outputs.output.resize( outputs.size );
+    }
+}
+
+// Makes room for the port of a connection, also if the component did not declare it
+template <typename T> void grow_ports ( vector<T> &ports, int indx )
+{
+    if ( indx >= 0 && indx >= ( int ) ports.size() )
+    {
+        ports.resize( indx + 1 );
     }
+}
+
+IN_T get_component_inputs ( string_view in , int components_in_netlist )
+{
+    static vector<string_view> v;   // Reused for all the components
+    string buffer;
+    IN_T inputs;
+
+    inputs.size = 0;
+    
+    // Value of the attribute, without tabs and quotes
+    string_view par = string_strip( string_field( in, '=' ), "\t\"", buffer );
+    
+    inputs.size = get_ports_number ( par, "in" );
 
     int input_indx = 0;
 
+    inputs.input.resize( max( inputs.size, 1 ) );
+
     if ( inputs.size == 1 )
     {
-        inputs.input[input_indx].bit_size = get_input_size ( par[1] );
+        inputs.input[input_indx].bit_size = get_input_size ( par );
         
         
-        inputs.input[input_indx].type = get_input_type ( par[1] );
-        inputs.input[input_indx].port = get_input_port ( par[1] );
-        inputs.input[input_indx].info_type = get_info_type ( par[1] ); 
+        inputs.input[input_indx].type = get_input_type ( par );
+        inputs.input[input_indx].port = get_input_port ( par );
+        inputs.input[input_indx].info_type = get_info_type ( par ); 
         if ( inputs.input[input_indx].info_type == "a" )
         {
             nodes[components_in_netlist].address_size =  inputs.input[input_indx].bit_size;
@@ -412,14 +404,18 @@ IN_T get_component_inputs ( string in , int components_in_netlist )
     }
     else
     {
-        string_split( par[1], ' ', v );
+        string_split( par, ' ', v );
         
         if ( v.size() )
         {
-            for ( int indx = 0; indx <  v.size(); indx++ )
+            for ( int indx = 0; indx < ( int ) v.size(); indx++ )
             {
                     if ( !(v[indx].empty()) )
                     {
+                        if ( input_indx >= ( int ) inputs.input.size() )
+                        {
+                            inputs.input.resize( input_indx + 1 );
+                        }
                         inputs.input[input_indx].bit_size = get_input_size ( v[indx] );
                         inputs.input[input_indx].type = get_input_type ( v[indx] );
                         inputs.input[input_indx].port = get_input_port ( v[indx] );
@@ -445,56 +441,43 @@ IN_T get_component_inputs ( string in , int components_in_netlist )
 
 }
 
-OUT_T get_component_outputs ( string parameters )
+OUT_T get_component_outputs ( string_view parameters )
 {
-    vector<string> v;
-    vector<string> bit_sizes;
-    vector<string> par;
+    static vector<string_view> v;   // Reused for all the components
+    string buffer;
 
     OUT_T outputs;
     
 
-    string_split( parameters, '=', par ); 
-    
-    if ( par.size() )
-    {
-        par[1].erase( remove( par[1].begin(), par[1].end(), '"' ), par[1].end() );
-
-    }
-    
-    string test_string;
-
+    // Value of the attribute, without quotes
+    string_view par = string_strip( string_field( parameters, '=' ), "\"", buffer );
     
-    for ( int indx = MAX_OUTPUTS ; indx > 0; indx-- )
-    {
-        test_string = "out";
-        test_string += to_string(indx);
-        if ( parameters.find(test_string) != std::string::npos )
-        {
-            outputs.size = indx;
-            break;
-        }
-            
-    }
+    outputs.size = get_ports_number ( parameters, "out" );
 
     int output_indx = 0;
     
+    outputs.output.resize( max( outputs.size, 1 ) );
+
     if ( outputs.size == 1 )
     {
-        outputs.output[output_indx].bit_size = get_input_size ( par[1] );
-        outputs.output[output_indx].type = get_input_type ( par[1] );
-        outputs.output[output_indx].port = get_input_port ( par[1] );
-        outputs.output[output_indx].info_type = get_info_type ( par[1] );
+        outputs.output[output_indx].bit_size = get_input_size ( par );
+        outputs.output[output_indx].type = get_input_type ( par );
+        outputs.output[output_indx].port = get_input_port ( par );
+        outputs.output[output_indx].info_type = get_info_type ( par );
     }
     else
     {
-        string_split( par[1], ' ', v );
+        string_split( par, ' ', v );
         if ( v.size() )
         {
-            for ( int indx = 0; indx <  v.size(); indx++ )
+            for ( int indx = 0; indx < ( int ) v.size(); indx++ )
             {
                     if ( !(v[indx].empty()) )
                     {
+                        if ( output_indx >= ( int ) outputs.output.size() )
+                        {
+                            outputs.output.resize( output_indx + 1 );
+                        }
                         outputs.output[output_indx].bit_size = get_input_size( v[indx] );
                         outputs.output[output_indx].type = get_input_type ( v[indx] );
                         outputs.output[output_indx].port = get_input_port ( v[indx] );
@@ -508,170 +491,149 @@ OUT_T get_component_outputs ( string parameters )
     return outputs;
 }
 
-string get_component_name ( string name )
+string get_component_name ( string_view name )
 {
-    string name_ret;
-    name.erase( remove( name.begin(), name.end(), '\t' ), name.end() );    
-    name.erase( remove( name.begin(), name.end(), '"' ), name.end() );
-    name.erase( remove( name.begin(), name.end(), ' ' ), name.end() );
+    string buffer;
+    string name_ret ( string_strip( name, "\t\" ", buffer ) );
     
-    if ( name[0] == '_' )
+    if ( name_ret[0] == '_' )
     {
         //cout << "***WARNING***: Vivado doesn't support names with '_' as first character. Component "<< name <<" renamed as ";
-        name.replace(0,1,"");
+        name_ret.replace(0,1,"");
         //cout << name << endl;
     }
         
-    name_ret = name;
     return name_ret;
 
 }
 
-void parse_connections ( string line )
+int get_node_id ( const string &name )
+{
+    unordered_map<string, int>::const_iterator it = node_ids.find( name );
+    return it == node_ids.end() ? COMPONENT_NOT_FOUND : it->second;
+}
+
+// Edge from -> to, with the attributes between the brackets (from=outN, to=inN)
+void add_connection ( string from, string to, string_view attributes )
 {
     
-    vector<string> v;
-    vector<string> from_to;
-    vector<string> parameters;
+    static vector<string_view> parameters;   // Reused for all the edges
+    string from_buffer, to_buffer;
     
     
     int current_node_id;
     int next_node_id;
     
-    string_split(line, '>', v);
-
-    int i;
-    if ( v.size() > 0 )
+    if ( from[0] == '_' )
     {
-        v[0].erase( remove( v[0].begin(), v[0].end(), ' ' ), v[0].end() );
-        v[0].erase( remove( v[0].begin(), v[0].end(), '-' ), v[0].end() );
-        v[0].erase( remove( v[0].begin(), v[0].end(), '\t' ), v[0].end() );
-        v[0].erase( remove( v[0].begin(), v[0].end(), '"' ), v[0].end() );
-        
-        string_split( v[1], '[', from_to );
-        from_to[0].erase( remove( from_to[0].begin(), from_to[0].end(), ' ' ), from_to[0].end() );
-        from_to[0].erase( remove( from_to[0].begin(), from_to[0].end(), '\t' ), from_to[0].end() );
-        from_to[0].erase( remove( from_to[0].begin(), from_to[0].end(), '"' ), from_to[0].end() );
+        from.replace(0,1,"");
+    }
 
-        if ( v[0][0] == '_' )
-        {
-            v[0].replace(0,1,"");
-        }
+    if ( to[0] == '_' )
+    {
+        to.replace(0,1,"");
+    }
+    
+    
+    current_node_id = get_node_id ( from );
+    next_node_id = get_node_id ( to );
 
-        if ( from_to[0][0] == '_' )
-        {
-            from_to[0].replace(0,1,"");
-        }
-        
-        
-        current_node_id = COMPONENT_NOT_FOUND;
-        for (i = 0; i < components_in_netlist; i++) 
+    string_split( attributes, ',', parameters );
+    
+    int input_indx = 0;
+    int output_indx = 0;
+    int indx;
+        for ( indx = 0; indx < ( int ) parameters.size(); indx++ )
         {
-            if ( nodes[i].name.compare(v[0]) == 0 )
+            string_view parameter = parameters[indx];
+            if ( parameter.find("from") != string_view::npos )
             {
-                current_node_id = i;
-                break;
+                // from=outN
+                parameter = string_strip( parameter, " \t\"", from_buffer );
+                parameter.remove_prefix( min( parameter.size(), (size_t) 8 ) );
+                output_indx = stoi_p( string( parameter ) );
+                output_indx--;
             }
-        }
-        next_node_id = COMPONENT_NOT_FOUND;
-        
-        for (i = 0; i < components_in_netlist; i++) 
-        {
-            if ( nodes[i].name.compare(from_to[0]) == 0 )
+            if ( parameter.find("to") != string_view::npos )
             {
-                next_node_id = i;
-                break;
+                // to=inN
+                parameter = string_strip( parameter, " \t\";]", to_buffer );
+                parameter.remove_prefix( min( parameter.size(), (size_t) 5 ) );
+                input_indx = stoi_p( string( parameter ) );
+                input_indx--;
             }
+            
         }
+    
+    if ( current_node_id != COMPONENT_NOT_FOUND && next_node_id != COMPONENT_NOT_FOUND )
+    {
+        grow_ports( nodes[current_node_id].outputs.output, output_indx );
+        grow_ports( nodes[next_node_id].inputs.input, input_indx );
+        nodes[current_node_id].outputs.output[output_indx].next_nodes_id = next_node_id;
+        nodes[current_node_id].outputs.output[output_indx].next_nodes_port = input_indx;
+        nodes[next_node_id].inputs.input[input_indx].prev_nodes_id = current_node_id;
+
+         // AYAAA: DEBUGGING: 10/08/2023:
+        /*if(nodes[nodes[current_node_id].outputs.output[output_indx].next_nodes_id].type == "ROB") {
+            cout << "\tAYAAA: found an ROB and its calculated next_node_id is " << next_node_id << endl;
+            cout << "\tAYAAA: found an ROB and its calculated next_nodes_port is " << input_indx << endl;
+            cout << "\tAYAAA: found an ROB and its calculated prev_nodes_id is " << current_node_id << endl;
+        } */
 
-        string_split( from_to[1], ',', parameters );
-        
-        int input_indx;
-        int output_indx;
-        int indx;
-            for ( indx = 0; indx < parameters.size(); indx++ )
-            {
-                if ( parameters[indx].find("from") != std::string::npos )
-                {
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), ' ' ), parameters[indx].end() );
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), '\t' ), parameters[indx].end() );
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), '"' ), parameters[indx].end() );
-                    parameters[indx].erase(0, 8);
-                    output_indx = stoi_p( parameters[indx] );
-                    output_indx--;
-                }
-                if ( parameters[indx].find("to") != std::string::npos )
-                {
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), ' ' ), parameters[indx].end() );
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), '\t' ), parameters[indx].end() );
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), '"' ), parameters[indx].end() );
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), ';' ), parameters[indx].end() );
-                    parameters[indx].erase( remove( parameters[indx].begin(), parameters[indx].end(), ']' ), parameters[indx].end() );
-                    
-                    
-                    parameters[indx].erase(0, 5);
-                    
-                    input_indx = stoi_p( parameters[indx] );
-                    input_indx--;
-                }
-                
-            }
         
-        if ( current_node_id != COMPONENT_NOT_FOUND && next_node_id != COMPONENT_NOT_FOUND )
-        {
-            nodes[current_node_id].outputs.output[output_indx].next_nodes_id = next_node_id;
-            nodes[current_node_id].outputs.output[output_indx].next_nodes_port = input_indx;
-            nodes[next_node_id].inputs.input[input_indx].prev_nodes_id = current_node_id;
-
-             // AYAAA: DEBUGGING: 10/08/2023:
-            /*if(nodes[nodes[current_node_id].outputs.output[output_indx].next_nodes_id].type == "ROB") {
-                cout << "\tAYAAA: found an ROB and its calculated next_node_id is " << next_node_id << endl;
-                cout << "\tAYAAA: found an ROB and its calculated next_nodes_port is " << input_indx << endl;
-                cout << "\tAYAAA: found an ROB and its calculated prev_nodes_id is " << current_node_id << endl;
-            } */
+    }
+    else
+    {
+        cout << "Netlist Error" << endl;
 
-            
+        if ( current_node_id == COMPONENT_NOT_FOUND )
+        {
+                cout << "Node Description "<< from << " not found. Not ID assigned" << endl;
         }
         else
+            
+        if ( next_node_id == COMPONENT_NOT_FOUND )
         {
-            cout << "Netlist Error" << endl;
-
-            if ( current_node_id == COMPONENT_NOT_FOUND )
-            {
-                    cout << "Node Description "<< v[0] << " not found. Not ID assigned" << endl;
-            }
-            else
-                
-            if ( next_node_id == COMPONENT_NOT_FOUND )
-            {
-                    cout << "Node ID" << current_node_id << "Node Name: " << nodes[current_node_id].name << " has not next node for output " << output_indx << endl;
-            }
-                
-            cout << "Exiting without producing netlist" << endl;
-            exit ( 0);
-
+                cout << "Node ID" << current_node_id << "Node Name: " << nodes[current_node_id].name << " has not next node for output " << output_indx << endl;
         }
             
+        cout << "Exiting without producing netlist" << endl;
+        exit ( 0);
+
+    }
+}
+
+void parse_connections ( string_view line )
+{
+    string buffer;
+    string_view::size_type arrow = line.find( '>' );
+
+    if ( arrow != string_view::npos )
+    {
+        string from ( string_strip( line.substr( 0, arrow ), " -\t\"", buffer ) );
+        
+        string_view v_1 = string_field( line, '>' );
+        string to ( string_strip( v_1.substr( 0, v_1.find( '[' ) ), " \t\"", buffer ) );
+
+        add_connection ( from, to, string_field( v_1, '[' ) );
     }    
 }
 
 
-string check_comments ( string line  )
+string_view check_comments ( string_view line  )
 {
-    vector<string> v;
-    string_split(line, COMMENT_CHARACTER, v);
-    
-    if ( v.size() > 0 )
-        return  v[0];
-    else
-        return line;
-
+    return line.substr( 0, line.find( COMMENT_CHARACTER ) );
 }
 
-void parse_components ( string v_0, string v_1 )
+void parse_components ( string_view v_0, string_view v_1 )
 {
-    vector<string> parameters;
-    string parameter;
+    static vector<string_view> parameters;   // Reused for all the components
+    static string parameter;
+
+    if ( components_in_netlist >= ( int ) nodes.size() )
+    {
+        nodes.resize( components_in_netlist + 1 );
+    }
 
     nodes[components_in_netlist].name = get_component_name ( v_0 );
 
@@ -696,9 +658,10 @@ void parse_components ( string v_0, string v_1 )
           //  cout << parameters[k] << endl;
         //cout << "AYAAA: parameters size of " << nodes[components_in_netlist].type << " is: " << parameters.size() << endl;
 
-        for ( indx = 0; indx < parameters.size(); indx++ )
+        for ( indx = 0; indx < ( int ) parameters.size(); indx++ )
         {
-            parameter = string_remove_blank ( parameters[indx] );
+            parameter.assign( parameters[indx] );
+            parameter.erase( remove( parameter.begin(), parameter.end(), ' ' ), parameter.end() );
             
             if ( parameter.find("type") != std::string::npos )
             {
@@ -789,7 +752,7 @@ void parse_components ( string v_0, string v_1 )
                 if ( nodes[components_in_netlist].bbcount == 0 )
                 {
                     nodes[components_in_netlist].bbcount = 1;
-                    nodes[components_in_netlist].inputs.size += 1;
+                    add_port( nodes[components_in_netlist].inputs );
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].type = "c";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].bit_size = 32;
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].info_type = "fake"; //Andrea 20200128 Try to force 0 to inputs.
@@ -806,7 +769,7 @@ void parse_components ( string v_0, string v_1 )
                 if ( nodes[components_in_netlist].load_count == 0 )
                 {
                     nodes[components_in_netlist].load_count = 1;
-                    nodes[components_in_netlist].inputs.size += 1;
+                    add_port( nodes[components_in_netlist].inputs );
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].type = "l";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].info_type = "a";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].bit_size = 32;
@@ -816,7 +779,7 @@ void parse_components ( string v_0, string v_1 )
 //                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].info_type = "d";
 //                     
                     
-                    nodes[components_in_netlist].outputs.size += 1;
+                    add_port( nodes[components_in_netlist].outputs );
                     nodes[components_in_netlist].outputs.output[nodes[components_in_netlist].outputs.size-1].type = "l";
                     nodes[components_in_netlist].outputs.output[nodes[components_in_netlist].outputs.size-1].info_type = "a";
                     nodes[components_in_netlist].outputs.output[nodes[components_in_netlist].outputs.size-1].bit_size = 32;
@@ -832,14 +795,14 @@ void parse_components ( string v_0, string v_1 )
                 if ( nodes[components_in_netlist].store_count == 0 )
                 {
                     nodes[components_in_netlist].store_count = 1;
-                    nodes[components_in_netlist].inputs.size += 1;
+                    add_port( nodes[components_in_netlist].inputs );
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].type = "s";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].info_type = "a";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].port = 0; //Andrea 20200424
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].bit_size = 32; //Andrea 20200424
 
                     
-                    nodes[components_in_netlist].inputs.size += 1;
+                    add_port( nodes[components_in_netlist].inputs );
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].type = "s";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].info_type = "d";
                     nodes[components_in_netlist].inputs.input[nodes[components_in_netlist].inputs.size-1].port = 0; //Andrea 20200424
@@ -856,6 +819,10 @@ void parse_components ( string v_0, string v_1 )
             {
                 nodes[components_in_netlist].bbId = get_component_bbId( parameters[indx] );
             }
+            if ( parameter.find("bbID=") != std::string::npos )
+            {
+                nodes[components_in_netlist].basic_block = get_component_bbId( parameters[indx] );
+            }
             if ( parameter.find("portId") != std::string::npos )
             {
                 nodes[components_in_netlist].portId = get_component_portId ( parameters[indx] );
@@ -899,7 +866,7 @@ void parse_components ( string v_0, string v_1 )
                 
             }
             if ( parameter.find("orderings") != std::string::npos){
-                nodes[components_in_netlist].orderings = get_component_orderings(parameters[indx]);
+                nodes[components_in_netlist].orderings = get_component_orderings( string( parameters[indx] ) );
             }
             if ( parameter.find("constants") != std::string::npos )
             {
@@ -988,28 +955,23 @@ void parse_components ( string v_0, string v_1 )
         
         
         
+        node_ids.emplace( nodes[components_in_netlist].name, components_in_netlist );
         components_in_netlist++;
-        if ( components_in_netlist >= MAX_NODES )
-        {
-            cout << "The number of components in the netlist exceed the maximum allowed "<< MAX_NODES << endl;
-        }
 
     }
 }
 
-void parse_line ( string line )
+void parse_line ( string_view line )
 {
-    vector<string> v;
-    
     line = check_comments ( line );
-    string_split( line, '[', v);
+    string_view::size_type bracket = line.find( '[' );
 
-    if ( v.size() > 0 )
+    if ( bracket != string_view::npos )
     {
         int line_type = check_line ( line );
         if ( line_type == COMPONENT_DESCRIPTION_LINE )
         {
-            parse_components ( v[0], v[1] );
+            parse_components ( line.substr( 0, bracket ), string_field( line, '[' ) );
         }
         else if ( line_type == COMPONENT_CONNECTION_LINE ) //is a connection line
         {
@@ -1021,24 +983,73 @@ void parse_line ( string line )
 
 
 
+void parse_reset ( void )
+{
+    components_in_netlist = 0;
+    nodes.clear();
+    node_ids.clear();
+}
+
+// Same as parse_dot, from a netlist in memory: the blocks are before the channels, as in a dot file
+void parse_netlist ( const NETLIST_VIEW_T &netlist )
+{
+    string attributes;
+
+    parse_reset ( );
+
+    for ( const NETLIST_BLOCK_T &block : netlist.blocks )
+    {
+        parse_components ( block.name, block.attributes );
+    }
+    for ( const NETLIST_CHANNEL_T &channel : netlist.channels )
+    {
+        attributes = "from=" + channel.from_port + ", to=" + channel.to_port;
+        add_connection ( channel.from, channel.to, attributes );
+    }
+
+    nodes.resize( components_in_netlist );
+}
+
 void parse_dot ( string filename )
 {
     
     string input_filename = filename + ".dot";
-    ifstream inFile(input_filename);
-    string strline;
 
-    components_in_netlist = 0;
+    parse_reset ( );
+
+    // The file is mapped and parsed in place, line by line
+    int fd = open( input_filename.c_str(), O_RDONLY );
+    struct stat file_stat;
+    const char *text = NULL;
 
-    if (inFile.is_open()) 
+    if ( fd >= 0 && fstat( fd, &file_stat ) == 0 )
     {
-        while ( inFile )
+        text = file_stat.st_size ? (const char *) mmap( NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 ) : "";
+    }
+    if ( fd >= 0 )
+    {
+        close( fd );
+    }
+
+    if ( text != NULL && text != MAP_FAILED ) 
+    {
+        string_view file( text, file_stat.st_size );
+        string_view::size_type begin = 0;
+
+        while ( begin <= file.size() )
         {
-            getline(inFile, strline );
-            parse_line ( strline );
+            string_view::size_type end = min( file.find( '\n', begin ), file.size() );
+            parse_line ( file.substr( begin, end - begin ) );
+            begin = end + 1;
         }
 
-        inFile.close();
+        if ( file_stat.st_size )
+        {
+            munmap( (void *) text, file_stat.st_size );
+        }
+
+        // Drops the entry of a trailing line without a component name
+        nodes.resize( components_in_netlist );
     }
     else
     {
@@ -1046,5 +1057,3 @@ void parse_dot ( string filename )
         exit ( EXIT_FAILURE );
     }
 }
-
-
@@ -21,8 +21,8 @@ using namespace std;
 #include <string.h>  // AYA: 05/08/2023
 
 
-#define MAX_INPUTS  512//64
-#define MAX_OUTPUTS 512// 64
+#include <vector>
+#include "libdot2vhdl.h"
 
 #define COMPONENT_NOT_FOUND -1 
 
@@ -37,8 +37,8 @@ typedef struct input
 
 typedef struct in
 {
-    int size;
-    INPUT_T input[MAX_OUTPUTS];
+    int size = 0;
+    vector<INPUT_T> input = vector<INPUT_T>( 1 );   // At least size entries and port 0 (read by the writer)
 } IN_T;
 
 typedef struct output
@@ -54,8 +54,8 @@ typedef struct output
 
 typedef struct out
 {
-    int size;
-    OUTPUT_T output[MAX_OUTPUTS];
+    int size = 0;
+    vector<OUTPUT_T> output = vector<OUTPUT_T>( 1 ); // At least size entries and port 0 (read by the writer)
 } OUT_T;
 
 
@@ -81,6 +81,7 @@ typedef struct node
     int     address_size = 32;
     bool    mem_address;
     int     bbId = -1; 
+    int     basic_block = -1;   // bbID of the component (bbId above is the one of a memory port)
     int     portId = -1; 
     int     offset = -1;
     int     lsq_indx = -1;
@@ -108,11 +109,11 @@ typedef struct node
 } NODE_T;
 
 
-#define MAX_NODES 16384//4096
-
 void parse_dot ( string filename );
+void parse_netlist ( const NETLIST_VIEW_T &netlist );
 
-extern NODE_T nodes[MAX_NODES];
+// Grown while parsing: components_in_netlist entries are valid
+extern vector<NODE_T> nodes;
 
 extern int components_in_netlist;
 extern int lsqs_in_netlist;
@@ -13,6 +13,7 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <sstream>
 #include "stdlib.h"
 #include <string.h>
 #include "dot2vhdl.h"
@@ -21,6 +22,7 @@
 #include "eda_if.h"
 #include "lsq_generator.h"
 #include "string_utils.h"
+#include "manifest.h"
 
 
 using namespace std;
@@ -30,12 +32,10 @@ using namespace std;
 
 void write_vivado_script ( string top_level_filename  )
 {
-    ofstream outFile;
+    ostringstream outFile;
 
     //cout << "top_level_filename" << top_level_filename << endl;
     string vivado_script_filename = top_level_filename+"_vivado_synt.tcl";
-    
-    outFile.open (vivado_script_filename);
 
     //outFile << "read_vhdl -vhdl2008 " << "Elastic_components.vhd" << endl;
     outFile << "read_vhdl -vhdl2008  /home/dynamatic/Dynamatic/etc/dynamatic/components/elastic_components.vhd" << endl;
@@ -60,17 +60,15 @@ void write_vivado_script ( string top_level_filename  )
 
     //outFile << "create_clock -period 1.000 -name clk -waveform {0.000 0.500} -add [get_ports -filter { NAME =~  \"*ap_clk*\" && DIRECTION == \"IN\" }] " << endl;
 
-    outFile.close();
+    manifest_write_file ( vivado_script_filename, { outFile.str() } );
 
 }
 
 void write_modelsim_script ( string top_level_filename )
 {
-    ofstream outFile;
+    ostringstream outFile;
 
     string modelsim_script_filename = top_level_filename+"_modelsim.tcl";
-    
-    outFile.open (modelsim_script_filename);
 
     outFile << "vcom -2008 /home/dynamatic/Dynamatic/etc/dynamatic/components/elastic_components.vhd" << endl;  
     outFile << "vcom -2008 /home/dynamatic/Dynamatic/etc/dynamatic/components/delay_buffer.vhd" << endl;
@@ -91,7 +89,7 @@ void write_modelsim_script ( string top_level_filename )
         //outFile << "vcom -2008 hdl/" << top_level_filename << ".vhd" << endl;
     }
     
-    outFile.close();
+    manifest_write_file ( modelsim_script_filename, { outFile.str() } );
     
 }
 
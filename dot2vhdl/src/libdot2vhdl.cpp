@@ -0,0 +1,151 @@
+/*
+*  C++ Implementation: dot2Vhdl
+*
+* Description:
+*
+*
+* Author: Andrea Guerrieri <andrea.guerrieri@epfl.ch (C) 2019
+*
+* Copyright: See COPYING file that comes with this distribution
+*
+*/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "stdlib.h"
+#include <string.h>
+#include "dot2vhdl.h"
+#include "dot_parser.h"
+#include "vhdl_writer.h"
+#include "eda_if.h"
+#include "lsq_generator.h"
+#include "reports.h"
+#include "checks.h"
+#include "manifest.h"
+#include "perf_counters.h"
+#include "libdot2vhdl.h"
+
+
+using namespace std;
+
+
+int debug_mode = FALSE;
+int report_area_mode = FALSE;
+int force_mode = FALSE;
+
+
+string input_filename[MAX_INPUT_FILES];
+string output_filename[MAX_INPUT_FILES];
+string top_level_filename;
+string lsq_depths_filename;
+string lsq_cache_dirname;
+string target_name = "default";
+string perf_counters_mode;
+int perf_counters_width = PERF_COUNTERS_WIDTH_DEFAULT;
+int jobs = 1;
+int dot_input_files = 0;
+
+
+// The netlist of the first file is given in memory if not NULL
+int dot2vhdl_run ( const NETLIST_VIEW_T *netlist )
+{
+    
+    vhdl_writer vhdl_writer;
+    
+    top_level_filename = input_filename[0];
+
+    manifest_read ( top_level_filename, force_mode );
+
+    if ( !lsq_depths_filename.empty() && !lsq_read_depths ( lsq_depths_filename ) )
+    {
+        cout << "Error: LSQ depths file " << lsq_depths_filename << " could not be read" << endl;
+        return 1;
+    }
+
+    for ( int indx = 0; indx < dot_input_files; indx++ )
+    {
+        
+        if ( netlist != NULL && indx == 0 )
+        {
+            cout << "Reading the netlist of "<< input_filename[indx] << ".dot from memory" << endl;
+
+            parse_netlist ( *netlist );
+        }
+        else
+        {
+            cout << "Parsing "<< input_filename[indx] << ".dot" << endl;
+        
+            parse_dot ( input_filename[indx] );
+        }
+        
+        check_netlist ( );
+
+        // The counters are in the top-level module
+        if ( indx == 0 && !report_area_mode && !perf_counters_select ( input_filename[indx] ) )
+        {
+            return 1;
+        }
+        
+        
+        if ( report_area_mode )
+        {
+            report_instances ();
+            if ( !report_area ( ) )
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            report_instances ();
+            cout << "Generating " << output_filename[indx] << ".vhd" << endl;
+            vhdl_writer.write_vhdl ( output_filename[indx] , indx );
+        }
+    }
+    
+    
+    // Only the estimation of the area, without the generation
+    if ( report_area_mode )
+    {
+        return 0;
+    }
+
+    //vhdl_writer.write_tb_wrapper ( top_level_filename );
+    
+
+    lsq_generate_configuration ( top_level_filename );
+    bool lsqs_generated = lsq_generate ( top_level_filename );
+
+    write_vivado_script ( top_level_filename );
+    write_modelsim_script ( top_level_filename );
+
+    // The LSQs generated are kept in the manifest, the failed ones are run again next time
+    manifest_write ( );
+
+    if ( !lsqs_generated )
+    {
+        return 1;
+    }
+    
+    cout << endl;
+    cout << "Done" ;
+    
+    cout << endl<< endl<< endl;
+    return 0;
+    
+}
+
+int dot2vhdl_generate ( void )
+{
+    return dot2vhdl_run ( NULL );
+}
+
+int dot2vhdl_generate_netlist ( const NETLIST_VIEW_T &netlist, string filename )
+{
+    input_filename[0] = filename;
+    output_filename[0] = filename;
+    dot_input_files = 1;
+
+    return dot2vhdl_run ( &netlist );
+}
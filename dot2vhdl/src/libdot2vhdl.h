@@ -0,0 +1,52 @@
+/*
+*  C++ Implementation: dot2Vhdl
+*
+* Description:
+*
+*
+* Author: Andrea Guerrieri <andrea.guerrieri@epfl.ch (C) 2019
+*
+* Copyright: See COPYING file that comes with this distribution
+*
+*/
+
+
+#ifndef _LIBDOT2VHDL_
+#define _LIBDOT2VHDL_
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Netlist given in memory instead of a dot file (e.g., by the buffers tool).
+// The blocks and the channels are the lines of the dot file, in the same order.
+
+typedef struct netlist_block
+{
+    string name;
+    string attributes;      // As between the brackets of the dot file: type=Fork, in="in1:32", ...
+} NETLIST_BLOCK_T;
+
+typedef struct netlist_channel
+{
+    string from;
+    string to;
+    string from_port;       // outN
+    string to_port;         // inN
+} NETLIST_CHANNEL_T;
+
+typedef struct netlist_view
+{
+    vector<NETLIST_BLOCK_T> blocks;
+    vector<NETLIST_CHANNEL_T> channels;
+} NETLIST_VIEW_T;
+
+
+// Generates the VHDL, the LSQs and the scripts of the dot files given to the standalone dot2vhdl
+int dot2vhdl_generate ( void );
+
+// Same for a netlist in memory: filename is the name of its dot file, without the extension
+int dot2vhdl_generate_netlist ( const NETLIST_VIEW_T &netlist, string filename );
+
+#endif
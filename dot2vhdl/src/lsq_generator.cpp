@@ -19,16 +19,23 @@
 #include <vector>
 #include <algorithm> 
 #include <list>
+#include <map>
 #include <cctype>
 #include <sstream> 
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #include "dot2vhdl.h"
 #include "dot_parser.h"
 #include "vhdl_writer.h"
 #include "lsq_generator.h"
+#include "manifest.h"
 
 
-ofstream lsq_configuration_file;
+ostringstream lsq_configuration_file;
 
 #define LSQ_CONFIGURATION_FNAME "lsq.json"
 
@@ -40,6 +47,9 @@ ofstream lsq_configuration_file;
 
 LSQ_CONFIGURATION_T lsq_conf[MAX_LSQ];
 
+// The LSQ is not generated again if its configuration has the hash of the last generation
+string lsq_configuration_hash[MAX_LSQ];
+
 
 #define MAX_BBs 16
 
@@ -134,9 +144,130 @@ int get_lsq_addresswidth ( int lsq_indx )
 }
 
 
+// Depths of the LSQs measured by simulation (buffers simulate -lsq_depths), by name
+map<string, int> lsq_depths;
+
+bool lsq_read_depths ( string filename )
+{
+    ifstream depths_file ( filename );
+    string line, name;
+    int depth;
+
+    if ( !depths_file.is_open() )
+    {
+        return false;
+    }
+    while ( getline ( depths_file, line ) )
+    {
+        stringstream ss ( line );
+        if ( ! ( ss >> name ) || name[0] == '#' )
+        {
+            continue;
+        }
+        if ( ! ( ss >> depth ) || depth <= 0 )
+        {
+            return false;
+        }
+        lsq_depths[name] = depth;
+    }
+    return true;
+}
+
+// Pads with zeros or truncates the inner lists of a list of lists (e.g., [[0,1,0,0],[2,0,0,0]])
+// to depth entries, when the depth of the LSQ is not the one of the netlist
+string resize_lsq_lists ( string lists, int depth )
+{
+    string resized, entry;
+    vector<string> entries;
+    int level = 0;
+
+    for ( char c : lists )
+    {
+        if ( c == ' ' )
+        {
+            continue;
+        }
+        if ( c == '[' )
+        {
+            level++;
+            if ( level == 2 )
+            {
+                entries.clear();
+                entry.clear();
+                continue;
+            }
+        }
+        else
+        if ( c == ']' && level == 2 )
+        {
+            if ( !entry.empty() )
+            {
+                entries.push_back ( entry );
+            }
+            entries.resize ( depth, "0" );
+            resized += "[";
+            for ( int indx = 0; indx < depth; indx++ )
+            {
+                resized += ( indx == 0 ? "" : ", " ) + entries[indx];
+            }
+            resized += "]";
+            level--;
+            continue;
+        }
+        else
+        if ( c == ']' )
+        {
+            level--;
+        }
+        else
+        if ( c == ',' && level == 2 )
+        {
+            entries.push_back ( entry );
+            entry.clear();
+            continue;
+        }
+        else
+        if ( level == 2 )
+        {
+            entry += c;
+            continue;
+        }
+        resized += c;
+        if ( c == ',' )
+        {
+            resized += ' ';
+        }
+    }
+    return resized;
+}
+
+// Largest number of accesses of a group, e.g., 2 for {1;2;0}
+static int get_max_group_size ( string counts )
+{
+    int max_size = 0, size = 0;
+    bool in_number = false;
+
+    for ( char c : counts + ' ' )
+    {
+        if ( isdigit ( c ) )
+        {
+            size = size * 10 + ( c - '0' );
+            in_number = true;
+        }
+        else
+        if ( in_number )
+        {
+            max_size = max ( max_size, size );
+            size = 0;
+            in_number = false;
+        }
+    }
+    return max_size;
+}
+
 int get_lsq_fifo_depth ( int lsq_indx )
 {
-    int fifodepth;
+    int fifodepth = LSQ_FIFODEPTH_DEFAULT;
     
     for (int i = 0; i < components_in_netlist; i++) 
     {
@@ -146,6 +277,24 @@ int get_lsq_fifo_depth ( int lsq_indx )
             if ( lsq_indx == nodes[i].lsq_indx )
             {
                 fifodepth = nodes[i].fifodepth;
+                if ( lsq_depths.count ( nodes[i].name ) )
+                {
+                    int depth = lsq_depths[nodes[i].name];
+                    int group_size = max ( get_max_group_size ( nodes[i].numLoads ), get_max_group_size ( nodes[i].numStores ) );
+
+                    // The queues hold all the accesses of a group, allocated at once
+                    while ( depth < group_size )
+                    {
+                        depth *= 2;
+                    }
+                    cout << "LSQ " << nodes[i].name << ": depth " << depth << " (" << fifodepth << " in the netlist";
+                    if ( depth != lsq_depths[nodes[i].name] )
+                    {
+                        cout << ", " << lsq_depths[nodes[i].name] << " measured, raised to the largest group of " << group_size << " accesses";
+                    }
+                    cout << ")" << endl;
+                    fifodepth = depth;
+                }
                 break;
             }
         }
@@ -634,7 +783,7 @@ void lsq_write_configuration_file ( string top_level_filename, int lsq_indx )
     lsq_filename += to_string(lsq_indx);
     lsq_filename +="_configuration.json";
     
-    lsq_configuration_file.open ( lsq_filename );
+    lsq_configuration_file.str( "" );
     
     lsq_configuration_file << "{" << endl;
     lsq_configuration_file << "\"specifications\" :[" << endl;
@@ -789,10 +938,22 @@ void lsq_write_configuration_file ( string top_level_filename, int lsq_indx )
     
     lsq_configuration_file << "\"numLoads\": " << get_numLoads( lsq_indx ) << "," << endl;
     lsq_configuration_file << "\"numStores\": " << get_numStores( lsq_indx ) << "," << endl;
-    lsq_configuration_file << "\"loadOffsets\": "<< get_loadOffset( lsq_indx ) << "," << endl;
-    lsq_configuration_file << "\"storeOffsets\": "<< get_storeOffset( lsq_indx ) << "," << endl;
-    lsq_configuration_file << "\"loadPorts\": " << get_loadPorts( lsq_indx ) << "," << endl;
-    lsq_configuration_file << "\"storePorts\": " << get_storePorts( lsq_indx ) << "," << endl;
+    if ( lsq_depths.count ( lsq_conf[lsq_indx].name ) )
+    {
+        // The lists of the netlist have one entry per slot of its depth
+        int depth = lsq_conf[lsq_indx].fifoDepth;
+        lsq_configuration_file << "\"loadOffsets\": "<< resize_lsq_lists ( get_loadOffset( lsq_indx ), depth ) << "," << endl;
+        lsq_configuration_file << "\"storeOffsets\": "<< resize_lsq_lists ( get_storeOffset( lsq_indx ), depth ) << "," << endl;
+        lsq_configuration_file << "\"loadPorts\": " << resize_lsq_lists ( get_loadPorts( lsq_indx ), depth ) << "," << endl;
+        lsq_configuration_file << "\"storePorts\": " << resize_lsq_lists ( get_storePorts( lsq_indx ), depth ) << "," << endl;
+    }
+    else
+    {
+        lsq_configuration_file << "\"loadOffsets\": "<< get_loadOffset( lsq_indx ) << "," << endl;
+        lsq_configuration_file << "\"storeOffsets\": "<< get_storeOffset( lsq_indx ) << "," << endl;
+        lsq_configuration_file << "\"loadPorts\": " << get_loadPorts( lsq_indx ) << "," << endl;
+        lsq_configuration_file << "\"storePorts\": " << get_storePorts( lsq_indx ) << "," << endl;
+    }
     
     lsq_configuration_file << "\"bufferDepth\": 0 "<< endl;
 
@@ -803,7 +964,8 @@ void lsq_write_configuration_file ( string top_level_filename, int lsq_indx )
     lsq_configuration_file << "]" << endl;
     lsq_configuration_file << "}" << endl;
     
-    lsq_configuration_file.close();
+    manifest_write_file ( lsq_filename, { lsq_configuration_file.str() } );
+    lsq_configuration_hash[lsq_indx] = manifest_hash ( { lsq_configuration_file.str() } );
     
 
 // {
@@ -832,7 +994,7 @@ void lsq_write_configuration_file ( string top_level_filename, int lsq_indx )
 void lsq_generate_configuration ( string top_level_filename )
 {
     
-    for ( int lsq_indx; lsq_indx < lsqs_in_netlist; lsq_indx++ )
+    for ( int lsq_indx = 0; lsq_indx < lsqs_in_netlist; lsq_indx++ )
     {    
         lsq_set_configuration ( lsq_indx );
         lsq_write_configuration_file( top_level_filename, lsq_indx );
@@ -840,50 +1002,225 @@ void lsq_generate_configuration ( string top_level_filename )
 }
 
 
-void lsq_generate ( string top_level_filename )
+// Result of the generation of an LSQ, reported when all the generations are done
+typedef struct lsq_generation
+{
+    int lsq_indx;
+    string command;
+    string output;
+    int status = -1;
+    bool cached = false;
+    vector<string> outputs;     // Files generated (or copied from the cache) here
+} LSQ_GENERATION_T;
+
+// Configuration without the blanks outside the strings: the key of the LSQ cache
+string lsq_canonical_configuration ( const string &json )
+{
+    string canonical;
+    bool in_string = false;
+
+    for ( char c : json )
+    {
+        if ( c == '"' )
+        {
+            in_string = !in_string;
+        }
+        if ( in_string || !isspace ( (unsigned char) c ) )
+        {
+            canonical += c;
+        }
+    }
+    return canonical;
+}
+
+// Copies the files generated in from_dir (but the configuration) into to_dir
+void lsq_copy_outputs ( const filesystem::path &from_dir, const filesystem::path &to_dir, const filesystem::path &configuration, error_code &ec, vector<string> *copied = nullptr )
+{
+    for ( const filesystem::directory_entry &entry : filesystem::directory_iterator ( from_dir, ec ) )
+    {
+        if ( entry.path().filename() != configuration )
+        {
+            filesystem::copy ( entry.path(), to_dir / entry.path().filename(), filesystem::copy_options::recursive | filesystem::copy_options::overwrite_existing, ec );
+            if ( ec )
+            {
+                return;
+            }
+            if ( copied != nullptr )
+            {
+                copied->push_back ( ( to_dir / entry.path().filename() ).string() );
+            }
+        }
+    }
+}
+
+// Runs the generator of an LSQ in its own directory (the generators write in the working directory
+// and run concurrently), then moves its files here and into the cache
+void lsq_run_generator ( string configuration_filename, LSQ_GENERATION_T &generation )
+{
+    filesystem::path configuration = filesystem::path ( configuration_filename ).filename();
+    filesystem::path cache_entry;
+    error_code ec;
+
+    if ( !lsq_cache_dirname.empty() )
+    {
+        ifstream configuration_file ( configuration_filename );
+        stringstream json;
+        json << configuration_file.rdbuf();
+
+        cache_entry = filesystem::path ( lsq_cache_dirname ) / manifest_hash ( { lsq_canonical_configuration ( json.str() ) } );
+        if ( filesystem::is_directory ( cache_entry, ec ) )
+        {
+            lsq_copy_outputs ( cache_entry, ".", configuration, ec, &generation.outputs );
+            if ( !ec )
+            {
+                generation.cached = true;
+                generation.status = 0;
+                return;
+            }
+        }
+    }
+
+    filesystem::path work_dir = configuration.stem().string() + "_generate";
+    filesystem::remove_all ( work_dir, ec );
+    filesystem::create_directory ( work_dir, ec );
+    filesystem::copy_file ( configuration_filename, work_dir / configuration, ec );
+    if ( ec )
+    {
+        generation.output = "Cannot prepare " + work_dir.string() + ": " + ec.message() + "\n";
+        return;
+    }
+
+    string cmd = "cd " + work_dir.string() + " && lsq_generate " + configuration.string() + " 2>&1";
+    char line[1035];
+
+    /* Open the command for reading. */
+    FILE *fp = popen( cmd.c_str(), "r" );
+    if (fp == NULL) 
+    {
+        generation.output = "Cannot run " + generation.command + "\n";
+        return;
+    }
+
+    /* Read the output a line at a time - it is printed with the result. */
+    while (fgets(line, sizeof(line)-1, fp) != NULL) 
+    {
+        generation.output += line;
+    }
+
+    int status = pclose(fp);
+    generation.status = WIFEXITED ( status ) ? WEXITSTATUS ( status ) : -1;
+
+    if ( generation.status == 0 )
+    {
+        lsq_copy_outputs ( work_dir, ".", configuration, ec, &generation.outputs );
+        if ( ec )
+        {
+            generation.output += "Cannot copy the generated files: " + ec.message() + "\n";
+            generation.status = -1;
+        }
+        else
+        if ( !cache_entry.empty() )
+        {
+            // Moved into place at once: another dot2vhdl may be filling the same entry
+            filesystem::path cache_tmp = cache_entry.string() + "." + to_string ( getpid() ) + "_" + to_string ( generation.lsq_indx );
+            filesystem::create_directories ( cache_tmp, ec );
+            lsq_copy_outputs ( work_dir, cache_tmp, configuration, ec );
+            if ( !ec )
+            {
+                filesystem::rename ( cache_tmp, cache_entry, ec );
+            }
+            if ( ec )
+            {
+                filesystem::remove_all ( cache_tmp, ec );
+            }
+        }
+    }
+
+    filesystem::remove_all ( work_dir, ec );
+}
+
+// Returns false if a generator failed
+bool lsq_generate ( string top_level_filename )
 {
-    
-    FILE *fp;
-    char path[1035];
-    stringstream ss_path, string_path;
     
     char cmd[512];
+    vector<LSQ_GENERATION_T> generations;
        
     //int lsq_indx;
 
-    for ( int lsq_indx; lsq_indx < lsqs_in_netlist; lsq_indx++ )
+    for ( int lsq_indx = 0; lsq_indx < lsqs_in_netlist; lsq_indx++ )
     {    
 
-        cout << "Generating LSQ " << lsq_indx << " component..." << endl;
-
         //sprintf ( cmd, "java -jar -Xmx7G lsq.jar --target-dir %s --spec-file %s.json", top_level_filename.c_str(), top_level_filename.c_str() );
         //sprintf ( cmd, "java -jar -Xmx7G lsq.jar --target-dir . --spec-file %s_lsq%d_configuration.json",  top_level_filename.c_str(), lsq_indx );
         //sprintf ( cmd, "java -jar -Xmx7G /home/dynamatic/Dynamatic/bin/lsq.jar --target-dir . --spec-file %s_lsq%d_configuration.json",  top_level_filename.c_str(), lsq_indx );
         
         sprintf ( cmd, "lsq_generate %s_lsq%d_configuration.json",  top_level_filename.c_str(), lsq_indx );
         
+        if ( manifest_unchanged ( cmd, lsq_configuration_hash[lsq_indx] ) && manifest_outputs_exist ( cmd ) )
+        {
+            cout << "LSQ " << lsq_indx << " configuration unchanged, not generated" << endl;
+            manifest_set ( cmd, lsq_configuration_hash[lsq_indx] );
+            continue;
+        }
+
+        cout << "Generating LSQ " << lsq_indx << " component..." << endl;
     
         cout << cmd << endl;
 
-        /* Open the command for reading. */
-        fp = popen( cmd, "r" );
-        if (fp == NULL) 
-        {
-            return;
-        }
+        LSQ_GENERATION_T generation;
+        generation.lsq_indx = lsq_indx;
+        generation.command = cmd;
+        generations.push_back ( generation );
+    }
 
-        /* Read the output a line at a time - output it. */
-        while (fgets(path, sizeof(path)-1, fp) != NULL) 
+    // The generators (a JVM each) run on up to jobs threads
+    atomic<int> next ( 0 );
+    auto worker = [&] {
+        for ( int indx = next++; indx < ( int ) generations.size(); indx = next++ )
         {
-            printf("%s", path);
+            LSQ_GENERATION_T &generation = generations[indx];
+            lsq_run_generator ( top_level_filename + "_lsq" + to_string ( generation.lsq_indx ) + "_configuration.json", generation );
         }
+    };
 
-        /* close */
-        pclose(fp);    
-        
-        //cout << "Generating LSQ component..." << endl;
+    vector<thread> threads;
+    for ( int indx = 1; indx < min( jobs, (int) generations.size() ); indx++ )
+    {
+        threads.emplace_back( worker );
+    }
+    worker ( );
+    for ( thread &t : threads )
+    {
+        t.join();
+    }
+
+    int failures = 0;
+    for ( LSQ_GENERATION_T &generation : generations )
+    {
+        cout << generation.output;
 
+        if ( generation.cached )
+        {
+            cout << "LSQ " << generation.lsq_indx << " copied from the cache" << endl;
+        }
+        if ( generation.status == 0 )
+        {
+            // A failed generation is run again next time
+            manifest_set ( generation.command, lsq_configuration_hash[generation.lsq_indx] );
+            manifest_set_outputs ( generation.command, lsq_configuration_hash[generation.lsq_indx], generation.outputs );
+        }
+        else
+        {
+            cout << "Error: LSQ " << generation.lsq_indx << " (" << generation.command << ") failed with status " << generation.status << endl;
+            failures++;
+        }
+    }
+    if ( failures > 0 )
+    {
+        cout << "Error: " << failures << " of " << generations.size() << " LSQs failed" << endl;
     }
+    return failures == 0;
 }
 
 
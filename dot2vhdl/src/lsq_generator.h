@@ -14,10 +14,12 @@
 #define _LSQ_GENERATOR_
 
 void lsq_generate_configuration ( string top_level_filename );
-void lsq_generate ( string top_level_filename );
+bool lsq_generate ( string top_level_filename );
+bool lsq_read_depths ( string filename );
 
 int get_lsq_datawidth ();
 int get_lsq_addresswidth ();
+int get_lsq_fifo_depth ( int lsq_indx );
 
 #define MAX_SIZES   16
 typedef struct bb_params
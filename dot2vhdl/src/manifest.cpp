@@ -0,0 +1,158 @@
+/*
+*  C++ Implementation: dot2Vhdl
+*
+* Description:
+*
+*
+* Author: Andrea Guerrieri <andrea.guerrieri@epfl.ch (C) 2019
+*
+* Copyright: See COPYING file that comes with this distribution
+*
+*/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include "dot2vhdl.h"
+#include "manifest.h"
+
+using namespace std;
+
+string manifest_filename;
+
+// Entry (a file name or a generation step) -> hash of its content
+map<string, string> manifest_previous;
+map<string, string> manifest_current;
+
+
+void manifest_read ( string top_level_filename, bool force )
+{
+    manifest_filename = top_level_filename + "_manifest.txt";
+
+    if ( force )
+    {
+        return;
+    }
+
+    ifstream manifest_file ( manifest_filename );
+    string line;
+
+    // <hash> <entry>
+    while ( getline ( manifest_file, line ) )
+    {
+        size_t space = line.find ( ' ' );
+        if ( space != string::npos )
+        {
+            manifest_previous[line.substr ( space + 1 )] = line.substr ( 0, space );
+        }
+    }
+}
+
+void manifest_write ( void )
+{
+    // The entries not generated in this run are kept
+    for ( auto &entry : manifest_current )
+    {
+        manifest_previous[entry.first] = entry.second;
+    }
+
+    ofstream manifest_file ( manifest_filename );
+
+    for ( auto &entry : manifest_previous )
+    {
+        manifest_file << entry.second << ' ' << entry.first << endl;
+    }
+}
+
+// FNV-1a (64 bits) of the version and texts[first...]
+string manifest_hash ( const vector<string> &texts, int first )
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    auto add = [&hash] ( const string &text ) {
+        for ( unsigned char c : text )
+        {
+            hash = ( hash ^ c ) * 0x100000001b3ULL;
+        }
+    };
+
+    add ( VERSION_STRING );
+    for ( int indx = first; indx < ( int ) texts.size(); indx++ )
+    {
+        add ( texts[indx] );
+    }
+
+    char hex[17];
+    snprintf ( hex, sizeof ( hex ), "%016llx", (unsigned long long) hash );
+    return hex;
+}
+
+bool manifest_unchanged ( string entry, string hash )
+{
+    auto previous = manifest_previous.find ( entry );
+
+    return previous != manifest_previous.end() && previous->second == hash;
+}
+
+void manifest_set ( string entry, string hash )
+{
+    manifest_current[entry] = hash;
+}
+
+void manifest_set_outputs ( string entry, string hash, const vector<string> &outputs )
+{
+    string prefix = entry + " > ";
+
+    // The outputs of the previous run of the step are replaced
+    for ( auto previous = manifest_previous.lower_bound ( prefix ); previous != manifest_previous.end() && previous->first.compare ( 0, prefix.size(), prefix ) == 0; )
+    {
+        previous = manifest_previous.erase ( previous );
+    }
+    for ( const string &output : outputs )
+    {
+        manifest_current[prefix + output] = hash;
+    }
+}
+
+// True if the step has recorded outputs and all of them are on disk
+bool manifest_outputs_exist ( string entry )
+{
+    string prefix = entry + " > ";
+    bool found = false;
+
+    for ( auto previous = manifest_previous.lower_bound ( prefix ); previous != manifest_previous.end() && previous->first.compare ( 0, prefix.size(), prefix ) == 0; previous++ )
+    {
+        if ( !ifstream ( previous->first.substr ( prefix.size() ) ).good() )
+        {
+            return false;
+        }
+        found = true;
+    }
+    return found;
+}
+
+// Writes the texts into the file, unless it exists with the same hash of texts[hashed_from...]
+// (the texts before, e.g. the creation date, are not compared). Returns true if written.
+bool manifest_write_file ( string filename, const vector<string> &texts, int hashed_from )
+{
+    string hash = manifest_hash ( texts, hashed_from );
+
+    manifest_set ( filename, hash );
+
+    if ( manifest_unchanged ( filename, hash ) && ifstream ( filename ).good() )
+    {
+        cout << "Unchanged " << filename << endl;
+        return false;
+    }
+
+    ofstream output ( filename );
+    for ( const string &text : texts )
+    {
+        output << text;
+    }
+
+    return true;
+}
@@ -0,0 +1,38 @@
+/*
+*  C++ Implementation: dot2Vhdl
+*
+* Description:
+*
+*
+* Author: Andrea Guerrieri <andrea.guerrieri@epfl.ch (C) 2019
+*
+* Copyright: See COPYING file that comes with this distribution
+*
+*/
+
+
+#ifndef _MANIFEST_
+#define _MANIFEST_
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The manifest (<top level>_manifest.txt) keeps a hash of the content of each generated file:
+// a file with the same hash as in the previous run is not written again (its timestamp is kept)
+
+void manifest_read ( string top_level_filename, bool force );
+void manifest_write ( void );
+
+string manifest_hash ( const vector<string> &texts, int first = 0 );
+bool manifest_unchanged ( string entry, string hash );
+void manifest_set ( string entry, string hash );
+
+// Files generated by a step (e.g. an LSQ generator), as "<hash> <entry> > <file>" entries
+void manifest_set_outputs ( string entry, string hash, const vector<string> &outputs );
+bool manifest_outputs_exist ( string entry );
+
+bool manifest_write_file ( string filename, const vector<string> &texts, int hashed_from = 0 );
+
+#endif
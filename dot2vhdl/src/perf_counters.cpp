@@ -0,0 +1,318 @@
+/*
+*  C++ Implementation: dot2Vhdl
+*
+* Description:
+*
+*
+* Author: Andrea Guerrieri <andrea.guerrieri@epfl.ch (C) 2019
+*
+* Copyright: See COPYING file that comes with this distribution
+*
+*/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include "dot2vhdl.h"
+#include "dot_parser.h"
+#include "vhdl_writer.h"
+#include "string_utils.h"
+#include "manifest.h"
+#include "perf_counters.h"
+
+using namespace std;
+
+// Section of the netlist written by the current thread (vhdl_writer.cpp)
+extern thread_local ostringstream netlist;
+
+#define PERF_EVENTS 3
+
+static const char *perf_events_name[PERF_EVENTS] = { "transfer", "stall", "idle" };
+
+typedef struct perf_channel
+{
+    int from;       // Node and output of the producer
+    int output;
+    int to;         // Node and input of the consumer
+    int input;
+} PERF_CHANNEL_T;
+
+// Instrumented channels: the counters of channel k are PERF_EVENTS * k + event
+static vector<PERF_CHANNEL_T> perf_channels;
+
+static string perf_channel_name ( const PERF_CHANNEL_T &channel )
+{
+    return nodes[channel.from].name + ":out" + to_string ( channel.output + 1 ) + " -> " +
+           nodes[channel.to].name + ":in" + to_string ( channel.input + 1 );
+}
+
+static vector<PERF_CHANNEL_T> get_channels ( void )
+{
+    vector<PERF_CHANNEL_T> channels;
+
+    for ( int i = 0; i < components_in_netlist; i++ )
+    {
+        for ( int indx = 0; indx < nodes[i].outputs.size; indx++ )
+        {
+            if ( nodes[i].outputs.output[indx].next_nodes_id != COMPONENT_NOT_FOUND )
+            {
+                channels.push_back ( { i, indx, nodes[i].outputs.output[indx].next_nodes_id, nodes[i].outputs.output[indx].next_nodes_port } );
+            }
+        }
+    }
+    return channels;
+}
+
+// Channels of the CFDFCs of the buffer placement (<graph>_throughput.txt, written by buffers):
+// the channels inside a BB of a CFDFC and the ones along its arcs between BBs
+static bool select_cfdfc_channels ( string throughput_filename )
+{
+    ifstream file ( throughput_filename );
+    if ( !file )
+    {
+        cout << "Error: CFDFC file " << throughput_filename << " could not be read" << endl;
+        return false;
+    }
+
+    vector<set<int>> cfdfc_bbs;
+    vector<set<pair<int, int>>> cfdfc_arcs;
+    string line;
+
+    // cfdfc <index> <throughput> <freq> <#BBs> <BB>... <#arcs> <srcBB> <dstBB> ...
+    while ( getline ( file, line ) )
+    {
+        istringstream fields ( line );
+        string keyword, index, throughput, freq;
+        int bb_count, arc_count, bb, src, dst;
+
+        if ( !( fields >> keyword ) || keyword != "cfdfc" || !( fields >> index >> throughput >> freq >> bb_count ) )
+        {
+            continue;
+        }
+
+        cfdfc_bbs.push_back ( set<int>() );
+        cfdfc_arcs.push_back ( set<pair<int, int>>() );
+        for ( int indx = 0; indx < bb_count && fields >> bb; indx++ )
+        {
+            cfdfc_bbs.back().insert ( bb );
+        }
+        fields >> arc_count;
+        for ( int indx = 0; indx < arc_count && fields >> src >> dst; indx++ )
+        {
+            cfdfc_arcs.back().insert ( make_pair ( src, dst ) );
+        }
+    }
+
+    for ( const PERF_CHANNEL_T &channel : get_channels ( ) )
+    {
+        int src_bb = nodes[channel.from].basic_block;
+        int dst_bb = nodes[channel.to].basic_block;
+
+        for ( size_t cfdfc = 0; cfdfc < cfdfc_bbs.size(); cfdfc++ )
+        {
+            if ( cfdfc_bbs[cfdfc].count ( src_bb ) && cfdfc_bbs[cfdfc].count ( dst_bb ) &&
+                 ( src_bb == dst_bb || cfdfc_arcs[cfdfc].count ( make_pair ( src_bb, dst_bb ) ) ) )
+            {
+                perf_channels.push_back ( channel );
+                break;
+            }
+        }
+    }
+
+    cout << "Performance counters on " << perf_channels.size() << " channels of " << cfdfc_bbs.size() << " CFDFCs" << endl;
+    return true;
+}
+
+// Channels listed in a file, one per line: <from>[:outN] -> <to>[:inN] (all the channels between the nodes without ports)
+static bool select_listed_channels ( string channels_filename )
+{
+    ifstream file ( channels_filename );
+    if ( !file )
+    {
+        cout << "Error: channels file " << channels_filename << " could not be read" << endl;
+        return false;
+    }
+
+    vector<PERF_CHANNEL_T> channels = get_channels ( );
+    string line;
+    bool found_all = true;
+
+    while ( getline ( file, line ) )
+    {
+        istringstream fields ( line.substr ( 0, line.find ( '#' ) ) );
+        string from, arrow, to;
+
+        if ( !( fields >> from ) )
+        {
+            continue;
+        }
+        if ( !( fields >> arrow >> to ) || arrow != "->" )
+        {
+            cout << "Error: channel \"" << line << "\" is not <from>[:outN] -> <to>[:inN]" << endl;
+            found_all = false;
+            continue;
+        }
+
+        string from_port = from.find ( ':' ) != string::npos ? from.substr ( from.find ( ':' ) + 1 ) : "";
+        string to_port = to.find ( ':' ) != string::npos ? to.substr ( to.find ( ':' ) + 1 ) : "";
+        from = from.substr ( 0, from.find ( ':' ) );
+        to = to.substr ( 0, to.find ( ':' ) );
+
+        bool found = false;
+        for ( const PERF_CHANNEL_T &channel : channels )
+        {
+            if ( nodes[channel.from].name == from && nodes[channel.to].name == to &&
+                 ( from_port.empty() || from_port == "out" + to_string ( channel.output + 1 ) ) &&
+                 ( to_port.empty() || to_port == "in" + to_string ( channel.input + 1 ) ) )
+            {
+                perf_channels.push_back ( channel );
+                found = true;
+            }
+        }
+        if ( !found )
+        {
+            cout << "Error: channel " << line << " not found in the netlist" << endl;
+            found_all = false;
+        }
+    }
+
+    cout << "Performance counters on " << perf_channels.size() << " channels" << endl;
+    return found_all;
+}
+
+// Selects the channels of the netlist just parsed (the top level), as given by -perf_counters
+bool perf_counters_select ( string filename )
+{
+    perf_channels.clear();
+
+    if ( perf_counters_mode.empty() )
+    {
+        return true;
+    }
+    if ( perf_counters_mode == "all" )
+    {
+        perf_channels = get_channels ( );
+        cout << "Performance counters on all the " << perf_channels.size() << " channels" << endl;
+        return true;
+    }
+    if ( perf_counters_mode == "cfdfc" )
+    {
+        return select_cfdfc_channels ( stripExtension ( filename, "_graph_buf" ) + "_throughput.txt" );
+    }
+    return select_listed_channels ( perf_counters_mode );
+}
+
+static int perf_counters_number ( void )
+{
+    return PERF_EVENTS * perf_channels.size();
+}
+
+static int perf_select_width ( void )
+{
+    int width = 1;
+
+    while ( ( 1 << width ) < perf_counters_number ( ) )
+    {
+        width++;
+    }
+    return width;
+}
+
+// Readout ports of the top-level entity (after its last port)
+void write_perf_counters_ports ( void )
+{
+    if ( perf_channels.empty() )
+    {
+        return;
+    }
+
+    netlist << ";" << '\n';
+    netlist << "\t" << "perf_clear : in std_logic;" << '\n';
+    netlist << "\t" << "perf_select : in std_logic_vector (" << perf_select_width ( ) - 1 << " downto 0);" << '\n';
+    netlist << "\t" << "perf_count : out std_logic_vector (" << perf_counters_width - 1 << " downto 0)";
+}
+
+void write_perf_counters_signals ( void )
+{
+    if ( perf_channels.empty() )
+    {
+        return;
+    }
+
+    netlist << '\n';
+    netlist << "-- Performance counters: transfer, stall and idle cycles of the instrumented channels (counter index in the _perf_counters.json file)" << '\n';
+    netlist << "\t" << "type perf_counters_t is array (0 to " << perf_counters_number ( ) - 1 << ") of unsigned (" << perf_counters_width - 1 << " downto 0);" << '\n';
+    netlist << "\t" << "constant PERF_COUNTER_MAX : unsigned (" << perf_counters_width - 1 << " downto 0) := (others => '1');" << '\n';
+    netlist << "\t" << "signal perf_counters : perf_counters_t;" << '\n';
+    netlist << "\t" << "signal perf_events : std_logic_vector (" << perf_counters_number ( ) - 1 << " downto 0);" << '\n';
+}
+
+// The events of a channel are read at its consumer: valid (pValidArray) and ready (readyArray)
+void write_perf_counters ( void )
+{
+    if ( perf_channels.empty() )
+    {
+        return;
+    }
+
+    netlist << '\n';
+    for ( size_t indx = 0; indx < perf_channels.size(); indx++ )
+    {
+        const PERF_CHANNEL_T &channel = perf_channels[indx];
+        string valid = nodes[channel.to].name + UNDERSCORE + PVALID_ARRAY + UNDERSCORE + to_string ( channel.input );
+        string ready = nodes[channel.to].name + UNDERSCORE + READY_ARRAY + UNDERSCORE + to_string ( channel.input );
+
+        netlist << "\t" << "perf_events(" << PERF_EVENTS * indx << ") <= " << valid << " and " << ready << SEMICOLOUMN << '\n';
+        netlist << "\t" << "perf_events(" << PERF_EVENTS * indx + 1 << ") <= " << valid << " and not " << ready << SEMICOLOUMN << '\n';
+        netlist << "\t" << "perf_events(" << PERF_EVENTS * indx + 2 << ") <= not " << valid << SEMICOLOUMN << '\n';
+    }
+
+    netlist << '\n';
+    netlist << "\t" << "perf_counters_process : process (clk)" << '\n';
+    netlist << "\t" << "begin" << '\n';
+    netlist << "\t\t" << "if rising_edge (clk) then" << '\n';
+    netlist << "\t\t\t" << "if rst = '1' or perf_clear = '1' then" << '\n';
+    netlist << "\t\t\t\t" << "perf_counters <= (others => (others => '0'));" << '\n';
+    netlist << "\t\t\t" << "else" << '\n';
+    netlist << "\t\t\t\t" << "for indx in 0 to " << perf_counters_number ( ) - 1 << " loop" << '\n';
+    netlist << "\t\t\t\t\t" << "if perf_events(indx) = '1' and perf_counters(indx) /= PERF_COUNTER_MAX then" << '\n';
+    netlist << "\t\t\t\t\t\t" << "perf_counters(indx) <= perf_counters(indx) + 1;" << '\n';
+    netlist << "\t\t\t\t\t" << "end if;" << '\n';
+    netlist << "\t\t\t\t" << "end loop;" << '\n';
+    netlist << "\t\t\t" << "end if;" << '\n';
+    netlist << "\t\t" << "end if;" << '\n';
+    netlist << "\t" << "end process;" << '\n';
+    netlist << '\n';
+    netlist << "\t" << "perf_count <= std_logic_vector (perf_counters (to_integer (unsigned (perf_select)))) when to_integer (unsigned (perf_select)) < "
+            << perf_counters_number ( ) << " else (others => '0');" << '\n';
+}
+
+// <filename>_perf_counters.json: the channel and event of each counter index
+void write_perf_counters_map ( string filename )
+{
+    if ( perf_channels.empty() )
+    {
+        return;
+    }
+
+    ostringstream map;
+
+    map << "{" << '\n';
+    map << "    \"width\": " << perf_counters_width << "," << '\n';
+    map << "    \"counters\": [" << '\n';
+    for ( size_t indx = 0; indx < perf_channels.size(); indx++ )
+    {
+        for ( int event = 0; event < PERF_EVENTS; event++ )
+        {
+            map << "        { \"index\": " << PERF_EVENTS * indx + event << ", \"channel\": \"" << perf_channel_name ( perf_channels[indx] )
+                << "\", \"event\": \"" << perf_events_name[event] << "\" }";
+            map << ( indx == perf_channels.size() - 1 && event == PERF_EVENTS - 1 ? "" : "," ) << '\n';
+        }
+    }
+    map << "    ]" << '\n';
+    map << "}" << '\n';
+
+    manifest_write_file ( filename + "_perf_counters.json", { map.str() } );
+}
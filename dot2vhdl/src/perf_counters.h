@@ -0,0 +1,34 @@
+/*
+*  C++ Implementation: dot2Vhdl
+*
+* Description:
+*
+*
+* Author: Andrea Guerrieri <andrea.guerrieri@epfl.ch (C) 2019
+*
+* Copyright: See COPYING file that comes with this distribution
+*
+*/
+
+
+#ifndef _PERF_COUNTERS_
+#define _PERF_COUNTERS_
+
+#include <string>
+
+using namespace std;
+
+// Handshake performance counters of the top-level netlist (-perf_counters=all|cfdfc|<file>).
+// Each instrumented channel has 3 saturating counters: transfer (valid and ready),
+// stall (valid and not ready) and idle (not valid) cycles, read through perf_select/perf_count.
+
+#define PERF_COUNTERS_WIDTH_DEFAULT 32
+
+bool perf_counters_select ( string filename );
+
+void write_perf_counters_ports ( void );
+void write_perf_counters_signals ( void );
+void write_perf_counters ( void );
+void write_perf_counters_map ( string filename );
+
+#endif
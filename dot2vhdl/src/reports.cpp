@@ -13,13 +13,17 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <map>
+#include <algorithm>
 #include "stdlib.h"
 #include <string.h>
+#include <stdio.h>
 #include "dot2vhdl.h"
 #include "dot_parser.h"
 #include "vhdl_writer.h"
 #include "eda_if.h"
 #include "lsq_generator.h"
+#include "string_utils.h"
 
 
 using namespace std;
@@ -77,29 +81,364 @@ void report_instances ( void )
 }
 
 
-void report_area ( void )
+// Area estimation from the characterization tables of the target (data/targets/<target>_area.dat).
+// Each row has the LUT, FF and DSP of a component for the data widths 1, 2, 4, 8, 16, 32 and 64
+// (7 columns each). The first rows are the operators, in the order of the delay and latency tables;
+// the components scaled by a count have the area of one unit (input, output, slot, port, entry).
+
+enum
 {
+    AREA_ICMP,
+    AREA_ADD,
+    AREA_SUB,
+    AREA_MUL,
+    AREA_SEXT,
+    AREA_LOAD,
+    AREA_STORE,
+    AREA_LSQ_LOAD,
+    AREA_LSQ_STORE,
+    AREA_MERGE,         // Per input
+    AREA_GETPTR,
+    AREA_FADD,
+    AREA_FSUB,
+    AREA_FMUL,
+    AREA_UDIV,
+    AREA_SDIV,
+    AREA_FDIV,
+    AREA_FCMP,
+    AREA_CTRLMERGE,     // Per input
+    AREA_ZDC,
+    AREA_FORK,          // Per output
+    AREA_BRANCH,
+    AREA_MUX,           // Per data input
+    AREA_OEHB,
+    AREA_TEHB,
+    AREA_FIFO,          // Per slot
+    AREA_CONSTANT,
+    AREA_CONTROL,       // Entry, Exit, Source, Sink and the other components
+    AREA_MC,            // Per load or store port
+    AREA_LSQ,           // Per entry of the load and store queues
+    AREA_ROWS
+};
 
-    cout << "Report Estimated Area \n\r";
+// Operators of the first rows, as named in the timing tables
+static const string area_operators[] = {
+    "icmp", "add", "sub", "mul", "sext", "load", "store", "lsq_load", "lsq_store", "phi",
+    "getelementptr", "fadd", "fsub", "fmul", "udiv", "sdiv", "fdiv", "fcmp", "phiC", "zdc"
+};
+
+#define AREA_WIDTHS     7
+#define AREA_RESOURCES  3   // LUT, FF, DSP
+
+typedef struct area
+{
+    float lut = 0;
+    float ff = 0;
+    float dsp = 0;
+    float delay = 0;
+    int count = 0;
+} AREA_T;
+
+static vector<vector<float>> area_table;
+static vector<vector<float>> delay_table;
+
+// Rows of data/targets/<target>_<data_type>.dat, or of default_<data_type>.dat if not characterized
+// (the default tables are device-independent, and fallback tells whether they are used)
+static bool read_target_table ( string data_type, vector<vector<float>> &table, bool &fallback )
+{
+    const char *install_dir = getenv ( "DHLS_INSTALL_DIR" );
+    string targets_dir = install_dir ? string ( install_dir ) + "/etc/dynamatic/data/targets/" : "";
+    string filename = targets_dir + target_name + "_" + data_type + ".dat";
+
+    ifstream file ( filename );
+    fallback = false;
+    if ( !file && target_name != "default" )
+    {
+        cout << "Target " << target_name << " has no " << data_type << " table: the device-independent default_" << data_type << ".dat is used" << endl;
+        filename = targets_dir + "default_" + data_type + ".dat";
+        file.open ( filename );
+        fallback = true;
+    }
+    if ( !file )
+    {
+        cout << "Error opening " << filename << ": the " << data_type << " table of target default is missing" << endl;
+        return false;
+    }
+
+    string line;
+    vector<string> values;
+
+    table.clear();
+    while ( getline ( file, line ) )
+    {
+        values.clear();
+        string_split ( line, ',', values );
+        table.push_back ( vector<float>() );
+        for ( const string &value : values )
+        {
+            table.back().push_back ( strtof ( value.c_str(), NULL ) );
+        }
+    }
+    return true;
+}
+
+// Value of the resource for the width, interpolated between the characterized widths
+static float table_value ( const vector<vector<float>> &table, int row, int resource, int width )
+{
+    if ( row >= ( int ) table.size() || ( int ) table[row].size() < ( resource + 1 ) * AREA_WIDTHS )
+    {
+        return 0;
+    }
+
+    const float *values = &table[row][resource * AREA_WIDTHS];
+
+    if ( width <= 1 )
+    {
+        return values[0];
+    }
+    if ( width >= 64 )
+    {
+        return values[AREA_WIDTHS - 1] * width / 64;
+    }
+
+    int column = 0;
+    while ( ( 2 << column ) < width )
+    {
+        column++;
+    }
+    int low = 1 << column;
+    return values[column] + ( values[column + 1] - values[column] ) * ( width - low ) / low;
+}
+
+static int area_operator_row ( string component_operator )
+{
+    string op = component_operator.substr ( 0, component_operator.rfind ( "_op" ) );
+
+    if ( op.compare ( 0, 4, "icmp" ) == 0 ) return AREA_ICMP;
+    if ( op.compare ( 0, 4, "fcmp" ) == 0 ) return AREA_FCMP;
+    if ( op == "mc_load" ) return AREA_LOAD;
+    if ( op == "mc_store" ) return AREA_STORE;
+
+    for ( int row = 0; row <= AREA_ZDC; row++ )
+    {
+        if ( op == area_operators[row] )
+        {
+            return row;
+        }
+    }
+
+    // Logic and shifts: about a LUT per bit, as an adder; extensions and returns are wires
+    if ( op == "and" || op == "or" || op == "xor" || op == "shl" || op == "lshr" || op == "ashr" || op == "select" )
+    {
+        return AREA_ADD;
+    }
+    return AREA_SEXT;
+}
+
+static int component_width ( const NODE_T &node )
+{
+    int width = 0;
+
+    for ( int indx = 0; indx < node.inputs.size; indx++ )
+    {
+        width = max ( width, node.inputs.input[indx].bit_size );
+    }
+    for ( int indx = 0; indx < node.outputs.size; indx++ )
+    {
+        width = max ( width, node.outputs.output[indx].bit_size );
+    }
+    return width;
+}
+
+static void add_area ( AREA_T &area, int row, int width, int units = 1 )
+{
+    area.lut += units * table_value ( area_table, row, 0, width );
+    area.ff += units * table_value ( area_table, row, 1, width );
+    area.dsp += units * table_value ( area_table, row, 2, width );
+    if ( row <= AREA_ZDC )
+    {
+        area.delay = max ( area.delay, table_value ( delay_table, row, 0, width ) );
+    }
+}
+
+static AREA_T component_area ( const NODE_T &node )
+{
+    AREA_T area;
+    int width = component_width ( node );
+
+    if ( node.type == "Operator" )
+    {
+        add_area ( area, area_operator_row ( node.component_operator ), width );
+    }
+    else if ( node.type == "Fork" || node.type == "LazyFork" )
+    {
+        add_area ( area, AREA_FORK, width, node.outputs.size );
+    }
+    else if ( node.type == "Branch" )
+    {
+        add_area ( area, AREA_BRANCH, width );
+    }
+    else if ( node.type == "Merge" )
+    {
+        add_area ( area, AREA_MERGE, width, node.inputs.size );
+    }
+    else if ( node.type == "CntrlMerge" )
+    {
+        add_area ( area, AREA_CTRLMERGE, width, node.inputs.size );
+    }
+    else if ( node.type == "Mux" )
+    {
+        add_area ( area, AREA_MUX, node.outputs.output[0].bit_size, max ( node.inputs.size - 1, 1 ) );
+    }
+    else if ( node.type == "Buffer" || node.type == "OEHB" )
+    {
+        // 2 slots: elastic buffer (OEHB and TEHB)
+        add_area ( area, AREA_OEHB, width );
+        if ( node.slots == 2 )
+        {
+            add_area ( area, AREA_TEHB, width );
+        }
+    }
+    else if ( node.type == "TEHB" )
+    {
+        add_area ( area, AREA_TEHB, width );
+    }
+    else if ( node.type == "Fifo" || node.type == "nFifo" || node.type == "tFifo" )
+    {
+        add_area ( area, AREA_FIFO, width, max ( node.slots, 1 ) );
+    }
+    else if ( node.type == "Constant" )
+    {
+        add_area ( area, AREA_CONSTANT, width );
+    }
+    else if ( node.type == "MC" )
+    {
+        add_area ( area, AREA_MC, node.data_size, max ( node.load_count, 0 ) + max ( node.store_count, 0 ) );
+    }
+    else if ( node.type == "LSQ" )
+    {
+        add_area ( area, AREA_LSQ, node.data_size, 2 * get_lsq_fifo_depth ( node.lsq_indx ) );
+    }
+    else
+    {
+        add_area ( area, AREA_CONTROL, width );
+    }
+
+    area.count = 1;
+    return area;
+}
+
+// The table printer has no floating point output
+static string format_delay ( float delay )
+{
+    char text[16];
+    snprintf ( text, sizeof ( text ), "%.3f", delay );
+    return text;
+}
+
+static void accumulate_area ( AREA_T &total, const AREA_T &area )
+{
+    total.lut += area.lut;
+    total.ff += area.ff;
+    total.dsp += area.dsp;
+    total.delay = max ( total.delay, area.delay );
+    total.count += area.count;
+}
+
+bool report_area ( void )
+{
+    bool area_fallback, delay_fallback;
+    if ( !read_target_table ( "area", area_table, area_fallback ) || !read_target_table ( "delay", delay_table, delay_fallback ) )
+    {
+        return false;
+    }
+
+    cout << endl << "Report Estimated Area (target " << target_name;
+    if ( area_fallback || target_name == "default" )
+    {
+        cout << ", device-independent estimate";
+    }
+    cout << ")" << endl;
+
+    // Operator name for the operators, else the component type
+    map<string, AREA_T> area_by_type;
+    map<int, AREA_T> area_by_bb;
+    AREA_T total_area;
 
-    int total_area = 0;
-    
     TablePrinter tp(&std::cout);
     tp.AddColumn("Node_ID", 8);
     tp.AddColumn("Name", 18);
     tp.AddColumn("Module_type", 20);
-    tp.AddColumn("Area", 10);
+    tp.AddColumn("LUT", 10);
+    tp.AddColumn("FF", 10);
+    tp.AddColumn("DSP", 6);
 
-    tp.PrintHeader();
+    if ( debug_mode )
+    {
+        tp.PrintHeader();
+    }
 
     for (int i = 0; i < components_in_netlist; i++) 
     {
-        tp << i << nodes[i].name << nodes[i].type << 123;
-        total_area+=123;
+        AREA_T area = component_area ( nodes[i] );
+
+        accumulate_area ( area_by_type[nodes[i].type == "Operator" ? nodes[i].component_operator : nodes[i].type], area );
+        accumulate_area ( area_by_bb[nodes[i].basic_block], area );
+        accumulate_area ( total_area, area );
+
+        if ( debug_mode )
+        {
+            tp << i << nodes[i].name << nodes[i].type << (int) area.lut << (int) area.ff << (int) area.dsp;
+        }
     }
-    tp.PrintFooter();
-    tp << "" << "" << "Total"  << total_area;
-    tp.PrintFooter();
+    if ( debug_mode )
+    {
+        tp.PrintFooter();
+    }
+
+    TablePrinter tp_type(&std::cout);
+    tp_type.AddColumn("Module_type", 20);
+    tp_type.AddColumn("Count", 8);
+    tp_type.AddColumn("LUT", 10);
+    tp_type.AddColumn("FF", 10);
+    tp_type.AddColumn("DSP", 6);
+    tp_type.AddColumn("Delay_ns", 10);
+
+    tp_type.PrintHeader();
+    for ( auto &type : area_by_type )
+    {
+        tp_type << type.first << type.second.count << (int) type.second.lut << (int) type.second.ff << (int) type.second.dsp << format_delay ( type.second.delay );
+    }
+    tp_type.PrintFooter();
+    tp_type << "Total" << total_area.count << (int) total_area.lut << (int) total_area.ff << (int) total_area.dsp << format_delay ( total_area.delay );
+    tp_type.PrintFooter();
+
+    TablePrinter tp_bb(&std::cout);
+    tp_bb.AddColumn("BB", 8);
+    tp_bb.AddColumn("Count", 8);
+    tp_bb.AddColumn("LUT", 10);
+    tp_bb.AddColumn("FF", 10);
+    tp_bb.AddColumn("DSP", 6);
+
+    tp_bb.PrintHeader();
+    for ( auto &bb : area_by_bb )
+    {
+        if ( bb.first < 0 )
+        {
+            tp_bb << "none" << bb.second.count << (int) bb.second.lut << (int) bb.second.ff << (int) bb.second.dsp;
+        }
+        else
+        {
+            tp_bb << bb.first << bb.second.count << (int) bb.second.lut << (int) bb.second.ff << (int) bb.second.dsp;
+        }
+    }
+    tp_bb.PrintFooter();
+
+    // The slowest operator bounds the clock period from below (without the routing and the handshake)
+    cout << "Estimated LUT " << (int) total_area.lut << ", FF " << (int) total_area.ff << ", DSP " << (int) total_area.dsp;
+    cout << ", slowest operator " << format_delay ( total_area.delay ) << " ns" << endl;
+
+    return true;
 }
 
 
@@ -16,7 +16,7 @@
 
 
 void report_instances ( void );
-void report_area ( void );
+bool report_area ( void );
 void print_netlist ( void );
 
 
@@ -17,6 +17,7 @@
 #include <list>
 #include <cctype>
 #include <stdexcept>
+#include <cstring>
 
 #include "dot_parser.h"
 #include "vhdl_writer.h"
@@ -42,6 +43,62 @@ void string_split(const string& s, char c, vector<string>& v)
    }
 }
 
+// Same fields as above, as views into s (v is cleared first, to be reused without allocations)
+void string_split ( string_view s, char c, vector<string_view>& v )
+{
+    v.clear();
+
+    string_view::size_type i = 0;
+    string_view::size_type j = s.find( c );
+
+    while ( j != string_view::npos )
+    {
+        v.push_back( s.substr( i, j - i ) );
+        i = ++j;
+        j = s.find( c, j );
+
+        if ( j == string_view::npos )
+            v.push_back( s.substr( i ) );
+    }
+}
+
+// Second field of s split at c (v[1] of string_split), empty if c does not occur
+string_view string_field ( string_view s, char c )
+{
+    string_view::size_type i = s.find( c );
+    if ( i == string_view::npos )
+    {
+        return string_view();
+    }
+    s.remove_prefix( i + 1 );
+    return s.substr( 0, s.find( c ) );
+}
+
+// s without the characters in chars: a view into s if they only occur at the ends, else a copy in buffer
+string_view string_strip ( string_view s, const char *chars, string &buffer )
+{
+    string_view::size_type first = s.find_first_not_of( chars );
+    if ( first == string_view::npos )
+    {
+        return string_view();
+    }
+    s = s.substr( first, s.find_last_not_of( chars ) - first + 1 );
+    if ( s.find_first_of( chars ) == string_view::npos )
+    {
+        return s;
+    }
+
+    buffer.clear();
+    for ( char ch : s )
+    {
+        if ( !strchr( chars, ch ) )
+        {
+            buffer += ch;
+        }
+    }
+    return buffer;
+}
+
 string string_remove_blank ( string string_input )
 {
     string_input.erase( remove( string_input.begin(), string_input.end(), ' ' ), string_input.end() );
@@ -16,10 +16,15 @@
 
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 using namespace std;
 
 void string_split(const string& s, char c, vector<string>& v);
+void string_split ( string_view s, char c, vector<string_view>& v );
+string_view string_field ( string_view s, char c );
+string_view string_strip ( string_view s, const char *chars, string &buffer );
 string string_remove_blank ( string string_input );
 string string_clean ( string string_input );
 int stoi_p ( string str );
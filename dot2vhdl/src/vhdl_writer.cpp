@@ -19,6 +19,11 @@
 #include <list>
 #include <cctype>
 #include <math.h>
+#include <atomic>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #include <cassert>
 
@@ -27,6 +32,8 @@
 #include "vhdl_writer.h"
 #include "string_utils.h"
 #include "lsq_generator.h"
+#include "manifest.h"
+#include "perf_counters.h"
 
 
 string entity_name[] = {
@@ -161,7 +168,8 @@ typedef struct component
 COMPONENT_T components_type[MAX_COMPONENTS];
 
 
-ofstream netlist;
+// Section of the netlist written by the current thread (see write_sections)
+thread_local ostringstream netlist;
 ofstream tb_wrapper;
 
 
@@ -190,9 +198,9 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
         }
         else
         {
-                netlist << endl;
-                netlist << "\t" << SIGNAL_STRING<< nodes[i].name << "_clk : std_logic;"<< endl;
-                netlist << "\t" << SIGNAL_STRING<< nodes[i].name << "_rst : std_logic;" << endl;
+                netlist << '\n';
+                netlist << "\t" << SIGNAL_STRING<< nodes[i].name << "_clk : std_logic;"<< '\n';
+                netlist << "\t" << SIGNAL_STRING<< nodes[i].name << "_rst : std_logic;" << '\n';
                 
                 for ( indx = 0; indx < nodes[i].inputs.size; indx++ )
                 {
@@ -735,21 +743,21 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
 
                     if(nodes[i].component_operator.find("mc_load_op")!= std::string::npos) {
                         netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tagIn" << UNDERSCORE << to_string(0) <<
-                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;
+                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';
 
                         netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tagOut" << UNDERSCORE << to_string(0) <<
-                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;
+                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';
 
                     } else if(nodes[i].component_operator.find("mc_store_op")!= std::string::npos) {
                         netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tagIn" << UNDERSCORE << to_string(0) <<
-                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;
+                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';
                         netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tagIn" << UNDERSCORE << to_string(1) <<
-                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;
+                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';
                     } else {
                         // loop over all inputs and print a tagIn signal for each one
                         for (indx = 0; indx < nodes[i].inputs.size; indx++) { 
                             netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tagIn" << UNDERSCORE << to_string(indx) <<
-                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;
+                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';
                         }  
                     } 
 
@@ -757,7 +765,7 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
                     if(nodes[i].component_operator.find("mc_store_op") == std::string::npos && nodes[i].component_operator.find("mc_load_op") == std::string::npos) {
                         for (indx = 0; indx < nodes[i].outputs.size; indx++) { 
                             netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tagOut" << UNDERSCORE << to_string(indx) <<
-                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;  
+                                    ": std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';  
                         } 
                     }
                 }                              
@@ -816,7 +824,7 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
             signal += "io_queueEmpty";
             signal += COLOUMN;
             signal += STD_LOGIC ;
-            netlist << "\t" << signal << endl;
+            netlist << "\t" << signal << '\n';
         }
         
         if ( nodes[i].type == "MC" || nodes[i].type == "LSQ" )
@@ -827,7 +835,7 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
             signal += "we0_ce0";
             signal += COLOUMN;
             signal += STD_LOGIC ;
-            netlist << "\t" << signal << endl;
+            netlist << "\t" << signal << '\n';
             
         }
         
@@ -835,20 +843,20 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
         if ( nodes[i].type.find("LSQ") != std::string::npos )
         {
 
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_address0 : std_logic_vector (" << (nodes[i].address_size -1 ) << " downto 0);" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_ce0 : std_logic;" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_we0 : std_logic;" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_dout0 : std_logic_vector (31 downto 0);" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_din0 : std_logic_vector (31 downto 0);" << endl;
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_address0 : std_logic_vector (" << (nodes[i].address_size -1 ) << " downto 0);" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_ce0 : std_logic;" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_we0 : std_logic;" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_dout0 : std_logic_vector (31 downto 0);" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_din0 : std_logic_vector (31 downto 0);" << '\n';
             
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_address1 : std_logic_vector (" << (nodes[i].address_size - 1)  << " downto 0);" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_ce1 : std_logic;" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_we1 : std_logic;" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_dout1 : std_logic_vector (31 downto 0);" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_din1 : std_logic_vector (31 downto 0);" << endl;
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_address1 : std_logic_vector (" << (nodes[i].address_size - 1)  << " downto 0);" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_ce1 : std_logic;" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_we1 : std_logic;" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_dout1 : std_logic_vector (31 downto 0);" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_din1 : std_logic_vector (31 downto 0);" << '\n';
             
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_load_ready : std_logic;" << endl;
-            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_store_ready : std_logic;" << endl;
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_load_ready : std_logic;" << '\n';
+            netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_store_ready : std_logic;" << '\n';
 
             
         }
@@ -878,9 +886,9 @@ void write_signals ( bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_
                 }
 
 
-                netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tag_order_data : std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << endl;
-                netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tag_order_valid : std_logic;" << endl;
-                netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tag_order_nReady : std_logic;" << endl;
+                netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tag_order_data : std_logic_vector ("  << to_string(tag_bit_size) << " downto 0);" << '\n';
+                netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tag_order_valid : std_logic;" << '\n';
+                netlist << "\t" << SIGNAL_STRING << nodes[i].name << "_tag_order_nReady : std_logic;" << '\n';
             }
         }
 
@@ -912,7 +920,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
 {
     string signal_1, signal_2;
 
-    netlist << endl;
+    netlist << '\n';
 
     //netlist << "\t" << "ap_ready <= '1';" << endl;
 
@@ -925,20 +933,20 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
     {
         for (int i = 0; i < components_in_netlist; i++ ) 
         {
-            netlist << endl;
+            netlist << '\n';
 
 
             // AYA: 07/08/2023: commented the following to connect it to th ROB instead of hardcoding to 1
              // AYA: 03/08/2023
             if(tagged_loop_mux_flag) {
                 if (nodes[i].component_operator.find("LoopMux") != std::string::npos) {
-                    netlist << "\t" << nodes[i].name  << "_tag_order_nReady" << " <= " << "'1'" <<  SEMICOLOUMN << endl;
+                    netlist << "\t" << nodes[i].name  << "_tag_order_nReady" << " <= " << "'1'" <<  SEMICOLOUMN << '\n';
                 }
             }
 
             
-            netlist << "\t" << nodes[i].name << UNDERSCORE  << "clk" << " <= " << "clk" <<  SEMICOLOUMN << endl;
-            netlist << "\t" << nodes[i].name << UNDERSCORE  << "rst" << " <= " << "rst" <<  SEMICOLOUMN << endl;
+            netlist << "\t" << nodes[i].name << UNDERSCORE  << "clk" << " <= " << "clk" <<  SEMICOLOUMN << '\n';
+            netlist << "\t" << nodes[i].name << UNDERSCORE  << "rst" << " <= " << "rst" <<  SEMICOLOUMN << '\n';
             
             
             
@@ -952,7 +960,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 +="we0_ce0";
                     
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;                
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';                
 
                     signal_1 = nodes[i].memory;
                     signal_1 += UNDERSCORE;
@@ -963,7 +971,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 +="we0_ce0";
                     
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;                
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';                
             }
 
                     //LSQ-MC Modifications
@@ -993,7 +1001,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += to_string( indx );
                     
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
                         
                         signal_1 = nodes[i].name;
                         signal_1 += UNDERSCORE;
@@ -1004,7 +1012,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                 
                         signal_2 = "'1'";
                         
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
                         
                         
  
@@ -1024,7 +1032,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 += "din1";
 
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';  
 
                     signal_1 = nodes[i].name;
                     signal_1 += UNDERSCORE;
@@ -1032,7 +1040,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
 
                     signal_2 = "'1'";
 
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl; 
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n'; 
 
                     signal_1 = nodes[i].name;
                     signal_1 += UNDERSCORE;
@@ -1040,7 +1048,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
 
                     signal_2 = "'1'";
 
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl; 
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n'; 
                 }  
 
                 for ( int indx = 0; indx < nodes[i].outputs.size; indx++ )
@@ -1064,7 +1072,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += to_string( indx );
                     
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
                         
                         signal_1 = nodes[i].name;
                         signal_1 += UNDERSCORE;
@@ -1077,7 +1085,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += "address1";
 
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
                         
                         signal_1 = nodes[i].name;
                         signal_1 += UNDERSCORE;
@@ -1090,7 +1098,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += "ce1";
 
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
                         
  
                     }else
@@ -1115,7 +1123,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += UNDERSCORE;
                             signal_2 += "we0_ce0";
 
-                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
 
                             signal_1 = nodes[i].name;
                             signal_1 += UNDERSCORE;
@@ -1128,7 +1136,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += UNDERSCORE;
                             signal_2 += to_string( indx );
 
-                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
 
                             
                             signal_1 = nodes[i].name;
@@ -1143,7 +1151,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += "address0";
 
 
-                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
 
                             
                         }
@@ -1165,7 +1173,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += UNDERSCORE;
                             signal_2 += "we0_ce0";
 
-                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
 
                             signal_1 = nodes[i].name;
                             signal_1 += UNDERSCORE;
@@ -1178,7 +1186,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += UNDERSCORE;
                             signal_2 += "dout0";
                             
-                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;     
+                            netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';     
 
                             
                         }
@@ -1203,7 +1211,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     
                     //netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
                     
-                    netlist << "\t" << signal_1 << " <= std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
+                    netlist << "\t" << signal_1 << " <= std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
 
 
                     signal_1 = nodes[i].memory;
@@ -1214,7 +1222,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 += "ce1";
                     
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';  
 
                     signal_1 = nodes[i].memory;
                     signal_1 += UNDERSCORE;
@@ -1225,7 +1233,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += "address0";
 
                     //netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
-                    netlist << "\t" << signal_1 << " <= std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
+                    netlist << "\t" << signal_1 << " <= std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
 
 
                     signal_1 = nodes[i].memory;
@@ -1236,7 +1244,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 += "we0_ce0";
 
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';  
 
                     signal_1 = nodes[i].memory;
                     signal_1 += UNDERSCORE;
@@ -1246,7 +1254,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 += "we0_ce0";
 
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';  
 
                     signal_1 = nodes[i].memory;
                     signal_1 += UNDERSCORE;
@@ -1256,7 +1264,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 += "dout0";
 
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;  
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';  
                 }      
         }
 
@@ -1277,7 +1285,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 +="din";
                     
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;                
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';                
                 }
                 
                 signal_1 = nodes[i].name;
@@ -1300,7 +1308,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 = "start_valid";
                 }
 
-                netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;
+                netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';
 
                 
                 if ( ( nodes[i].name.find("start") != std::string::npos ) )
@@ -1320,7 +1328,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
 
                     signal_2 = "start_ready";
 
-                    netlist << "\t"  << signal_2  << " <= " << signal_1 << SEMICOLOUMN << endl;
+                    netlist << "\t"  << signal_2  << " <= " << signal_1 << SEMICOLOUMN << '\n';
                 }
 
                 //ready for arg
@@ -1335,7 +1343,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 +="ready_out";
 
-                    netlist << "\t"  << signal_2  << " <= " << signal_1 << SEMICOLOUMN << endl;
+                    netlist << "\t"  << signal_2  << " <= " << signal_1 << SEMICOLOUMN << '\n';
                 }
                 
                 
@@ -1352,7 +1360,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                 signal_2 += VALID_ARRAY;
                 
             
-                netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << endl;
+                netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << '\n';
 
                 signal_1 = "end_out"; 
 
@@ -1361,7 +1369,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                 signal_2 += DATAOUT_ARRAY;
                 
             
-                netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << endl;
+                netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << '\n';
                 
   
                 signal_1 = nodes[i].name;
@@ -1372,7 +1380,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
             
                 signal_2 = "end_ready"; 
 
-                netlist << "\t"  << signal_1 << " <= " << signal_2 <<SEMICOLOUMN << endl;
+                netlist << "\t"  << signal_1 << " <= " << signal_2 <<SEMICOLOUMN << '\n';
   
                 
             }
@@ -1412,7 +1420,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         }
                         
                     
-                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << '\n';
 
                     }
                     
@@ -1450,7 +1458,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
 
                         }
                         //outFile << "\t"  << signal_1 << nodes[i].outputs.output[indx].next_nodes_port << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << endl;
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';
 
                         
                     }
@@ -1502,7 +1510,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             //signal_2 += to_string(indx);
                         
                             
-                            netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
+                            netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
 
                         } else {
 
@@ -1613,7 +1621,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                                 signal_2 = "\"";
                                 signal_2 += string_constant ( nodes[nodes[i].outputs.output[indx].next_nodes_id].component_value , nodes[nodes[i].outputs.output[indx].next_nodes_id].outputs.output[0].bit_size );  // Aya: 25: it used to be inputs.input but the input should be 0 bits because the constant is triggered from control
                                 signal_2 += "\"";                        
-                                netlist << "\t" << signal_1  << " <= " << signal_2 <<SEMICOLOUMN << endl;
+                                netlist << "\t" << signal_1  << " <= " << signal_2 <<SEMICOLOUMN << '\n';
                             }
                             else
                             {
@@ -1626,8 +1634,8 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                                     signal_2_extra_tag += UNDERSCORE;
                                     signal_2_extra_tag += to_string( indx );
 
-                                    netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
-                                    netlist << "\t" << signal_1_extra_tag << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2_extra_tag << ")," << signal_1_extra_tag << "'length))"<<SEMICOLOUMN << endl;
+                                    netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
+                                    netlist << "\t" << signal_1_extra_tag << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2_extra_tag << ")," << signal_1_extra_tag << "'length))"<<SEMICOLOUMN << '\n';
 
                                 } else {
                                     // AYA: 18/09/2023
@@ -1638,8 +1646,8 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                                         signal_2_extra_tag += UNDERSCORE;
                                         signal_2_extra_tag += to_string( indx );
 
-                                        netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
-                                        netlist << "\t" << signal_1_extra_tag << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2_extra_tag << ")," << signal_1_extra_tag << "'length))"<<SEMICOLOUMN << endl;
+                                        netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
+                                        netlist << "\t" << signal_1_extra_tag << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2_extra_tag << ")," << signal_1_extra_tag << "'length))"<<SEMICOLOUMN << '\n';
 
                                     }
                                     /////////////////////////// AYA: 17/09/2023
@@ -1656,15 +1664,15 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                                         signal_1_extra_tag += UNDERSCORE;
                                         signal_1_extra_tag += to_string( nodes[i].outputs.output[indx].next_nodes_port );
 
-                                        netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
+                                        netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
                                         
                                         if(tagger_is_tagging)
-                                            netlist << "\t" << signal_1_extra_tag << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2_extra_tag << ")," << signal_1_extra_tag << "'length))"<<SEMICOLOUMN << endl;
+                                            netlist << "\t" << signal_1_extra_tag << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2_extra_tag << ")," << signal_1_extra_tag << "'length))"<<SEMICOLOUMN << '\n';
                                     }
                                     ///////////////////////////////////////////////
 
                                     else
-                                        netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << endl;
+                                        netlist << "\t" << signal_1 << " <= " << inverted << "std_logic_vector (resize(unsigned(" << signal_2 << ")," << signal_1 << "'length))"<<SEMICOLOUMN << '\n';
                                 }
                             }
                         }
@@ -1679,10 +1687,10 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
         
         for (int i = 0; i < components_in_netlist; i++ ) 
         {
-            netlist << endl;
+            netlist << '\n';
             
-            netlist << "\t" << nodes[i].name << UNDERSCORE  << "clk" << " <= " << "clk" <<  SEMICOLOUMN << endl;
-            netlist << "\t" << nodes[i].name << UNDERSCORE  << "rst" << " <= " << "rst" <<  SEMICOLOUMN << endl;
+            netlist << "\t" << nodes[i].name << UNDERSCORE  << "clk" << " <= " << "clk" <<  SEMICOLOUMN << '\n';
+            netlist << "\t" << nodes[i].name << UNDERSCORE  << "rst" << " <= " << "rst" <<  SEMICOLOUMN << '\n';
                 
             
             if ( nodes[i].type == "Entry" )
@@ -1702,7 +1710,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     signal_2 += UNDERSCORE;
                     signal_2 +="data";
                     
-                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;                
+                    netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';                
                 }
                 
                 signal_1 = nodes[i].name;
@@ -1714,7 +1722,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
             
                 signal_2 = "ap_start";
 
-                netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;
+                netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';
     
             }
             
@@ -1736,7 +1744,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += ")";
    
                         
-                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << '\n';
                         
                         signal_1 = nodes[i].name;
                         signal_1 += UNDERSCORE;
@@ -1750,7 +1758,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += ")";
    
                         
-                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << '\n';
                                                 
                         signal_2 = READY_ARRAY;
                         signal_2 += "(";
@@ -1764,7 +1772,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_1 += to_string( indx );
 
                         
-                        netlist << "\t"  << signal_2 << " <= " << signal_1 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_2 << " <= " << signal_1 << SEMICOLOUMN << '\n';
                         
                             
                     }
@@ -1788,7 +1796,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += "tag_order_valid";
                         
                             // netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << endl;
-                            netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << endl;
+                            netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << '\n';
 
     //                     }
     //                     
@@ -1821,7 +1829,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             signal_2 += UNDERSCORE;
                             signal_2 += VALID_ARRAY;
                         
-                            netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << endl;
+                            netlist << "\t"  << signal_1 << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << '\n';
 
     //                     }
     //                     
@@ -1846,7 +1854,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                 
                         
                         //outFile << "\t"  << signal_1 << nodes[i].outputs.output[indx].next_nodes_port << " <= " << signal_2 << UNDERSCORE << indx <<SEMICOLOUMN << endl;
-                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_1  << " <= " << signal_2 << SEMICOLOUMN << '\n';
 
                         
                     }                    
@@ -1935,7 +1943,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                             }
                         //}
                         
-                        netlist << "\t" << signal_1  << " <= " << signal_2 <<SEMICOLOUMN << endl;
+                        netlist << "\t" << signal_1  << " <= " << signal_2 <<SEMICOLOUMN << '\n';
                     }
                     else
                     {
@@ -1951,7 +1959,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += to_string(indx);
                         
-                        netlist << "\t" << signal_1 << " <= " << signal_2 <<SEMICOLOUMN << endl;
+                        netlist << "\t" << signal_1 << " <= " << signal_2 <<SEMICOLOUMN << '\n';
 
                         signal_1 = VALID_ARRAY; 
                         signal_1 += "(";
@@ -1964,7 +1972,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += to_string(indx);
                         
-                        netlist << "\t" << signal_1 << " <= " << signal_2 <<SEMICOLOUMN << endl;
+                        netlist << "\t" << signal_1 << " <= " << signal_2 <<SEMICOLOUMN << '\n';
                         
                         
                     }
@@ -1981,7 +1989,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
 
         // assert(nodes[i].is_tagged != -1);
 
-        netlist << endl;
+        netlist << '\n';
         
         if(nodes[i].component_operator.find("mc_store_op") != std::string::npos)
             continue;  // skip ST because I do not tag its output (for now)
@@ -2044,7 +2052,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                         signal_2 += UNDERSCORE;
                         signal_2 += to_string( indx );
 
-                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << endl;
+                        netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << '\n';
                     } 
                 } else { */
                    
@@ -2066,7 +2074,7 @@ void write_connections (  int indx, bool tagged_loop_mux_flag, bool tagger_is_ta
                     // signal_2 += UNDERSCORE;
                     // signal_2 += to_string( indx );
 
-                    netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << endl;
+                    netlist << "\t"  << signal_1 << " <= " << signal_2 << SEMICOLOUMN << '\n';
                 //}
             }
 
@@ -2122,22 +2130,31 @@ int get_memory_inputs ( int node_id )
     return memory_inputs;
 }
 
-string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st_interfaces_flag_yes_extra_ST_output, bool tagged_loop_mux_flag, int max_number_of_nested_taggers )
+// Ports of width 0 are written with 32 bits
+void set_default_port_sizes ( NODE_T &node )
 {
-    string generic;
-
-    if ( nodes[node_id].inputs.input[0].bit_size == 0 )
+    if ( node.inputs.input[0].bit_size == 0 )
     {
-        nodes[node_id].inputs.input[0].bit_size = 32;
+        node.inputs.input[0].bit_size = 32;
     }
     
-    if ( nodes[node_id].outputs.output[0].bit_size == 0)
+    if ( node.outputs.output[0].bit_size == 0)
     {
-        nodes[node_id].outputs.output[0].bit_size = 32;
+        node.outputs.output[0].bit_size = 32;
     }
+}
+
+string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st_interfaces_flag_yes_extra_ST_output, bool tagged_loop_mux_flag, int max_number_of_nested_taggers )
+{
+    string generic;
+
+    // The other sections may be reading the node while the components are written:
+    // the default widths are set in a copy (write_vhdl sets them in the nodes at the end)
+    NODE_T node = nodes[node_id];
+    set_default_port_sizes ( node );
 
     // AYA: 08/08/2023: adding support for the ROB
-    if ( nodes[node_id].type.find("ROB") != std::string::npos ) {
+    if ( node.type.find("ROB") != std::string::npos ) {
         string N;
 
         // Read from the text file
@@ -2149,7 +2166,7 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
 
         generic = to_string(std::stoi(N)); 
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
 
 
@@ -2172,13 +2189,13 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     }
 
     // AYA: 01/10/2023
-    if ( nodes[node_id].type.find("Aligner_Mux") != std::string::npos) 
+    if ( node.type.find("Aligner_Mux") != std::string::npos) 
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+        generic += to_string(node.inputs.input[1].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
 
         string N;
@@ -2211,13 +2228,13 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     }
 
     // AYA: 01/10/2023
-    if ( nodes[node_id].type.find("Aligner_Branch") != std::string::npos) 
+    if ( node.type.find("Aligner_Branch") != std::string::npos) 
     {
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
 
         string N;
@@ -2250,95 +2267,95 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     }
 
     // AYA: 11/1/2025
-    if(nodes[node_id].type.find("Split") != std::string::npos) {
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+    if(node.type.find("Split") != std::string::npos) {
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[1].bit_size);
+        generic += to_string(node.outputs.output[1].bit_size);
     }
 
-    if(nodes[node_id].type.find("Concat") != std::string::npos) {
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+    if(node.type.find("Concat") != std::string::npos) {
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+        generic += to_string(node.inputs.input[1].bit_size);
     }
 
 
     // AYA: 01/10/2023: added the extra and to the condition to skip the Aligner_Branch
-    if ( nodes[node_id].type.find("Branch") != std::string::npos && nodes[node_id].type.find("Aligner") == std::string::npos)
+    if ( node.type.find("Branch") != std::string::npos && node.type.find("Aligner") == std::string::npos)
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }
-    if (nodes[node_id].type.find(COMPONENT_DISTRIBUTOR) != std::string::npos)
+    if (node.type.find(COMPONENT_DISTRIBUTOR) != std::string::npos)
     {
         //INPUTS
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
         //OUTPUTS
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
         //COND_SIZE
-        generic += to_string((int)ceil(log2(nodes[node_id].outputs.size)));
+        generic += to_string((int)ceil(log2(node.outputs.size)));
         generic += COMMA;
         //DATA_SIZE_IN
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
         //DATA_SIZE_OUT
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }
-    if ( nodes[node_id].type.find("Buf") != std::string::npos )
+    if ( node.type.find("Buf") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
     
-    if ( nodes[node_id].type.find("Merge") != std::string::npos )
+    if ( node.type.find("Merge") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
 
-    if ( nodes[node_id].type.find("Fork") != std::string::npos )
+    if ( node.type.find("Fork") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }  
 
     // AYA: 29/04/2023: The following is needed if the specs of the LoopMUX requires synchronizing the in0 of all LoopMuxes inside 1 loop 
-    if ( nodes[node_id].type.find("Synch") != std::string::npos)
+    if ( node.type.find("Synch") != std::string::npos)
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }  
 
-    /* if(nodes[node_id].type.find("Free_Tags_Fifo") != std::string::npos) {
-        generic = to_string(nodes[node_id].inputs.size);
+    /* if(node.type.find("Free_Tags_Fifo") != std::string::npos) {
+        generic = to_string(node.inputs.size);
         generic += COMMA;
 
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
 
         string N;
@@ -2359,18 +2376,18 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     }  */
 
     // AYA: 17/09/2023: added the tagger 
-    if(nodes[node_id].type.find("Tagger") != std::string::npos || nodes[node_id].type.find("Un_Tagger") != std::string::npos) {
-        if(nodes[node_id].type.find("Un_Tagger") != std::string::npos) {
+    if(node.type.find("Tagger") != std::string::npos || node.type.find("Un_Tagger") != std::string::npos) {
+        if(node.type.find("Un_Tagger") != std::string::npos) {
             // AYA: 18/09/2023: subtracted 1 form the inputs because this size should exclude the extra input port that provides the free tag
-            generic = to_string(nodes[node_id].inputs.size);
+            generic = to_string(node.inputs.size);
         } else {
-            generic = to_string(nodes[node_id].inputs.size - 1);
+            generic = to_string(node.inputs.size - 1);
         }
         
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
 
         string N;
         // Read from the text file
@@ -2406,98 +2423,98 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
         // AYA: 27/12/2023
         generic += COMMA;
         if(max_number_of_nested_taggers > 1)   // take the offset only if there are nested taggers
-            generic += to_string(nodes[node_id].component_id);
+            generic += to_string(node.component_id);
         else
             generic += "0";
 
     }
 
-    if ( nodes[node_id].type.find("Constant") != std::string::npos )
+    if ( node.type.find("Constant") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);    // Aya: 25: it used to be inputs.input but the input should be 0 bits because the constant is triggered from control
+        generic += to_string(node.outputs.output[0].bit_size);    // Aya: 25: it used to be inputs.input but the input should be 0 bits because the constant is triggered from control
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
 
-    if ( nodes[node_id].type.find("Operator") != std::string::npos )
+    if ( node.type.find("Operator") != std::string::npos )
     {
         // AYA: 04/07/2023: Added an extra condition to not mix the new input port of the ST operation with datainArray as I want it to be mapped to the new ACK port
-        if(nodes[node_id].component_operator.find("mc_store_op") != std::string::npos && fix_mc_st_interfaces_flag) {
-            generic = to_string(nodes[node_id].inputs.size - 1);
+        if(node.component_operator.find("mc_store_op") != std::string::npos && fix_mc_st_interfaces_flag) {
+            generic = to_string(node.inputs.size - 1);
         } else {
-            generic = to_string(nodes[node_id].inputs.size);
+            generic = to_string(node.inputs.size);
         }
         generic += COMMA;
 
         // AYA: 04/07/2023: Added an extra condition to not mix the new input port of the ST operation
-        if(nodes[node_id].component_operator.find("mc_store_op") != std::string::npos && fix_mc_st_interfaces_flag && fix_mc_st_interfaces_flag_yes_extra_ST_output) {
-            generic += to_string(nodes[node_id].outputs.size - 1);
+        if(node.component_operator.find("mc_store_op") != std::string::npos && fix_mc_st_interfaces_flag && fix_mc_st_interfaces_flag_yes_extra_ST_output) {
+            generic += to_string(node.outputs.size - 1);
         } else {
-            generic += to_string(nodes[node_id].outputs.size);
+            generic += to_string(node.outputs.size);
         }
         generic += COMMA;
 
-        if ( nodes[node_id].component_operator.find("select") != std::string::npos )
+        if ( node.component_operator.find("select") != std::string::npos )
         {
-            generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+            generic += to_string(node.inputs.input[1].bit_size);
         }
     // Lana 9.6.2021 Sizes for memory address ports
-        else if ( nodes[node_id].component_operator.find("mc_load_op") != std::string::npos 
-            || nodes[node_id].component_operator.find("mc_store_op") != std::string::npos 
-            || nodes[node_id].component_operator.find("lsq_load_op") != std::string::npos 
-            || nodes[node_id].component_operator.find("lsq_store_op") != std::string::npos )
+        else if ( node.component_operator.find("mc_load_op") != std::string::npos 
+            || node.component_operator.find("mc_store_op") != std::string::npos 
+            || node.component_operator.find("lsq_load_op") != std::string::npos 
+            || node.component_operator.find("lsq_store_op") != std::string::npos )
         {
-            generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+            generic += to_string(node.inputs.input[1].bit_size);
         }
         else
         {
-            generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+            generic += to_string(node.inputs.input[0].bit_size);
         }
         
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
-//         if ( nodes[node_id].component_operator == COMPONENT_READ_MEMORY || nodes[node_id].component_operator == COMPONENT_WRITE_MEMORY )
+        generic += to_string(node.outputs.output[0].bit_size);
+//         if ( node.component_operator == COMPONENT_READ_MEMORY || node.component_operator == COMPONENT_WRITE_MEMORY )
 //         {
 //             generic += COMMA;
-//             generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+//             generic += to_string(node.outputs.output[0].bit_size);
 //         }
         
-        if ( nodes[node_id].component_operator.find("getelementptr_op") != std::string::npos )
+        if ( node.component_operator.find("getelementptr_op") != std::string::npos )
         {
             generic += COMMA;
-            generic += to_string(nodes[node_id].constants);
+            generic += to_string(node.constants);
         }
         
     }    
 
-    if ( nodes[node_id].type.find("Entry") != std::string::npos )
+    if ( node.type.find("Entry") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
 
-    if ( nodes[node_id].type.find("Exit") != std::string::npos )
+    if ( node.type.find("Exit") != std::string::npos )
     {
         if(!fix_mc_st_interfaces_flag) {
-            generic = to_string(nodes[node_id].inputs.size - get_memory_inputs ( node_id ));
+            generic = to_string(node.inputs.size - get_memory_inputs ( node_id ));
             generic += COMMA;
             generic += to_string( get_memory_inputs ( node_id ) );
             generic += COMMA;
-            generic += to_string(nodes[node_id].outputs.size);
+            generic += to_string(node.outputs.size);
             generic += COMMA;
         } else {
 
             // comment the previous and uncomment the bottom to use AYa's new end_node design 
-            generic = to_string(nodes[node_id].inputs.size - get_memory_inputs ( node_id ));
+            generic = to_string(node.inputs.size - get_memory_inputs ( node_id ));
             generic += COMMA;
            // AYA: 24/07/2023: added a condition here to pass this second generic as 1 in case there are no memory_inputs
             if(get_memory_inputs ( node_id ) == 0) {
@@ -2510,95 +2527,95 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
             generic += to_string( get_memory_inputs ( node_id ));
             generic += COMMA;
             ///////////////////////////////////////
-            generic += to_string(nodes[node_id].outputs.size);
+            generic += to_string(node.outputs.size);
             generic += COMMA; 
         }
 
 #if 0
         int size_max = 0;
-        for ( int indx = 0; indx < nodes[node_id].inputs.size; indx++ )
+        for ( int indx = 0; indx < node.inputs.size; indx++ )
         {
-            if ( nodes[node_id].inputs.input[indx].bit_size > size_max )
+            if ( node.inputs.input[indx].bit_size > size_max )
             {
-                size_max = nodes[node_id].inputs.input[indx].bit_size;
+                size_max = node.inputs.input[indx].bit_size;
             }
         }
         generic += to_string(size_max);
 #endif
 
-        //generic += to_string(nodes[node_id].inputs.input[nodes[node_id].inputs.size].bit_size);
-        generic += to_string(nodes[node_id].inputs.input[nodes[node_id].inputs.size-1].bit_size);
+        //generic += to_string(node.inputs.input[node.inputs.size].bit_size);
+        generic += to_string(node.inputs.input[node.inputs.size-1].bit_size);
         
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
 
-    if ( nodes[node_id].type.find("Sink") != std::string::npos )
+    if ( node.type.find("Sink") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
     
-    if ( nodes[node_id].type.find("Source") != std::string::npos )
+    if ( node.type.find("Source") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
 
-    if ( nodes[node_id].type.find("Fifo") != std::string::npos)
+    if ( node.type.find("Fifo") != std::string::npos)
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].slots);
+        generic += to_string(node.slots);
     } 
 
-    if ( nodes[node_id].type.find("nFifo") != std::string::npos )
+    if ( node.type.find("nFifo") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].slots);
+        generic += to_string(node.slots);
     }   
 
-    if ( nodes[node_id].type.find("tFifo") != std::string::npos )
+    if ( node.type.find("tFifo") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].slots);
+        generic += to_string(node.slots);
     }      
 
-     if(nodes[node_id].type.find("Free_Tags_Fifo") != std::string::npos) {
-        generic = to_string(nodes[node_id].inputs.size);
+     if(node.type.find("Free_Tags_Fifo") != std::string::npos) {
+        generic = to_string(node.inputs.size);
         generic += COMMA;
 
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
 
         string N;
@@ -2633,49 +2650,49 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
         generic += to_string(std::stoi(N) + 1);  // AYA: 27/12/2023: although we increased the number of bits, the depth should remain the same since a single TAGGER will still have the same total number of tags but multiple tags collectively require more bits to store their tags on the same signal..
     }
 
-    if ( nodes[node_id].type.find("TEHB") != std::string::npos )
+    if ( node.type.find("TEHB") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
-    if ( nodes[node_id].type.find("OEHB") != std::string::npos )
+    if ( node.type.find("OEHB") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
     }    
 
     // AYA: 01/10/2023: added the extra and to skip the Aligner_Mux
-    if ( nodes[node_id].type.find("Mux") != std::string::npos && nodes[node_id].type.find("Aligner") == std::string::npos)
+    if ( node.type.find("Mux") != std::string::npos && node.type.find("Aligner") == std::string::npos)
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+        generic += to_string(node.inputs.input[1].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size); // condition size inputs.input[input_indx].type
+        generic += to_string(node.inputs.input[0].bit_size); // condition size inputs.input[input_indx].type
         /*
          *         
          * generic += COMMA;
 
-        if ( nodes[node_id].inputs.input[1].type == "i" ) 
+        if ( node.inputs.input[1].type == "i" ) 
             generic += "1"; // input is inverted
         else
             generic += "0"; // input is not inverted
         generic += COMMA;
-        if ( nodes[node_id].inputs.input[2].type == "i" ) 
+        if ( node.inputs.input[2].type == "i" ) 
             generic += "1"; // input is inverted
         else
             generic += "0"; // input is not inverted
@@ -2684,17 +2701,17 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     }   
 
     // AYA: 28/02/2023: adding support for the new type of MUX that will be placed at the loop headers
-    if ( nodes[node_id].type.find("LoopMux") != std::string::npos )
+    if ( node.type.find("LoopMux") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+        generic += to_string(node.inputs.input[1].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size); // condition size inputs.input[input_indx].type
+        generic += to_string(node.inputs.input[0].bit_size); // condition size inputs.input[input_indx].type
         generic += COMMA;
 
         string N;
@@ -2728,12 +2745,12 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
          *         
          * generic += COMMA;
 
-        if ( nodes[node_id].inputs.input[1].type == "i" ) 
+        if ( node.inputs.input[1].type == "i" ) 
             generic += "1"; // input is inverted
         else
             generic += "0"; // input is not inverted
         generic += COMMA;
-        if ( nodes[node_id].inputs.input[2].type == "i" ) 
+        if ( node.inputs.input[2].type == "i" ) 
             generic += "1"; // input is inverted
         else
             generic += "0"; // input is not inverted
@@ -2742,32 +2759,32 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     }     
 
         // AYA: 27/03/2023: adding support for the new type of TMFO that is needed in the transformation from REGEN_SUPP to SUPP_REGEN
-    if ( nodes[node_id].type.find("TMFO") != std::string::npos )
+    if ( node.type.find("TMFO") != std::string::npos )
     {
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size); // condition size inputs.input[input_indx].type  
+        generic += to_string(node.inputs.input[0].bit_size); // condition size inputs.input[input_indx].type  
     }   
 
-    if ( nodes[node_id].type.find("Inj") != std::string::npos )
+    if ( node.type.find("Inj") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[1].bit_size);
+        generic += to_string(node.inputs.input[1].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size); // condition size inputs.input[input_indx].type
+        generic += to_string(node.inputs.input[0].bit_size); // condition size inputs.input[input_indx].type
         /*
          *         
          * generic += COMMA;
 
-        if ( nodes[node_id].inputs.input[1].type == "i" ) 
+        if ( node.inputs.input[1].type == "i" ) 
             generic += "1"; // input is inverted
         else
             generic += "0"; // input is not inverted
         generic += COMMA;
-        if ( nodes[node_id].inputs.input[2].type == "i" ) 
+        if ( node.inputs.input[2].type == "i" ) 
             generic += "1"; // input is inverted
         else
             generic += "0"; // input is not inverted
@@ -2775,38 +2792,38 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
         
     }    
 
-    if ( nodes[node_id].type.find("CntrlMerge") != std::string::npos )
+    if ( node.type.find("CntrlMerge") != std::string::npos )
     {
-        generic = to_string(nodes[node_id].inputs.size);
+        generic = to_string(node.inputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[1].bit_size); // condition size
+        generic += to_string(node.outputs.output[1].bit_size); // condition size
     }    
 
-    if ( nodes[node_id].type.find("MC") != std::string::npos )
+    if ( node.type.find("MC") != std::string::npos )
     {
-        generic += to_string(nodes[node_id].data_size);
+        generic += to_string(node.data_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].address_size);
+        generic += to_string(node.address_size);
         generic += COMMA;
         if(fix_mc_st_interfaces_flag)   // Aya: 16/07/2023: Added extra condition to consider the BB count that indexes the array of store counts to 0 in preparation for removing the count
             generic += to_string(1);
         else
-            generic += to_string(nodes[node_id].bbcount);
+            generic += to_string(node.bbcount);
         generic += COMMA;
-        generic += to_string(nodes[node_id].load_count);
+        generic += to_string(node.load_count);
         generic += COMMA;
-        generic += to_string(nodes[node_id].store_count);
+        generic += to_string(node.store_count);
 
 
     }    
 
-    if (nodes[node_id].type.find("Selector") != std::string::npos)
+    if (node.type.find("Selector") != std::string::npos)
     {
 
     //INPUTS : integer 
@@ -2821,10 +2838,10 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     //BB_COUNT_INFO_SIZE : integer
 
         
-        int amount_of_bbs = nodes[node_id].orderings.size();
+        int amount_of_bbs = node.orderings.size();
         int bb_id_info_size = amount_of_bbs <= 1 ? 1 : (int)ceil(log2(amount_of_bbs));
         int max_shared_components = -1;
-        for(auto ordering_per_bb : nodes[node_id].orderings){
+        for(auto ordering_per_bb : node.orderings){
             int size = ordering_per_bb.size();
             if(max_shared_components < size){
                 max_shared_components = size;
@@ -2833,22 +2850,22 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
         int bb_count_info_size = max_shared_components <= 1 ? 1 : ceil(log2(max_shared_components));
 
         //INPUTS
-        generic += to_string(nodes[node_id].inputs.size - amount_of_bbs);
+        generic += to_string(node.inputs.size - amount_of_bbs);
         generic += COMMA;
         //OUTPUTS
-        generic += to_string(nodes[node_id].outputs.size);
+        generic += to_string(node.outputs.size);
         generic += COMMA;
         //COND_SIZE
-        generic += to_string(nodes[node_id].outputs.output[nodes[node_id].outputs.size - 1].bit_size);
+        generic += to_string(node.outputs.output[node.outputs.size - 1].bit_size);
         generic += COMMA;
         //DATA_SIZE_IN
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
         //DATA_SIZE_OUT
-        generic += to_string(nodes[node_id].outputs.output[0].bit_size);
+        generic += to_string(node.outputs.output[0].bit_size);
         generic += COMMA;
         //AMOUNT_OF_BB_IDS
-        generic += to_string(nodes[node_id].orderings.size());
+        generic += to_string(node.orderings.size());
         generic += COMMA;
         //AMOUNT_OF_SHARED_COMPONENTS
         generic += to_string(max_shared_components);
@@ -2859,21 +2876,21 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
         //BB_COUNT_INFO_SIZE
         generic += to_string(bb_count_info_size);
     }
-    else if (nodes[node_id].type.find("SEL") != std::string::npos)
+    else if (node.type.find("SEL") != std::string::npos)
     {
-        generic += to_string(nodes[node_id].inputs.size);
+        generic += to_string(node.inputs.size);
         generic += COMMA;
         // TODO change hardcoded number of groups
         // TODO change to number of groups
         generic += to_string(2);
         generic += COMMA;
-        generic += to_string(nodes[node_id].inputs.input[0].bit_size);
+        generic += to_string(node.inputs.input[0].bit_size);
         generic += COMMA;
-        generic += to_string(nodes[node_id].outputs.output[nodes[node_id].outputs.size - 1].bit_size);
+        generic += to_string(node.outputs.output[node.outputs.size - 1].bit_size);
     }
 
     // AYA: 06/08/2023
-    if(nodes[node_id].is_tagged == 1) {
+    if(node.is_tagged == 1) {
         string N;
         // Read from the text file
         ifstream file_N("/home/dynamatic/Dynamatic/etc/dynamatic/dot2vhdl/src/gian_N.txt");
@@ -2905,6 +2922,109 @@ string get_generic ( int node_id, bool fix_mc_st_interfaces_flag, bool fix_mc_st
     return generic;
 }
 
+// Instance name and entity of a node, before the generic map
+string get_instance_entity ( int i )
+{
+    string entity;
+
+    // AYA: 05/08/2023
+    //assert(nodes[i].is_tagged != -1);
+    if(nodes[i].is_tagged == 1) {
+        entity = nodes[i].name + "_tagged";
+    } else {
+        entity = nodes[i].name;
+    }
+    
+    entity += ": entity work.";
+    if ( nodes[i].type == "Operator" )
+    {
+        entity += nodes[i].component_operator;
+    }
+    else if ( nodes[i].type == "LSQ" )
+    {
+        entity = "c_"+nodes[i].name + ":" + nodes[i].name;
+    }
+    else if ( nodes[i].type == "Synch" )  // AYA: 29/04/2023
+    {
+        entity += "synch";
+    }
+    else if(nodes[i].type == "Tagger") // AYA: 17/09/2023
+    {
+        entity += "tagger";
+    }
+    else if(nodes[i].type == "Un_Tagger")
+    {
+        entity += "un_tagger";
+    }
+    else if(nodes[i].type == "Free_Tags_Fifo")
+    {
+        entity += "free_tags_fifo";
+    }
+    else if(nodes[i].type == "Aligner_Branch")
+    {
+        entity += "aligner_branch";
+    }
+    else if(nodes[i].type == "Aligner_Mux")
+    {
+        entity += "aligner_mux";
+    }
+    else if(nodes[i].type == "Split")
+    {
+        entity += "split";
+    }
+    else if(nodes[i].type == "Concat")
+    {
+        entity += "concat";
+    }
+    else if (nodes[i].type == "ROB")  // AYA : 08/08/2023
+    {
+        entity += "ROB";
+    }
+    else
+    {
+        entity += get_component_entity ( nodes[i].component_operator, i );
+    }
+
+    // AYA: 05/08/2023
+    if(nodes[i].is_tagged == 1) {
+        entity += "_tagged";
+    }
+
+    return entity;
+}
+
+// The fields of a node read by get_instance_entity and get_generic, the numbers in binary
+void get_instance_key ( const NODE_T &node, string &key )
+{
+    auto add_number = [&key] ( int value ) { key.append ( (const char *) &value, sizeof ( value ) ); };
+
+    key = node.type;
+    key += '\0';
+    key += node.component_operator;
+    key += '\0';
+
+    for ( int value : { node.is_tagged, node.inputs.size, node.outputs.size, node.slots, node.bbcount, node.load_count, node.store_count, node.data_size, node.address_size, node.constants, node.component_id } )
+    {
+        add_number ( value );
+    }
+    add_number ( node.inputs.input.size() );
+    for ( const INPUT_T &input : node.inputs.input )
+    {
+        add_number ( input.bit_size );
+        key += input.type;
+        key += '\0';
+    }
+    add_number ( node.outputs.output.size() );
+    for ( const OUTPUT_T &output : node.outputs.output )
+    {
+        add_number ( output.bit_size );
+    }
+    for ( const vector<int> &ordering : node.orderings )
+    {
+        add_number ( ordering.size() );
+    }
+}
+
 void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int max_number_of_nested_taggers )
 {
     string entity="";
@@ -2920,113 +3040,63 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
     bool fix_mc_st_interfaces_flag = false;  //false;  // Aya: 12/07/2023: added the following to allow me to choose if I would like MC and ST the old way or the new way
     bool fix_mc_st_interfaces_flag_yes_extra_ST_output = false;
 
+    // Instantiation up to the port map, without the instance name, by get_instance_key:
+    // most of the nodes share the type and the widths with others
+    unordered_map<string, string> instances;
+    string key;
+
     for (int i = 0; i < components_in_netlist; i++) 
     {
         
-        netlist << endl;
-
-        // AYA: 05/08/2023
-        //assert(nodes[i].is_tagged != -1);
-        if(nodes[i].is_tagged == 1) {
-            entity = nodes[i].name + "_tagged";
-        } else {
-            entity = nodes[i].name;
-        }
-        
-        entity += ": entity work.";
-        if ( nodes[i].type == "Operator" )
-        {
-            entity += nodes[i].component_operator;
-        }
-        else if ( nodes[i].type == "LSQ" )
-        {
-            entity = "c_"+nodes[i].name + ":" + nodes[i].name;
-        }
-        else if ( nodes[i].type == "Synch" )  // AYA: 29/04/2023
-        {
-            entity += "synch";
-        }
-        else if(nodes[i].type == "Tagger") // AYA: 17/09/2023
-        {
-            entity += "tagger";
-        }
-        else if(nodes[i].type == "Un_Tagger")
-        {
-            entity += "un_tagger";
-        }
-        else if(nodes[i].type == "Free_Tags_Fifo")
-        {
-            entity += "free_tags_fifo";
-        }
-        else if(nodes[i].type == "Aligner_Branch")
-        {
-            entity += "aligner_branch";
-        }
-        else if(nodes[i].type == "Aligner_Mux")
-        {
-            entity += "aligner_mux";
-        }
-        else if(nodes[i].type == "Split")
-        {
-            entity += "split";
-        }
-        else if(nodes[i].type == "Concat")
-        {
-            entity += "concat";
-        }
-        else if (nodes[i].type == "ROB")  // AYA : 08/08/2023
-        {
-            entity += "ROB";
-        }
-        else
-        {
-            entity += get_component_entity ( nodes[i].component_operator, i );
-        }
+        netlist << '\n';
 
-        // AYA: 05/08/2023
-        if(nodes[i].is_tagged == 1) {
-            entity += "_tagged";
-        }
-        
-        
         if ( nodes[i].type != "LSQ" )
         {
-            entity += "(arch)";
+            // The nodes with the same key only differ in the instance name
+            get_instance_key ( nodes[i], key );
+            string &instance = instances[key];
+            if ( instance.empty() )
+            {
+                entity = get_instance_entity ( i );
+                entity += "(arch)";
 
-            generic = " generic map (";
-            
-            //generic += get_generic ( nodes[i].node_id );
-            generic += get_generic ( i, fix_mc_st_interfaces_flag, fix_mc_st_interfaces_flag_yes_extra_ST_output, tagged_loop_mux_flag, max_number_of_nested_taggers );
-            
-            generic += ")";
+                generic = " generic map (";
+                
+                //generic += get_generic ( nodes[i].node_id );
+                generic += get_generic ( i, fix_mc_st_interfaces_flag, fix_mc_st_interfaces_flag_yes_extra_ST_output, tagged_loop_mux_flag, max_number_of_nested_taggers );
+                
+                generic += ")";
+
+                instance = entity.substr ( nodes[i].name.size() ) + generic;
+            }
             
-            netlist << entity << generic << endl;
+            netlist << nodes[i].name << instance << '\n';
         }
         else
         {
-            netlist << entity << endl;
+            netlist << get_instance_entity ( i ) << '\n';
         }
         
-        netlist << "port map (" << endl;
+        netlist << "port map (" << '\n';
 
         if ( nodes[i].type != "LSQ" && nodes[i].type != "Synch" ) //&& nodes[i].type != "Tagger") 
         // AYA: 17/09/2023: added the tagger to the condition, then removed it!
         // AYA: 30/04/2023: added gian Synch component to the if condition 
         {        
             netlist << "\t" << "clk => " << nodes[i].name << "_clk";
-            netlist << COMMA << endl<< "\t" << "rst => " << nodes[i].name << "_rst";
+            netlist << COMMA << '\n'<< "\t" << "rst => " << nodes[i].name << "_rst";
         }
         else
         {
             if ( nodes[i].type != "Synch" ) { //&& nodes[i].type != "Tagger") {// AYA: 30/04/2023: added gian Synch component in an extra if condition  // AYA: 17/09/2023: also added the Tagger to it
                 netlist << "\t" << "clock => " << nodes[i].name << "_clk";
-                netlist << COMMA << endl<< "\t" << "reset => " << nodes[i].name << "_rst";
+                netlist << COMMA << '\n'<< "\t" << "reset => " << nodes[i].name << "_rst";
                 
                 // Andrea 20200117 Added to be compatible with chisel LSQ
-                netlist << "," << endl;
+                netlist << "," << '\n';
     //            netlist << "\t" << "io_memIsReadyForLoads => '1' ," << endl;
     //            netlist << "\t" << "io_memIsReadyForStores => '1' ";
-                netlist << "\t" << "io_memIsReadyForLoads => " <<  nodes[i].name << "_load_ready" << COMMA << endl;
+                netlist << "\t" << "io_memIsReadyForLoads => " <<  nodes[i].name << "_load_ready" << COMMA << '\n';
                 netlist << "\t" << "io_memIsReadyForStores => " <<  nodes[i].name << "_store_ready";
             }
         }
@@ -3083,7 +3153,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     //cout << nodes[i].name << "LSQ output "<< lsq_indx << " = " << nodes[i].outputs.output[lsq_indx].type << " port = " << nodes[i].outputs.output[lsq_indx].port << " info_type = " <<nodes[i].outputs.output[lsq_indx].info_type << endl;     
                 }
 
-                netlist << "," << endl;
+                netlist << "," << '\n';
                 
                 if ( nodes[i].type == "LSQ" )
                 {
@@ -3097,7 +3167,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += "dout0";
                 input_signal += COMMA;
                 
-                netlist << "\t" << "io_storeDataOut" << " => "   << input_signal << endl;
+                netlist << "\t" << "io_storeDataOut" << " => "   << input_signal << '\n';
 
                 if ( nodes[i].type == "LSQ" )
                 {
@@ -3111,14 +3181,14 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += "address0";
                 input_signal += COMMA;
 
-                netlist << "\t" << "io_storeAddrOut" << " => "  << input_signal << endl;
+                netlist << "\t" << "io_storeAddrOut" << " => "  << input_signal << '\n';
                 
                 input_signal = nodes[i].name;
                 input_signal += UNDERSCORE;
                 input_signal += "we0_ce0";
                 input_signal += COMMA;
 
-                netlist << "\t" << "io_storeEnable"<< " => "  << input_signal << endl;
+                netlist << "\t" << "io_storeEnable"<< " => "  << input_signal << '\n';
                 
                 if ( nodes[i].type == "LSQ" )
                 {
@@ -3132,7 +3202,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += "din1";
                 input_signal += COMMA;
 
-                netlist << "\t" << "io_loadDataIn" << " => "  << input_signal << endl;
+                netlist << "\t" << "io_loadDataIn" << " => "  << input_signal << '\n';
                 
                 if ( nodes[i].type == "LSQ" )
                 {
@@ -3146,7 +3216,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += "address1";
                 input_signal += COMMA;
 
-                netlist << "\t" << "io_loadAddrOut"<< " => "  << input_signal  << endl;
+                netlist << "\t" << "io_loadAddrOut"<< " => "  << input_signal  << '\n';
                 
                 if ( nodes[i].type == "LSQ" )
                 {
@@ -3183,7 +3253,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
             
 
 
-            netlist << COMMA << endl;
+            netlist << COMMA << '\n';
             for ( int lsq_indx = 0; lsq_indx < nodes[i].inputs.size; lsq_indx++ )
             {    
                 //cout << nodes[i].name; 
@@ -3739,7 +3809,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 if ( nodes[i].outputs.output[lsq_indx].type == "c" )
                 {
                     //LANA REMOVE???
-                    netlist << COMMA << endl;
+                    netlist << COMMA << '\n';
                     input_port = "io";
                     input_port += UNDERSCORE;
                     input_port += "bbValids";
@@ -3753,7 +3823,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     input_signal += to_string(lsq_indx);
                     input_signal += COMMA;
 
-                    netlist << "\t" << input_port << " => "  << input_signal << endl;
+                    netlist << "\t" << input_port << " => "  << input_signal << '\n';
 
                     
                     input_port = "io";
@@ -3910,7 +3980,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 if ( nodes[i].outputs.output[lsq_indx].type == "s" )
                 {
                     //LANA REMOVE???
-                    netlist << COMMA << endl;
+                    netlist << COMMA << '\n';
                     static int store_indx = 0;
 
                     input_port = "io";
@@ -3929,7 +3999,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     input_signal += to_string(lsq_indx);
                     input_signal += COMMA;
 
-                    netlist << "\t" << input_port << " => "  << input_signal << endl;
+                    netlist << "\t" << input_port << " => "  << input_signal << '\n';
 
                     
                     input_port = "io";
@@ -4128,7 +4198,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     input_signal += components_type[nodes[i].component_type].in_ports_name_str[0];
                     input_signal += UNDERSCORE;
                     input_signal += to_string(indx);
-                    netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                    netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                 }
             }
             for ( indx = 0; indx < nodes[i].inputs.size; indx++ )
@@ -4164,7 +4234,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 {
                 //    input_signal = "\'0\', --Andrea forced to 0 to run the simulation";
                 }
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
             for ( indx = 0; indx < nodes[i].inputs.size; indx++ )
             {
@@ -4191,7 +4261,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += to_string(indx);
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
             
             //netlist << COMMA << endl << "\t" << "ap_done" << " => " << "ap_done";
@@ -4208,7 +4278,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += "0";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             
 
                 
@@ -4225,7 +4295,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += "0";
 
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
                 input_port = NREADY_ARRAY;
                 input_port += "(";
@@ -4239,7 +4309,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += "0";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
 
 
@@ -4276,7 +4346,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     input_signal += components_type[nodes[i].component_type].in_ports_name_str[0];
                     input_signal += UNDERSCORE;
                     input_signal += to_string(indx);
-                    netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                    netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                 }
             }
             for ( indx = 0; indx < nodes[i].inputs.size; indx++ )
@@ -4312,7 +4382,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 {
                 //    input_signal = "\'0\', --Andrea forced to 0 to run the simulation";
                 }
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
             for ( indx = 0; indx < nodes[i].inputs.size; indx++ )
             {
@@ -4339,7 +4409,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += to_string(indx);
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
             
             //netlist << COMMA << endl << "\t" << "ap_done" << " => " << "ap_done";
@@ -4356,7 +4426,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += "0";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             
 
                 
@@ -4373,7 +4443,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += "0";
 
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
                 input_port = NREADY_ARRAY;
                 input_port += "(";
@@ -4387,7 +4457,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += "0";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                 
 
         }
@@ -4571,11 +4641,11 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                         if(nodes[i].type.find("ROB") != std::string::npos && indx == 1 || 
                             (tagged_loop_mux_flag && nodes[i].component_operator.find("LoopMux") != std::string::npos && indx == 2) || (nodes[i].type.find("Concat") != std::string::npos && indx == 0) /*||
                             (nodes[i].type == "Un_Tagger")*/){ // AYA: 08/08/2023
-                            netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
-                            netlist << COMMA << endl << "\t" << input_port_2 << " => " << input_signal_2;
+                            netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
+                            netlist << COMMA << '\n' << "\t" << input_port_2 << " => " << input_signal_2;
 
                         } else if (nodes[i].type.find("Concat") == std::string::npos)  // since we already took care of Concat, print the following only for non-Concat
-                            netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                            netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                     }
                 }
             }
@@ -4594,7 +4664,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     input_signal_ += UNDERSCORE;
                     input_signal_ += to_string(indx);
 
-                    netlist << COMMA << endl << "\t" << input_port_ << " => " << input_signal_;
+                    netlist << COMMA << '\n' << "\t" << input_port_ << " => " << input_signal_;
                 }
             }
                                  
@@ -4648,7 +4718,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += to_string( indx );
                
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
 
             for ( indx = 0; indx < nodes[i].inputs.size; indx++ )
@@ -4697,7 +4767,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += to_string( indx );
 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                 
             }
             
@@ -4712,7 +4782,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal +=  "read_enable";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
                 input_port = "read_address";
                 
@@ -4720,7 +4790,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal +=  "read_address";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
                 input_port = "data_from_memory";
                 
@@ -4728,7 +4798,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal +=  "data_from_memory";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
             
         
@@ -4740,7 +4810,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal +=  "write_enable";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
                 input_port = "write_address";
                 
@@ -4748,7 +4818,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal +=  "write_address";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
 
                 input_port = "data_to_memory";
                 
@@ -4756,7 +4826,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal +=  "data_to_memory";
                 
-                netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
             }
 
             
@@ -4782,7 +4852,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
 
                 // AYA: 07/08/2023: ignore the 2nd output of the LoopMux because I take care of it in the bottom
                 if(nodes[i].component_operator.find("LoopMux") == std::string::npos || indx == 0) {
-                    netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                    netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                 }
                 
             }
@@ -4807,7 +4877,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 
                  // AYA: 07/08/2023: ignore the 2nd output of the LoopMux because I take care of it in the bottom
                 if(nodes[i].component_operator.find("LoopMux") == std::string::npos || indx == 0) {
-                    netlist << COMMA << endl << "\t" << input_port << " => " << input_signal;
+                    netlist << COMMA << '\n' << "\t" << input_port << " => " << input_signal;
                 }
             }
             for ( indx = 0; indx < nodes[i].outputs.size; indx++ )
@@ -4877,7 +4947,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                      // AYA: 07/08/2023: ignore the 2nd output of the LoopMux because I take care of it in the bottom
                     // Skip the Split component from the standard printing because it has its own custom output ports
                     if((nodes[i].component_operator.find("LoopMux") == std::string::npos && (nodes[i].component_operator.find("Split") == std::string::npos) ) || indx == 0) {
-                        netlist << COMMA << endl << "\t" << output_port << " => " << output_signal;
+                        netlist << COMMA << '\n' << "\t" << output_port << " => " << output_signal;
                     }
                     //netlist << COMMA << endl << "\t" << output_port << " => " << output_signal;
 
@@ -4891,14 +4961,14 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                         output_signal += UNDERSCORE;
                         output_signal += to_string( indx );
 
-                        netlist << COMMA << endl << "\t" << output_port << " => " << output_signal;
+                        netlist << COMMA << '\n' << "\t" << output_port << " => " << output_signal;
                     }
 
                     if (nodes[i].component_operator.find("Split") != std::string::npos && indx == 1) {
                         // print the additional Split output
                         output_port = "dataOut2(0)";
 
-                        netlist << COMMA << endl << "\t" << output_port << " => " << output_signal;
+                        netlist << COMMA << '\n' << "\t" << output_port << " => " << output_signal;
                     }
 
                 }
@@ -4924,7 +4994,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                         output_signal += UNDERSCORE;
                         output_signal += to_string( indx );
 
-                        netlist << COMMA << endl << "\t" << output_port << " => " << output_signal;
+                        netlist << COMMA << '\n' << "\t" << output_port << " => " << output_signal;
                     } else if(nodes[i].type == "Aligner_Mux") {  // AYA: 01/10/2023
                         // print the extra tag port
                         output_port = "tagOutArray(" + to_string(indx) + ")";
@@ -4934,7 +5004,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                         output_signal += UNDERSCORE;
                         output_signal += to_string( indx );
 
-                        netlist << COMMA << endl << "\t" << output_port << " => " << output_signal;
+                        netlist << COMMA << '\n' << "\t" << output_port << " => " << output_signal;
                     } 
 
                 }
@@ -4976,7 +5046,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     input_signal += string_constant(value, index_size);
                     input_signal += "\"";
 
-                    netlist << COMMA << endl
+                    netlist << COMMA << '\n'
                             << "\t" << input_port << " => " << input_signal;
                 }
             }
@@ -4985,28 +5055,28 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
         // AYA: 03/08/2023: adding the following for the tagged_loop_mux option to print the extra ports...
         if(tagged_loop_mux_flag) {
             if (nodes[i].component_operator.find("LoopMux") != std::string::npos) {
-                netlist << COMMA << endl << "\t";
+                netlist << COMMA << '\n' << "\t";
 
                 string port = "tag_order_data => ";
                 port += nodes[i].name;
                 port += UNDERSCORE;
                 port += "tag_order_data"; 
 
-                netlist << port << COMMA << endl << "\t";
+                netlist << port << COMMA << '\n' << "\t";
 
                 port = "tag_order_valid(0) => ";
                 port += nodes[i].name;
                 port += UNDERSCORE;
                 port += "tag_order_valid";
                 
-                netlist << port << COMMA << endl << "\t";
+                netlist << port << COMMA << '\n' << "\t";
 
                 port = "tag_order_nReady(0) => ";
                 port += nodes[i].name;
                 port += UNDERSCORE;
                 port += "tag_order_nReady";
                 
-                netlist << port << endl;
+                netlist << port << '\n';
 
                 /*string port = "tag_data => ";
                 port += nodes[i].name;
@@ -5015,7 +5085,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 port += UNDERSCORE;
                 port += to_string( 1 );  // AYA: the tag output is the 2nd output in my convention 
 
-                netlist << port << COMMA << endl << "\t";
+                netlist << port << COMMA << '\n' << "\t";
 
                 port = "tag_valid(0) => ";
                 port += nodes[i].name;
@@ -5024,7 +5094,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 port += UNDERSCORE;
                 port += to_string( 1 );  // AYA: the tag output is the 2nd output in my convention 
 
-                netlist << port << COMMA << endl << "\t";
+                netlist << port << COMMA << '\n' << "\t";
 
                 port = "tag_nReady(0) => ";
                 input_signal = nodes[i].name;
@@ -5033,7 +5103,7 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                 input_signal += UNDERSCORE;
                 input_signal += to_string( 1 ); // AYA: the tag output is the 2nd output in my convention
 
-                netlist << port << endl;*/
+                netlist << port << '\n';*/
 
             }
         }
@@ -5041,26 +5111,26 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
         // AYA: 06/08/2023
         if(nodes[i].is_tagged == 1) {
             if(nodes[i].component_operator.find("mc_load_op")!= std::string::npos) {
-                netlist << COMMA << endl;
-                netlist << "\t" << "tagInArray(" << to_string(0) << ") => " << nodes[i].name << "_tagIn_0" <<  COMMA << endl;
+                netlist << COMMA << '\n';
+                netlist << "\t" << "tagInArray(" << to_string(0) << ") => " << nodes[i].name << "_tagIn_0" <<  COMMA << '\n';
 
-                netlist << "\t" << "tagOutArray(" << to_string(0) << ") => " << nodes[i].name << "_tagOut_" << to_string(0) << endl;
+                netlist << "\t" << "tagOutArray(" << to_string(0) << ") => " << nodes[i].name << "_tagOut_" << to_string(0) << '\n';
 
             } else if(nodes[i].component_operator.find("mc_store_op")!= std::string::npos) {
-                netlist << COMMA << endl;
-                netlist << "\t" << "tagInArray(" << to_string(0) << ") => " << nodes[i].name << "_tagIn_0" << COMMA << endl;
-                netlist << "\t" << "tagInArray(" << to_string(1) << ") => " << nodes[i].name << "_tagIn_1" << endl;  // do not put a comma because the ST has no tag out
+                netlist << COMMA << '\n';
+                netlist << "\t" << "tagInArray(" << to_string(0) << ") => " << nodes[i].name << "_tagIn_0" << COMMA << '\n';
+                netlist << "\t" << "tagInArray(" << to_string(1) << ") => " << nodes[i].name << "_tagIn_1" << '\n';  // do not put a comma because the ST has no tag out
 
             } else {
                 if(nodes[i].inputs.size > 0)
-                    netlist << COMMA << endl;
+                    netlist << COMMA << '\n';
                 // loop over all inputs and print a tagIn signal for each one
                 for (indx = 0; indx < nodes[i].inputs.size; indx++) {
                     netlist << "\t" << "tagInArray(" << to_string(indx) << ") => " << nodes[i].name << "_tagIn_" << to_string(indx);
                     if(indx < nodes[i].inputs.size - 1)
-                        netlist << COMMA << endl;
+                        netlist << COMMA << '\n';
                 } 
-                netlist << COMMA << endl; 
+                netlist << COMMA << '\n'; 
             } 
 
             // skip store instructions since we do not care (for now) for tagging their output and I took care of the output of the load above
@@ -5070,14 +5140,14 @@ void write_components (bool tagged_loop_mux_flag, bool tagger_is_tagging, int ma
                     netlist << "\t" << "tagOutArray(" << to_string(indx) << ") => " << nodes[i].name << "_tagOut_" << to_string(indx);
                         if(indx < nodes[i].outputs.size - 1)
                             netlist << COMMA;
-                        netlist << endl;  
+                        netlist << '\n';  
                 } 
             }
             
         }    
         ////////////////////////////////////////////////
 
-            netlist << endl << ");" << endl;
+            netlist << '\n' << ");" << '\n';
 
     }
 }
@@ -5106,17 +5176,17 @@ void write_entity ( string  filename, int indx, int max_number_of_nested_taggers
     string input_port, output_port, input_signal, output_signal, signal;
     if ( indx == 0 ) // Top-level module
     {
-        netlist << "entity "<< entity << " is " << endl;
-        netlist << "port (" << endl;
-        netlist << "\t" << "clk: " << " in std_logic;" << endl;
-        netlist << "\t" << "rst: " << " in std_logic;" << endl;
+        netlist << "entity "<< entity << " is " << '\n';
+        netlist << "port (" << '\n';
+        netlist << "\t" << "clk: " << " in std_logic;" << '\n';
+        netlist << "\t" << "rst: " << " in std_logic;" << '\n';
         
-        netlist << "\t" << "start_in: " << " in std_logic_vector (0 downto 0);" << endl;
-        netlist << "\t" << "start_valid: " << " in std_logic;" << endl;
-        netlist << "\t" << "start_ready: " << " out std_logic;" << endl;
+        netlist << "\t" << "start_in: " << " in std_logic_vector (0 downto 0);" << '\n';
+        netlist << "\t" << "start_valid: " << " in std_logic;" << '\n';
+        netlist << "\t" << "start_ready: " << " out std_logic;" << '\n';
         
-        netlist << "\t" << "end_out: " << " out std_logic_vector ("<< get_end_bitsize() <<" downto 0);" << endl;
-        netlist << "\t" << "end_valid: " << " out std_logic;" << endl;
+        netlist << "\t" << "end_out: " << " out std_logic_vector ("<< get_end_bitsize() <<" downto 0);" << '\n';
+        netlist << "\t" << "end_valid: " << " out std_logic;" << '\n';
         netlist << "\t" << "end_ready: " << " in std_logic";
 
         //netlist << "\t" << "ap_ready: " << " out std_logic";
@@ -5125,18 +5195,18 @@ void write_entity ( string  filename, int indx, int max_number_of_nested_taggers
         {
             if ( (nodes[i].name.find("Arg") != std::string::npos) || ( (nodes[i].type.find("Entry") != std::string::npos) && (!(nodes[i].name.find("start") != std::string::npos))) )
             {
-                netlist << ";" << endl; 
-                netlist << "\t" << nodes[i].name << "_din : in std_logic_vector (31 downto 0);" << endl;
-                netlist << "\t" << nodes[i].name << "_valid_in : in std_logic;" << endl;
+                netlist << ";" << '\n'; 
+                netlist << "\t" << nodes[i].name << "_din : in std_logic_vector (31 downto 0);" << '\n';
+                netlist << "\t" << nodes[i].name << "_valid_in : in std_logic;" << '\n';
                 netlist << "\t" << nodes[i].name << "_ready_out : out std_logic";
             }
 
             //if ( nodes[i].name.find("load") != std::string::npos )
             if ( nodes[i].component_operator == "load_op" )
             {
-                netlist << ";" << endl; 
-                netlist << "\t" << nodes[i].name << "_data_from_memory : in std_logic_vector (31 downto 0);" << endl;
-                netlist << "\t" << nodes[i].name << "_read_enable : out std_logic;" << endl;
+                netlist << ";" << '\n'; 
+                netlist << "\t" << nodes[i].name << "_data_from_memory : in std_logic_vector (31 downto 0);" << '\n';
+                netlist << "\t" << nodes[i].name << "_read_enable : out std_logic;" << '\n';
                 netlist << "\t" << nodes[i].name << "_read_address : out std_logic_vector (31 downto 0)";
             }
 
@@ -5144,9 +5214,9 @@ void write_entity ( string  filename, int indx, int max_number_of_nested_taggers
             if ( nodes[i].component_operator == "store_op" )
 
             {
-                netlist << ";" << endl; 
-                netlist << "\t" << nodes[i].name << "_data_to_memory : out std_logic_vector (31 downto 0);" << endl;
-                netlist << "\t" << nodes[i].name << "_write_enable : out std_logic;" << endl;
+                netlist << ";" << '\n'; 
+                netlist << "\t" << nodes[i].name << "_data_to_memory : out std_logic_vector (31 downto 0);" << '\n';
+                netlist << "\t" << nodes[i].name << "_write_enable : out std_logic;" << '\n';
                 netlist << "\t" << nodes[i].name << "_write_address : out std_logic_vector (31 downto 0)";
             }
 
@@ -5161,7 +5231,7 @@ void write_entity ( string  filename, int indx, int max_number_of_nested_taggers
                 if ( (nodes[i].type.find("LSQ") != std::string::npos && !mc_lsq) || nodes[i].type.find("MC") != std::string::npos)
                 //if ( nodes[i].type.find("MC") != std::string::npos )
                 {
-                    netlist << ";" << endl; 
+                    netlist << ";" << '\n'; 
                     
 //                     netlist << "\t" << nodes[i].memory << "_data_from_memory : in std_logic_vector (31 downto 0);" << endl;
 //                     netlist << "\t" << nodes[i].memory << "_read_enable : out std_logic;" << endl;
@@ -5171,39 +5241,41 @@ void write_entity ( string  filename, int indx, int max_number_of_nested_taggers
 //                     netlist << "\t" << nodes[i].memory << "_write_enable : out std_logic;" << endl;
 //                     netlist << "\t" << nodes[i].memory << "_write_address : out std_logic_vector (31 downto 0)";
 
-                    netlist << "\t" << nodes[i].memory << "_address0 : out std_logic_vector (31 downto 0);" << endl;
-                    netlist << "\t" << nodes[i].memory << "_ce0 : out std_logic;" << endl;
-                    netlist << "\t" << nodes[i].memory << "_we0 : out std_logic;" << endl;
-                    netlist << "\t" << nodes[i].memory << "_dout0 : out std_logic_vector (31 downto 0);" << endl;
-                    netlist << "\t" << nodes[i].memory << "_din0 : in std_logic_vector (31 downto 0);" << endl;
+                    netlist << "\t" << nodes[i].memory << "_address0 : out std_logic_vector (31 downto 0);" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_ce0 : out std_logic;" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_we0 : out std_logic;" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_dout0 : out std_logic_vector (31 downto 0);" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_din0 : in std_logic_vector (31 downto 0);" << '\n';
                     
-                    netlist << "\t" << nodes[i].memory << "_address1 : out std_logic_vector (31 downto 0);" << endl;
-                    netlist << "\t" << nodes[i].memory << "_ce1 : out std_logic;" << endl;
-                    netlist << "\t" << nodes[i].memory << "_we1 : out std_logic;" << endl;
-                    netlist << "\t" << nodes[i].memory << "_dout1 : out std_logic_vector (31 downto 0);" << endl;
+                    netlist << "\t" << nodes[i].memory << "_address1 : out std_logic_vector (31 downto 0);" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_ce1 : out std_logic;" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_we1 : out std_logic;" << '\n';
+                    netlist << "\t" << nodes[i].memory << "_dout1 : out std_logic_vector (31 downto 0);" << '\n';
                     netlist << "\t" << nodes[i].memory << "_din1 : in std_logic_vector (31 downto 0)";
                     
                 }
 
         }
         
-        netlist << ");" << endl;
-        netlist << "end;" << endl << endl;
+        write_perf_counters_ports ( );
+
+        netlist << ");" << '\n';
+        netlist << "end;" << '\n' << '\n';
     }
     else // Sub-Module module
     {
-        netlist << "entity "<< entity << " is " << endl;
+        netlist << "entity "<< entity << " is " << '\n';
         
-        netlist << "port (" << endl;
+        netlist << "port (" << '\n';
 
-        netlist << "\t" << "clk : in std_logic; " << endl;
-        netlist << "\t" << "rst : in std_logic; " << endl;
-        netlist << "\t" << "dataInArray : in data_array ( "<< components_in_netlist -1   << " downto 0)(DATA_SIZE_IN-1 downto 0); " << endl;
-        netlist << "\t" << "dataOutArray : out data_array (0 downto 0)(DATA_SIZE_OUT-1 downto 0); " << endl;
-        netlist << "\t" << "pValidArray : in std_logic_vector ( "<< components_in_netlist -1  << " downto 0); " << endl;
-        netlist << "\t" << "nReadyArray : in std_logic_vector ( "<< components_in_netlist -1  << " downto 0); " << endl;
-        netlist << "\t" << "validArray : out std_logic_vector ( 0 downto 0); " << endl;
-        netlist << "\t" << "readyArray : out std_logic_vector ( "<< components_in_netlist -1 << " downto 0)); " << endl;
+        netlist << "\t" << "clk : in std_logic; " << '\n';
+        netlist << "\t" << "rst : in std_logic; " << '\n';
+        netlist << "\t" << "dataInArray : in data_array ( "<< components_in_netlist -1   << " downto 0)(DATA_SIZE_IN-1 downto 0); " << '\n';
+        netlist << "\t" << "dataOutArray : out data_array (0 downto 0)(DATA_SIZE_OUT-1 downto 0); " << '\n';
+        netlist << "\t" << "pValidArray : in std_logic_vector ( "<< components_in_netlist -1  << " downto 0); " << '\n';
+        netlist << "\t" << "nReadyArray : in std_logic_vector ( "<< components_in_netlist -1  << " downto 0); " << '\n';
+        netlist << "\t" << "validArray : out std_logic_vector ( 0 downto 0); " << '\n';
+        netlist << "\t" << "readyArray : out std_logic_vector ( "<< components_in_netlist -1 << " downto 0)); " << '\n';
 
 //         clk, rst : in std_logic; 
 //         dataInArray : in data_array (1 downto 0)(DATA_SIZE_IN-1 downto 0); 
@@ -5216,30 +5288,37 @@ void write_entity ( string  filename, int indx, int max_number_of_nested_taggers
 
 
         
-        netlist << ");" << endl;
-        netlist << "end;" << endl << endl;
+        netlist << ");" << '\n';
+        netlist << "end;" << '\n' << '\n';
 
     }
 }
 
 
-void write_intro (  )
+// Not in the hash of the manifest: the file is not rewritten if only the date changes
+string get_header (  )
 {
     
     time_t now = time(0);
     char* dt = ctime(&now);
 
-    netlist << "-- ==============================================================" << endl;
-    netlist << "-- Generated by Dot2Vhdl ver. " << VERSION_STRING << endl;
-    netlist << "-- File created: " << dt << endl;
-    netlist << "-- ==============================================================" << endl;
+    netlist.str( "" );
+    netlist << "-- ==============================================================" << '\n';
+    netlist << "-- Generated by Dot2Vhdl ver. " << VERSION_STRING << '\n';
+    netlist << "-- File created: " << dt << '\n';
+    netlist << "-- ==============================================================" << '\n';
 
-    netlist << "library IEEE; " << endl;
-    netlist << "use IEEE.std_logic_1164.all; " << endl;
-    netlist << "use IEEE.numeric_std.all; " << endl;
-    netlist << "use work.customTypes.all; " << endl;
+    return netlist.str();
+}
 
-    netlist << "-- ==============================================================" << endl;
+void write_intro (  )
+{
+    netlist << "library IEEE; " << '\n';
+    netlist << "use IEEE.std_logic_1164.all; " << '\n';
+    netlist << "use IEEE.numeric_std.all; " << '\n';
+    netlist << "use work.customTypes.all; " << '\n';
+
+    netlist << "-- ==============================================================" << '\n';
 
 }
 
@@ -5248,7 +5327,7 @@ void write_lsq_signal(std::string name, bool isInput, std::string type, bool isF
     if (isInput) {netlist << "in ";} else {netlist << "out ";}
     netlist << type;
     if (!isFinalSignal) {netlist << ";";}
-    netlist << endl;
+    netlist << '\n';
 }
 
 void write_lsq_declaration ( )
@@ -5256,9 +5335,9 @@ void write_lsq_declaration ( )
     for (int i = 0; i < components_in_netlist; i++) 
     {
         if (nodes[i].type == "LSQ") {
-            netlist << endl;
-            netlist << "component " << nodes[i].name << endl;
-            netlist << "port(" << endl;
+            netlist << '\n';
+            netlist << "component " << nodes[i].name << '\n';
+            netlist << "port(" << '\n';
             write_lsq_signal("clock", true, "std_logic", false);
             write_lsq_signal("reset", true, "std_logic", false);
             write_lsq_signal("io_memIsReadyForLoads", true, "std_logic", false);
@@ -5356,13 +5435,44 @@ void write_lsq_declaration ( )
             //write_lsq_signal("io_loadAddrOut", false, "std_logic_vector("+ to_string(get_lsq_addresswidth()-1) +"  downto 0)", false);
             write_lsq_signal("io_loadAddrOut", false, "std_logic_vector("+ to_string(nodes[i].address_size-1) +"  downto 0)", false);
             write_lsq_signal("io_loadEnable", false, "std_logic", true);
-            netlist << ");" << endl;
-            netlist << "end component;" << endl;
+            netlist << ");" << '\n';
+            netlist << "end component;" << '\n';
         }
       
     }
 }
 
+// Writes the sections on up to jobs threads (the largest ones, at the end, first): each
+// one is written into the netlist buffer of its thread. Returns their texts, in order.
+vector<string> write_sections ( const vector<function<void ()>> &sections )
+{
+    vector<string> texts ( sections.size() );
+    atomic<int> next ( 0 );
+    
+    auto worker = [&] {
+        for ( int indx = next++; indx < ( int ) sections.size(); indx = next++ )
+        {
+            int section = sections.size() - 1 - indx;
+            netlist.str( "" );
+            sections[section] ( );
+            texts[section] = netlist.str();
+        }
+    };
+
+    vector<thread> threads;
+    for ( int indx = 1; indx < min( jobs, (int) sections.size() ); indx++ )
+    {
+        threads.emplace_back( worker );
+    }
+    worker ( );
+    for ( thread &t : threads )
+    {
+        t.join();
+    }
+
+    return texts;
+}
+
 void vhdl_writer::write_vhdl ( string filename, int indx )
 {
     
@@ -5386,33 +5496,59 @@ void vhdl_writer::write_vhdl ( string filename, int indx )
     components_type[COMPONENT_CONSTANT].out_ports_type_str = out_ports_type_generic;
 
     
-    netlist.open (output_filename);
-
     // AYA: 26/12/2023
     int max_number_of_nested_taggers = get_max_number_of_nested_taggers();
     
-    write_intro ( );
-    
-    write_entity ( filename, indx, max_number_of_nested_taggers );
-    
-    netlist << "architecture behavioral of " << entity << " is " << endl;
-
     bool tagged_loop_mux_flag = false; 
     bool tagger_is_tagging = true;  
 
-    write_signals ( tagged_loop_mux_flag, tagger_is_tagging, max_number_of_nested_taggers );
-    
-    write_lsq_declaration ( );
-
-    netlist  << endl << "begin" << endl;
+    vector<function<void ()>> sections = {
+        [&] {
+            write_intro ( );
+            write_entity ( filename, indx, max_number_of_nested_taggers );
+            netlist << "architecture behavioral of " << entity << " is " << '\n';
+        },
+        [&] {
+            write_signals ( tagged_loop_mux_flag, tagger_is_tagging, max_number_of_nested_taggers );
+            if ( indx == 0 )
+            {
+                write_perf_counters_signals ( );
+            }
+        },
+        [&] {
+            write_lsq_declaration ( );
+            netlist  << '\n' << "begin" << '\n';
+        },
+        [&] {
+            write_connections ( indx, tagged_loop_mux_flag, tagger_is_tagging );
+            if ( indx == 0 )
+            {
+                write_perf_counters ( );
+            }
+        },
+        [&] {
+            write_components ( tagged_loop_mux_flag, tagger_is_tagging, max_number_of_nested_taggers);
+            netlist  << '\n' << "end behavioral; "<< '\n';
+        }
+    };
+    vector<string> texts = write_sections ( sections );
 
-    write_connections ( indx, tagged_loop_mux_flag, tagger_is_tagging );
-    
-    write_components ( tagged_loop_mux_flag, tagger_is_tagging, max_number_of_nested_taggers);
+    texts.insert ( texts.begin(), get_header ( ) );
+    manifest_write_file ( output_filename, texts, 1 );
 
-    netlist  << endl << "end behavioral; "<< endl;
+    if ( indx == 0 )
+    {
+        write_perf_counters_map ( filename );
+    }
 
-    netlist.close();
+    // The widths used by get_generic for the components
+    for ( int i = 0; i < components_in_netlist; i++ )
+    {
+        if ( nodes[i].type != "LSQ" )
+        {
+            set_default_port_sizes ( nodes[i] );
+        }
+    }
 }
 
 